@@ -0,0 +1,547 @@
+#pragma once
+#ifndef CONCURRENT_DYNAMIC_ARRAY_HEADER
+#define CONCURRENT_DYNAMIC_ARRAY_HEADER
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace concurrent_array_detail {
+
+// The index of the highest set bit, the value must not be 0.
+inline size_t highestBit(size_t value) {
+#if defined(__GNUC__)
+	return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+	size_t result = 0;
+	while (value >>= 1) {
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+// The pointer, which marks a block being allocated. It is never dereferenced.
+template <typename P>
+P* allocatingMark() {
+	static typename std::aligned_storage<sizeof(P), alignof(P)>::type mark;
+	return reinterpret_cast<P*>(&mark);
+}
+
+template <typename P>
+bool isAllocated(const P *block) {
+	return block && block != allocatingMark<P>();
+}
+
+// The first thread, which finds the slot empty, marks it and stores the result of allocate()
+// in it. The others wait for it, so the block is allocated once. If allocate() throws,
+// the slot is emptied again for the next thread.
+template <typename P, typename Allocate>
+void allocateOnce(std::atomic<P*> &slot, Allocate allocate) {
+	P *const allocating = allocatingMark<P>();
+
+	P *current = slot.load(std::memory_order_acquire);
+	while (!current || current == allocating) {
+		if (current) {
+			std::this_thread::yield();
+			current = slot.load(std::memory_order_acquire);
+		}
+		else if (slot.compare_exchange_weak(current, allocating, std::memory_order_acquire)) {
+			P *block = nullptr;
+			try {
+				block = allocate();
+			}
+			catch (...) {
+				slot.store(nullptr, std::memory_order_release);
+				throw;
+			}
+
+			slot.store(block, std::memory_order_release);
+			return;
+		}
+	}
+}
+
+} // namespace concurrent_array_detail
+
+// A grow-only array, which many threads can append to at the same time. An append claims
+// its positions with one fetch_add on the size and constructs the elements without a lock.
+// The elements are in segments, which double in size and are never moved or freed before
+// clear(), so the references and the iterators stay valid while the array grows.
+// A segment is allocated by the first thread, which needs it, while the others wait for it.
+// Different segments might be allocated at the same time, so the allocator must be usable
+// from several threads.
+//
+// An element can be read by any thread once ready() returns true for it, or once the
+// thread which appended it has published it in another way. size() counts the claimed
+// positions, including the ones, which are still being constructed.
+// clear() and the destructor must not run concurrently with anything else.
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentDynamicArray {
+	using allocator_traits = std::allocator_traits<Allocator>;
+	using flag_allocator = typename allocator_traits::template rebind_alloc<std::atomic<bool>>;
+	using flag_traits = std::allocator_traits<flag_allocator>;
+
+	static_assert(std::is_same<typename allocator_traits::value_type, T>::value, "The allocator must allocate T.");
+
+	// Segment k holds FirstSize << k elements, starting at (FirstSize << k) - FirstSize.
+	static const size_t FirstBits = 5;
+	static const size_t FirstSize = size_t(1) << FirstBits;
+	static const size_t MaxSegments = sizeof(size_t) * 8 - FirstBits;
+
+public:
+	using value_type = T;
+	using allocator_type = Allocator;
+	using size_type = size_t;
+	using reference = T&;
+	using const_reference = const T&;
+
+	template <typename ArrayType, typename ValueType>
+	class basic_iterator;
+
+	using iterator = basic_iterator<ConcurrentDynamicArray, T>;
+	using const_iterator = basic_iterator<const ConcurrentDynamicArray, const T>;
+
+public:
+	explicit ConcurrentDynamicArray(const allocator_type &alloc = allocator_type());
+	~ConcurrentDynamicArray();
+
+	ConcurrentDynamicArray(const ConcurrentDynamicArray&) = delete;
+	ConcurrentDynamicArray& operator=(const ConcurrentDynamicArray&) = delete;
+
+public:
+	// The iterators cover the positions claimed before the call of end().
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+	bool empty() const;
+	size_type size() const;
+
+	// The number of elements, which fit into the segments allocated from the start.
+	size_type capacity() const;
+
+	// Allocates the segments for count elements in advance. Thread-safe.
+	void reserve(size_type count);
+
+	// Whether the element at pos is constructed. It synchronizes with the construction.
+	bool ready(size_type pos) const;
+
+	reference operator[](size_type pos);
+	const_reference operator[](size_type pos) const;
+
+	// Throws std::out_of_range if the element is not ready.
+	reference at(size_type pos);
+	const_reference at(size_type pos) const;
+
+	// The appends are thread-safe and return the position of the new element. If the
+	// constructor throws, the position stays claimed, but never becomes ready.
+	iterator push_back(const T &value);
+	iterator push_back(T &&value);
+
+	template <typename... Args>
+	iterator emplace_back(Args&&... args);
+
+	// Appends count value-initialized elements or copies of value at adjacent positions.
+	std::pair<iterator, iterator> grow_by(size_type count);
+	std::pair<iterator, iterator> grow_by(size_type count, const T &value);
+
+	// Destroys the elements and keeps the segments. Not thread-safe.
+	void clear();
+
+	allocator_type get_allocator() const;
+
+private:
+	static size_t segmentOf(size_t pos);
+	static size_t segmentBase(size_t segment);
+	static size_t segmentSize(size_t segment);
+
+	T* element(size_t pos) const;
+	std::atomic<bool>& flag(size_t pos) const;
+
+	// Allocates the segments of the positions [first, last), if nobody has done it yet.
+	void allocateRange(size_t first, size_t last);
+	void allocateSegment(size_t segment);
+
+	template <typename... Args>
+	void constructAt(size_t pos, Args&&... args);
+
+	void destroyAll();
+
+private:
+	// Each append writes the size, so it has a cache line of its own.
+	alignas(64) std::atomic<size_t> m_size;
+
+	alignas(64) std::atomic<T*> m_segments[MaxSegments];
+	std::atomic<std::atomic<bool>*> m_flags[MaxSegments];
+	allocator_type m_allocator;
+};
+
+/* --- ITERATOR --- */
+
+template <typename T, typename Allocator>
+template <typename ArrayType, typename ValueType>
+class ConcurrentDynamicArray<T, Allocator>::basic_iterator {
+	friend class ConcurrentDynamicArray<T, Allocator>;
+
+	template <typename OtherArray, typename OtherValue>
+	friend class basic_iterator;
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = typename std::remove_const<ValueType>::type;
+	using difference_type = ptrdiff_t;
+	using pointer = ValueType*;
+	using reference = ValueType&;
+
+public:
+	basic_iterator()
+		: m_array(nullptr)
+		, m_pos(0) {
+
+	}
+
+	// The iterator converts to the const_iterator.
+	template <typename OtherArray, typename OtherValue, typename = typename std::enable_if<std::is_convertible<OtherValue*, ValueType*>::value>::type>
+	basic_iterator(const basic_iterator<OtherArray, OtherValue> &r)
+		: m_array(r.m_array)
+		, m_pos(r.m_pos) {
+
+	}
+
+	reference operator*() const { return (*m_array)[m_pos]; }
+	pointer operator->() const { return &(*m_array)[m_pos]; }
+	reference operator[](difference_type n) const { return (*m_array)[m_pos + static_cast<size_t>(n)]; }
+
+	basic_iterator& operator++() { ++m_pos; return *this; }
+	basic_iterator operator++(int) { basic_iterator result(*this); ++m_pos; return result; }
+	basic_iterator& operator--() { --m_pos; return *this; }
+	basic_iterator operator--(int) { basic_iterator result(*this); --m_pos; return result; }
+
+	basic_iterator& operator+=(difference_type n) { m_pos += static_cast<size_t>(n); return *this; }
+	basic_iterator& operator-=(difference_type n) { m_pos -= static_cast<size_t>(n); return *this; }
+
+	basic_iterator operator+(difference_type n) const { basic_iterator result(*this); return result += n; }
+	basic_iterator operator-(difference_type n) const { basic_iterator result(*this); return result -= n; }
+	friend basic_iterator operator+(difference_type n, const basic_iterator &it) { return it + n; }
+
+	template <typename OtherArray, typename OtherValue>
+	difference_type operator-(const basic_iterator<OtherArray, OtherValue> &r) const { return static_cast<difference_type>(m_pos - r.m_pos); }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator==(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos == r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator!=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos != r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator<(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos < r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator>(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos > r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator<=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos <= r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator>=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos >= r.m_pos; }
+
+private:
+	basic_iterator(ArrayType *array, size_t pos)
+		: m_array(array)
+		, m_pos(pos) {
+
+	}
+
+private:
+	ArrayType *m_array;
+	size_t m_pos;
+};
+
+/* --- CONCURRENT DYNAMIC ARRAY --- */
+
+template <typename T, typename Allocator>
+inline ConcurrentDynamicArray<T, Allocator>::ConcurrentDynamicArray(const allocator_type &alloc)
+	: m_size(0)
+	, m_allocator(alloc) {
+	for (size_t i = 0; i < MaxSegments; ++i) {
+		m_segments[i].store(nullptr, std::memory_order_relaxed);
+		m_flags[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+template <typename T, typename Allocator>
+inline ConcurrentDynamicArray<T, Allocator>::~ConcurrentDynamicArray() {
+	destroyAll();
+
+	flag_allocator flagAllocator(m_allocator);
+	for (size_t i = 0; i < MaxSegments; ++i) {
+		if (T *segment = m_segments[i].load(std::memory_order_relaxed)) {
+			allocator_traits::deallocate(m_allocator, segment, segmentSize(i));
+		}
+
+		if (std::atomic<bool> *flags = m_flags[i].load(std::memory_order_relaxed)) {
+			flag_traits::deallocate(flagAllocator, flags, segmentSize(i));
+		}
+	}
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::iterator ConcurrentDynamicArray<T, Allocator>::begin() {
+	return iterator(this, 0);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::iterator ConcurrentDynamicArray<T, Allocator>::end() {
+	return iterator(this, size());
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_iterator ConcurrentDynamicArray<T, Allocator>::begin() const {
+	return const_iterator(this, 0);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_iterator ConcurrentDynamicArray<T, Allocator>::end() const {
+	return const_iterator(this, size());
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_iterator ConcurrentDynamicArray<T, Allocator>::cbegin() const {
+	return begin();
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_iterator ConcurrentDynamicArray<T, Allocator>::cend() const {
+	return end();
+}
+
+template <typename T, typename Allocator>
+inline bool ConcurrentDynamicArray<T, Allocator>::empty() const {
+	return size() == 0;
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::size_type ConcurrentDynamicArray<T, Allocator>::size() const {
+	return m_size.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::size_type ConcurrentDynamicArray<T, Allocator>::capacity() const {
+	size_t segment = 0;
+	while (segment < MaxSegments && concurrent_array_detail::isAllocated(m_segments[segment].load(std::memory_order_acquire))
+		&& concurrent_array_detail::isAllocated(m_flags[segment].load(std::memory_order_acquire))) {
+		++segment;
+	}
+
+	return segmentBase(segment);
+}
+
+template <typename T, typename Allocator>
+inline void ConcurrentDynamicArray<T, Allocator>::reserve(size_type count) {
+	if (count) {
+		allocateRange(0, count);
+	}
+}
+
+template <typename T, typename Allocator>
+inline bool ConcurrentDynamicArray<T, Allocator>::ready(size_type pos) const {
+	if (pos >= size()) {
+		return false;
+	}
+
+	const size_t segment = segmentOf(pos);
+	const std::atomic<bool> *flags = m_flags[segment].load(std::memory_order_acquire);
+
+	return concurrent_array_detail::isAllocated(flags) && flags[pos - segmentBase(segment)].load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::reference ConcurrentDynamicArray<T, Allocator>::operator[](size_type pos) {
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_reference ConcurrentDynamicArray<T, Allocator>::operator[](size_type pos) const {
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::reference ConcurrentDynamicArray<T, Allocator>::at(size_type pos) {
+	if (!ready(pos)) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::const_reference ConcurrentDynamicArray<T, Allocator>::at(size_type pos) const {
+	if (!ready(pos)) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::iterator ConcurrentDynamicArray<T, Allocator>::push_back(const T &value) {
+	return emplace_back(value);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::iterator ConcurrentDynamicArray<T, Allocator>::push_back(T &&value) {
+	return emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+inline typename ConcurrentDynamicArray<T, Allocator>::iterator ConcurrentDynamicArray<T, Allocator>::emplace_back(Args&&... args) {
+	const size_t pos = m_size.fetch_add(1, std::memory_order_acq_rel);
+
+	allocateRange(pos, pos + 1);
+	constructAt(pos, std::forward<Args>(args)...);
+
+	return iterator(this, pos);
+}
+
+template <typename T, typename Allocator>
+inline std::pair<typename ConcurrentDynamicArray<T, Allocator>::iterator, typename ConcurrentDynamicArray<T, Allocator>::iterator> ConcurrentDynamicArray<T, Allocator>::grow_by(size_type count) {
+	const size_t first = m_size.fetch_add(count, std::memory_order_acq_rel);
+
+	if (count) {
+		allocateRange(first, first + count);
+	}
+	for (size_t pos = first; pos < first + count; ++pos) {
+		constructAt(pos);
+	}
+
+	return std::make_pair(iterator(this, first), iterator(this, first + count));
+}
+
+template <typename T, typename Allocator>
+inline std::pair<typename ConcurrentDynamicArray<T, Allocator>::iterator, typename ConcurrentDynamicArray<T, Allocator>::iterator> ConcurrentDynamicArray<T, Allocator>::grow_by(size_type count, const T &value) {
+	const size_t first = m_size.fetch_add(count, std::memory_order_acq_rel);
+
+	if (count) {
+		allocateRange(first, first + count);
+	}
+	for (size_t pos = first; pos < first + count; ++pos) {
+		constructAt(pos, value);
+	}
+
+	return std::make_pair(iterator(this, first), iterator(this, first + count));
+}
+
+template <typename T, typename Allocator>
+inline void ConcurrentDynamicArray<T, Allocator>::clear() {
+	destroyAll();
+	m_size.store(0, std::memory_order_release);
+}
+
+template <typename T, typename Allocator>
+inline typename ConcurrentDynamicArray<T, Allocator>::allocator_type ConcurrentDynamicArray<T, Allocator>::get_allocator() const {
+	return m_allocator;
+}
+
+template <typename T, typename Allocator>
+inline size_t ConcurrentDynamicArray<T, Allocator>::segmentOf(size_t pos) {
+	return concurrent_array_detail::highestBit(pos + FirstSize) - FirstBits;
+}
+
+template <typename T, typename Allocator>
+inline size_t ConcurrentDynamicArray<T, Allocator>::segmentBase(size_t segment) {
+	return (FirstSize << segment) - FirstSize;
+}
+
+template <typename T, typename Allocator>
+inline size_t ConcurrentDynamicArray<T, Allocator>::segmentSize(size_t segment) {
+	return FirstSize << segment;
+}
+
+template <typename T, typename Allocator>
+inline T* ConcurrentDynamicArray<T, Allocator>::element(size_t pos) const {
+	const size_t segment = segmentOf(pos);
+	return m_segments[segment].load(std::memory_order_acquire) + (pos - segmentBase(segment));
+}
+
+template <typename T, typename Allocator>
+inline std::atomic<bool>& ConcurrentDynamicArray<T, Allocator>::flag(size_t pos) const {
+	const size_t segment = segmentOf(pos);
+	return m_flags[segment].load(std::memory_order_acquire)[pos - segmentBase(segment)];
+}
+
+template <typename T, typename Allocator>
+inline void ConcurrentDynamicArray<T, Allocator>::allocateRange(size_t first, size_t last) {
+	if (last < first) {
+		throw std::length_error("Too many elements!");
+	}
+
+	for (size_t segment = segmentOf(first); segment <= segmentOf(last - 1); ++segment) {
+		allocateSegment(segment);
+	}
+}
+
+template <typename T, typename Allocator>
+inline void ConcurrentDynamicArray<T, Allocator>::allocateSegment(size_t segment) {
+	const size_t count = segmentSize(segment);
+
+	concurrent_array_detail::allocateOnce(m_flags[segment], [this, count] {
+		flag_allocator flagAllocator(m_allocator);
+		std::atomic<bool> *flags = flag_traits::allocate(flagAllocator, count);
+		for (size_t i = 0; i < count; ++i) {
+			new (flags + i) std::atomic<bool>(false);
+		}
+
+		return flags;
+	});
+
+	concurrent_array_detail::allocateOnce(m_segments[segment], [this, count] {
+		Allocator allocator(m_allocator);
+		return allocator_traits::allocate(allocator, count);
+	});
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+inline void ConcurrentDynamicArray<T, Allocator>::constructAt(size_t pos, Args&&... args) {
+	allocator_traits::construct(m_allocator, element(pos), std::forward<Args>(args)...);
+	flag(pos).store(true, std::memory_order_release);
+}
+
+template <typename T, typename Allocator>
+inline void ConcurrentDynamicArray<T, Allocator>::destroyAll() {
+	const size_t count = m_size.load(std::memory_order_acquire);
+
+	// A failed allocation can leave claimed positions without a segment.
+	for (size_t segment = 0; segment < MaxSegments && segmentBase(segment) < count; ++segment) {
+		T *values = m_segments[segment].load(std::memory_order_relaxed);
+		std::atomic<bool> *flags = m_flags[segment].load(std::memory_order_relaxed);
+		if (!values || !flags) {
+			continue;
+		}
+
+		const size_t last = std::min(segmentSize(segment), count - segmentBase(segment));
+		for (size_t i = 0; i < last; ++i) {
+			if (flags[i].load(std::memory_order_relaxed)) {
+				allocator_traits::destroy(m_allocator, values + i);
+				flags[i].store(false, std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+#endif // !CONCURRENT_DYNAMIC_ARRAY_HEADER
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../DynamicArray/DynamicArray.h"
+#include "ConcurrentDynamicArray.h"
+
+// Millions of appends per second from 1 to 8 threads, each appending 4M / threads numbers:
+// DynamicArray behind a mutex, ConcurrentDynamicArray::push_back, and grow_by with
+// batches of 64 numbers, which a thread fills without touching the shared size.
+
+const size_t Total = 1 << 22;
+const size_t Batch = 64;
+
+template <typename F>
+double appendsPerSecond(int threads, F f) {
+	std::vector<std::thread> workers;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back(f, Total / static_cast<size_t>(threads));
+	}
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	return static_cast<double>(Total) / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+int main() {
+	for (int threads : { 1, 2, 4, 8 }) {
+		std::cout << threads << " threads, millions of appends per second:\n";
+
+		{
+			DynamicArray<uint64_t> array;
+			std::mutex mutex;
+
+			std::cout << "  mutex + DynamicArray: " << appendsPerSecond(threads, [&](size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					std::lock_guard<std::mutex> lock(mutex);
+					array.push_back(i);
+				}
+			}) << '\n';
+		}
+
+		{
+			ConcurrentDynamicArray<uint64_t> array;
+
+			std::cout << "  ConcurrentDynamicArray::push_back: " << appendsPerSecond(threads, [&](size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					array.push_back(i);
+				}
+			}) << '\n';
+		}
+
+		{
+			ConcurrentDynamicArray<uint64_t> array;
+
+			std::cout << "  ConcurrentDynamicArray::grow_by: " << appendsPerSecond(threads, [&](size_t count) {
+				for (size_t i = 0; i < count; i += Batch) {
+					auto range = array.grow_by(Batch);
+					uint64_t value = i;
+					for (auto it = range.first; it != range.second; ++it) {
+						*it = value++;
+					}
+				}
+			}) << '\n';
+		}
+	}
+
+	return 0;
+}
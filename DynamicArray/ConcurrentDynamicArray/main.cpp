@@ -0,0 +1,247 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ConcurrentDynamicArray.h"
+
+const int Threads = 8;
+const int PerThread = 20000;
+
+// Every thread appends its own numbers, some one by one and some in ranges.
+void testConcurrentAppends() {
+	ConcurrentDynamicArray<int> array;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < Threads; ++t) {
+		threads.emplace_back([&array, t] {
+			int value = t * PerThread;
+			while (value < (t + 1) * PerThread) {
+				if (value % 7 == 0 && value + 5 <= (t + 1) * PerThread) {
+					auto range = array.grow_by(5);
+					assert(range.second - range.first == 5);
+					for (auto it = range.first; it != range.second; ++it) {
+						*it = value++;
+					}
+				}
+				else {
+					assert(*array.push_back(value) == value);
+					++value;
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	assert(array.size() == size_t(Threads * PerThread));
+
+	std::vector<int> values(array.begin(), array.end());
+	std::sort(values.begin(), values.end());
+	for (int i = 0; i < Threads * PerThread; ++i) {
+		assert(values[static_cast<size_t>(i)] == i);
+	}
+}
+
+// A reader scans the ready elements while the writers append.
+void testConcurrentReads() {
+	ConcurrentDynamicArray<std::string> array;
+
+	std::thread reader([&array] {
+		size_t seen = 0;
+		while (seen < size_t(Threads * 1000)) {
+			seen = 0;
+			for (size_t i = 0; i < array.size(); ++i) {
+				if (array.ready(i)) {
+					assert(array.at(i).size() == 10);
+					++seen;
+				}
+			}
+		}
+	});
+
+	std::vector<std::thread> writers;
+	for (int t = 0; t < Threads; ++t) {
+		writers.emplace_back([&array, t] {
+			for (int i = 0; i < 1000; ++i) {
+				array.emplace_back(10, static_cast<char>('a' + t));
+			}
+		});
+	}
+	for (std::thread &writer : writers) {
+		writer.join();
+	}
+	reader.join();
+}
+
+void testStableReferences() {
+	ConcurrentDynamicArray<int> array;
+	assert(array.empty() && array.capacity() == 0 && !array.ready(0));
+
+	array.push_back(42);
+	const int *first = &array[0];
+	auto it = array.begin();
+
+	array.grow_by(100000, 7);
+	assert(first == &array[0] && *it == 42 && array[100000] == 7 && array.size() == 100001);
+	assert(array.capacity() >= array.size());
+
+	array.reserve(1000000);
+	assert(array.capacity() >= 1000000 && first == &array[0]);
+
+	bool thrown = false;
+	try {
+		array.at(100001);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	const ConcurrentDynamicArray<int> &constant = array;
+	ConcurrentDynamicArray<int>::const_iterator cit = array.begin();
+	assert(cit == constant.begin() && constant.end() - cit == 100001 && cit[1] == 7);
+
+	array.clear();
+	assert(array.empty() && array.capacity() >= 1000000);
+	array.push_back(1);
+	assert(&array[0] == first && array.at(0) == 1);
+}
+
+struct Throwing {
+	explicit Throwing(int value)
+		: m_value(new int(value)) {
+		if (value < 0) {
+			delete m_value;
+			throw std::runtime_error("Negative!");
+		}
+	}
+
+	Throwing(const Throwing &r)
+		: m_value(new int(*r.m_value)) {
+
+	}
+
+	~Throwing() {
+		delete m_value;
+	}
+
+	int *m_value;
+};
+
+// A failed construction leaves a claimed position, which never becomes ready.
+void testThrowingConstructor() {
+	ConcurrentDynamicArray<Throwing> array;
+	array.emplace_back(1);
+
+	bool thrown = false;
+	try {
+		array.emplace_back(-1);
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+
+	array.emplace_back(2);
+	assert(thrown && array.size() == 3 && array.ready(0) && !array.ready(1) && array.ready(2));
+	assert(*array.at(2).m_value == 2);
+}
+
+std::atomic<int> allocations(0);
+std::atomic<int> deallocations(0);
+std::atomic<int> failures(0);
+
+// Counts the blocks, and throws std::bad_alloc while failures is positive.
+template <typename T>
+struct CountingAllocator {
+	using value_type = T;
+
+	CountingAllocator() = default;
+
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t count) {
+		if (failures.fetch_sub(1) > 0) {
+			throw std::bad_alloc();
+		}
+
+		++allocations;
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T *ptr, size_t count) {
+		++deallocations;
+		std::allocator<T>().deallocate(ptr, count);
+	}
+
+	bool operator==(const CountingAllocator&) const { return true; }
+	bool operator!=(const CountingAllocator&) const { return false; }
+};
+
+// The threads, which need the same segment, wait for one of them to allocate it,
+// instead of allocating their own blocks and freeing them.
+void testSegmentAllocation() {
+	{
+		ConcurrentDynamicArray<int, CountingAllocator<int>> array;
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < Threads; ++t) {
+			threads.emplace_back([&array] {
+				for (int i = 0; i < PerThread; ++i) {
+					array.push_back(i);
+				}
+			});
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+
+		// A values block and a flags block per segment, and nothing freed.
+		size_t segments = 0;
+		while ((size_t(32) << segments) - 32 < array.size()) {
+			++segments;
+		}
+		assert(allocations == static_cast<int>(2 * segments) && deallocations == 0);
+	}
+	assert(deallocations == allocations);
+
+	// A failed allocation leaves the segment to the next append.
+	ConcurrentDynamicArray<int, CountingAllocator<int>> array;
+	failures = 1;
+
+	bool thrown = false;
+	try {
+		array.push_back(1);
+	}
+	catch (const std::bad_alloc&) {
+		thrown = true;
+	}
+
+	array.push_back(2);
+	assert(thrown && array.size() == 2 && !array.ready(0) && array.at(1) == 2);
+}
+
+int main() {
+	ConcurrentDynamicArray<int> array;
+	for (int i = 0; i < 5; ++i) {
+		array.push_back(i);
+	}
+	for (int value : array) {
+		std::cout << value << ' ';
+	}
+	std::cout << '\n';
+
+	testConcurrentAppends();
+	testConcurrentReads();
+	testStableReferences();
+	testThrowingConstructor();
+	testSegmentAllocation();
+
+	return 0;
+}
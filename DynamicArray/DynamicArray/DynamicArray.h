@@ -2,12 +2,265 @@
 #ifndef DYNAMIC_ARRAY_CLASS_HEADER
 #define DYNAMIC_ARRAY_CLASS_HEADER
 
+#include <new>
+#include <memory>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <stdexcept>
+#include <type_traits>
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#define DYNAMIC_ARRAY_HAS_CONCEPTS 1
+#else
+#define DYNAMIC_ARRAY_HAS_CONCEPTS 0
+#endif
+
+#if (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) && __has_include(<memory_resource>)
+#define DYNAMIC_ARRAY_HAS_PMR 1
+#include <memory_resource>
+#else
+#define DYNAMIC_ARRAY_HAS_PMR 0
+#endif
+
+#include "GrowthPolicy.h"
+
+// Types, whose objects can be moved to another address with memcpy(), leaving the
+// original storage without calling its destructor. Specialize it for such types
+// (for example, types which own a heap pointer) to get the bulk memcpy()/memmove() paths.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+// Allocators, which can resize a block in place with reallocate(ptr, oldCount, newCount),
+// like ReallocAllocator. DynamicArray uses it for trivially relocatable types.
+template <typename Allocator, typename = void>
+struct has_reallocate : std::false_type {};
+
+template <typename Allocator>
+struct has_reallocate<Allocator, decltype(void(std::declval<Allocator&>().reallocate(
+	std::declval<typename Allocator::value_type*>(), size_t(), size_t())))> : std::true_type {};
+
+// Allocators, which report with usable_size(ptr, count) how many elements a block of count
+// elements can really hold. Their deallocate() and reallocate() must accept any count between
+// the two, so DynamicArray can use the whole block with SizeClassGrowth.
+template <typename Allocator, typename = void>
+struct has_usable_size : std::false_type {};
 
+template <typename Allocator>
+struct has_usable_size<Allocator, decltype(void(std::declval<const Allocator&>().usable_size(
+	std::declval<typename Allocator::value_type*>(), size_t())))> : std::true_type {};
+
+// The element operations of DynamicArray on raw storage, shared with the other contiguous arrays.
+// The elements are constructed and destroyed through the allocator.
+namespace dynamic_array_detail {
+
+// Yields the same value over and over, for insert(pos, count, value).
 template <typename T>
+struct RepeatIterator {
+	const T *value;
+
+	explicit RepeatIterator(const T &value) : value(&value) {}
+	const T& operator*() const { return *value; }
+	RepeatIterator& operator++() { return *this; }
+};
+
+template <typename Allocator, typename T>
+inline void destroy(Allocator &allocator, T *first, T *last) {
+	for (; first != last; ++first) {
+		std::allocator_traits<Allocator>::destroy(allocator, first);
+	}
+}
+
+// Moves the elements to the uninitialized dest and destroys the originals.
+// Uses memcpy() for trivially relocatable types. Otherwise moves the elements if
+// their move constructor cannot throw and copies them if it can. If it throws,
+// the source is intact and the destination is left empty.
+template <typename Allocator, typename T>
+inline void relocate(Allocator &allocator, T *first, T *last, T *dest) {
+	if (is_trivially_relocatable<T>::value) {
+		if (first != last) {
+			std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+		}
+
+		return;
+	}
+
+	T *current = dest;
+
+	try {
+		for (T *it = first; it != last; ++it, ++current) {
+			std::allocator_traits<Allocator>::construct(allocator, current, std::move_if_noexcept(*it));
+		}
+	}
+	catch (...) {
+		destroy(allocator, dest, current);
+		throw;
+	}
+
+	destroy(allocator, first, last);
+}
+
+// Constructs count elements at the uninitialized dest. If it throws, nothing is left constructed.
+template <typename Allocator, typename T, typename ForwardIt>
+inline void constructRange(Allocator &allocator, T *dest, ForwardIt first, size_t count) {
+	size_t i = 0;
+
+	try {
+		for (; i < count; ++i, ++first) {
+			std::allocator_traits<Allocator>::construct(allocator, dest + i, *first);
+		}
+	}
+	catch (...) {
+		destroy(allocator, dest, dest + i);
+		throw;
+	}
+}
+
+// Opens a gap of count slots at index and fills it from first. The storage must have room
+// for them. size is updated as the elements are constructed, so it is right if it throws.
+template <typename Allocator, typename T, typename ForwardIt>
+inline void insertInPlace(Allocator &allocator, T *data, size_t &size, size_t index, ForwardIt first, size_t count) {
+	T *gap = data + index;
+	const size_t tail = size - index;
+
+	if (is_trivially_relocatable<T>::value) {
+		std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), tail * sizeof(T));
+
+		try {
+			constructRange(allocator, gap, first, count);
+		}
+		catch (...) {
+			std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), tail * sizeof(T));
+			throw;
+		}
+
+		size += count;
+		return;
+	}
+
+	T *oldEnd = data + size;
+
+	if (tail > count) {
+		// The last count elements move to the uninitialized space, the rest of the tail is shifted
+		// by assignment and the gap is assigned from the range.
+		constructRange(allocator, oldEnd, std::make_move_iterator(oldEnd - count), count);
+		size += count;
+
+		std::move_backward(gap, oldEnd - count, oldEnd);
+		for (size_t i = 0; i < count; ++i, ++first) {
+			gap[i] = *first;
+		}
+
+		return;
+	}
+
+	// The part of the range past the tail goes to the uninitialized space, followed by the
+	// tail itself. The beginning of the range is assigned over the old tail.
+	ForwardIt mid = first;
+	for (size_t i = 0; i < tail; ++i) {
+		++mid;
+	}
+
+	constructRange(allocator, oldEnd, mid, count - tail);
+	size += count - tail;
+
+	try {
+		constructRange(allocator, gap + count, std::make_move_iterator(gap), tail);
+	}
+	catch (...) {
+		destroy(allocator, oldEnd, data + size);
+		size -= count - tail;
+		throw;
+	}
+
+	size += tail;
+
+	for (size_t i = 0; i < tail; ++i, ++first) {
+		gap[i] = *first;
+	}
+}
+
+// Removes [from, to) and closes the gap.
+template <typename Allocator, typename T>
+inline void eraseRange(Allocator &allocator, T *data, size_t &size, size_t from, size_t to) {
+	const size_t count = to - from;
+
+	if (is_trivially_relocatable<T>::value) {
+		destroy(allocator, data + from, data + to);
+		std::memmove(static_cast<void*>(data + from), static_cast<const void*>(data + to), (size - to) * sizeof(T));
+	}
+	else {
+		std::move(data + to, data + size, data + from);
+		destroy(allocator, data + size - count, data + size);
+	}
+
+	size -= count;
+}
+
+// Removes the elements satisfying pred in one pass, keeping the order of the rest.
+// Returns their count. If pred throws, the array stays contiguous.
+template <typename Allocator, typename T, typename Predicate>
+inline size_t eraseIf(Allocator &allocator, T *data, size_t &size, Predicate &pred) {
+	size_t write = 0;
+	while (write < size && !pred(data[write])) {
+		++write;
+	}
+
+	size_t read = write;
+
+	if (is_trivially_relocatable<T>::value) {
+		// The slots in [write, read) are dead, the kept elements are relocated over them.
+		try {
+			for (; read < size; ++read) {
+				if (pred(data[read])) {
+					std::allocator_traits<Allocator>::destroy(allocator, data + read);
+				}
+				else {
+					std::memcpy(static_cast<void*>(data + write), static_cast<const void*>(data + read), sizeof(T));
+					++write;
+				}
+			}
+		}
+		catch (...) {
+			// Close the gap, so the array stays contiguous.
+			std::memmove(static_cast<void*>(data + write), static_cast<const void*>(data + read), (size - read) * sizeof(T));
+			size -= read - write;
+			throw;
+		}
+
+		const size_t erased = size - write;
+		size = write;
+
+		return erased;
+	}
+
+	for (; read < size; ++read) {
+		if (!pred(data[read])) {
+			data[write] = std::move(data[read]);
+			++write;
+		}
+	}
+
+	const size_t erased = size - write;
+	destroy(allocator, data + write, data + size);
+	size = write;
+
+	return erased;
+}
+
+} // namespace dynamic_array_detail
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class DynamicArray {
+	using allocator_traits = std::allocator_traits<Allocator>;
+
+	static_assert(std::is_same<typename allocator_traits::value_type, T>::value, "The allocator must allocate T.");
+	static_assert(std::is_same<typename allocator_traits::pointer, T*>::value, "The allocator must use raw pointers.");
+
 public:
 	using value_type = T;
+	using allocator_type = Allocator;
 	using size_type = size_t;
 	using reference = T&;
 	using const_reference = const T&;
@@ -28,12 +281,20 @@ public:
 	const_iterator cend() const;
 
 public:
-	DynamicArray(size_type capacity = 0);
+	explicit DynamicArray(const allocator_type &alloc);
+	DynamicArray(size_type capacity = 0, const allocator_type &alloc = allocator_type());
 	DynamicArray(const DynamicArray &r);
+	DynamicArray(const DynamicArray &r, const allocator_type &alloc);
+	DynamicArray(DynamicArray &&r) noexcept;
+	DynamicArray(DynamicArray &&r, const allocator_type &alloc);
 	DynamicArray& operator=(const DynamicArray &rhs);
+	DynamicArray& operator=(DynamicArray &&rhs) noexcept(
+		allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value);
 	~DynamicArray();
 
 public:
+	allocator_type get_allocator() const;
+
 	reference at(size_type pos);
 	const_reference at(size_type pos) const;
 
@@ -46,8 +307,15 @@ public:
 	reference operator[](size_type pos);
 	const_reference operator[](size_type pos) const;
 
+	pointer data();
+	const_pointer data() const;
+
 	void pop_back();
 	void push_back(const_reference value);
+	void push_back(value_type &&value);
+
+	template <typename... Args>
+	reference emplace_back(Args&&... args);
 
 	void reserve(size_type newCapacity);
 	void shrink_to_fit();
@@ -57,27 +325,117 @@ public:
 	size_type capacity() const;
 
 	iterator erase(iterator pos);
+	iterator erase(iterator first, iterator last);
+
+	// Removes the element by moving the last element into its place. O(1), the order is not kept.
+	iterator swap_erase(iterator pos);
+
+	// Removes all the elements satisfying pred in one pass and returns their count.
+	template <typename Predicate>
+	size_type erase_if(Predicate pred);
+
 	iterator insert(iterator pos, const_reference value);
+	iterator insert(iterator pos, value_type &&value);
+	iterator insert(iterator pos, size_type count, const_reference value);
+
+	// The range must not point into this array.
+	template <typename InputIt, typename std::enable_if<!std::is_integral<InputIt>::value, int>::type = 0>
+	iterator insert(iterator pos, InputIt first, InputIt last);
 
 	void clear();
 	void swap(DynamicArray &other);
 
 private:
+	template <typename... Args>
+	void reallocateEmplace(Args&&... args);
+
+	template <typename U>
+	iterator insertValue(iterator pos, U &&value);
+
+	template <typename InputIt>
+	iterator insertRange(iterator pos, InputIt first, InputIt last, std::input_iterator_tag);
+	template <typename ForwardIt>
+	iterator insertRange(iterator pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+	// Opens a gap of count slots at index and fills it from first, growing the storage at most once.
+	template <typename ForwardIt>
+	void insertCount(size_type index, ForwardIt first, size_type count);
+
+	// Constructs count elements at the uninitialized dest. If it throws, nothing is left constructed.
+	template <typename ForwardIt>
+	void constructRange(value_type *dest, ForwardIt first, size_type count);
+
+	size_type indexOf(const_iterator pos) const;
+
 	void reallocate(size_type newCapacity);
+	void reallocateInPlace(size_type newCapacity, std::true_type);
+	void reallocateInPlace(size_type newCapacity, std::false_type);
 	void resize(size_type newCapacity);
-	void copyFrom(const DynamicArray<T> &other);
+	void copyFrom(const DynamicArray<T, Allocator, GrowthPolicy> &other);
+	void moveFrom(DynamicArray<T, Allocator, GrowthPolicy> &other);
+	void swapStorage(DynamicArray<T, Allocator, GrowthPolicy> &other);
+
+	// The allocator propagation, selected by the allocator_traits tags.
+	void moveAssign(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type);
+	void moveAssign(DynamicArray<T, Allocator, GrowthPolicy> &other, std::false_type);
+	void copyAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type);
+	void copyAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::false_type);
+	void swapAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type);
+	void swapAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::false_type);
+
 	size_type calcSizeIncrease(size_type newCapacity) const;
 
+	// Shrinks the storage, if the growth policy asks for it. Never throws.
+	void autoShrink();
+
+	// The storage is uninitialized, the elements are constructed in place.
+	// Everything goes through std::allocator_traits. The growth policy might
+	// increase count to the usable size of the block, which the allocator reports.
+	value_type* allocate(size_type &count);
+	size_type usableCapacity(value_type *ptr, size_type count, std::true_type) const;
+	size_type usableCapacity(value_type *ptr, size_type count, std::false_type) const;
+	void deallocate(value_type *ptr, size_type count);
+
+	template <typename... Args>
+	void construct(value_type *ptr, Args&&... args);
+	void destroy(value_type *ptr);
+	void destroy(value_type *first, value_type *last);
+
+	// See dynamic_array_detail::relocate().
+	void relocate(value_type *first, value_type *last, value_type *dest);
+
+	static constexpr bool isTriviallyRelocatable = is_trivially_relocatable<T>::value;
+	static constexpr bool isTriviallyCopyable = std::is_trivially_copyable<T>::value;
+	static constexpr bool isNothrowRelocatable = isTriviallyRelocatable || std::is_nothrow_move_constructible<T>::value;
+	static constexpr bool canReallocateInPlace = isTriviallyRelocatable && has_reallocate<Allocator>::value;
+
 private:
-	value_type *data;
+	value_type *m_data;
 	size_type m_size;
 	size_type m_capacity;
+	allocator_type m_allocator;
 };
 
-template <typename T>
-class DynamicArray<T>::iterator {
-	friend class DynamicArray<T>;
-	iterator(DynamicArray<T> *arr, size_type pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+class DynamicArray<T, Allocator, GrowthPolicy>::iterator {
+public:
+	using iterator_category = std::random_access_iterator_tag;
+#if DYNAMIC_ARRAY_HAS_CONCEPTS
+	using iterator_concept = std::contiguous_iterator_tag;
+#endif
+	using value_type = T;
+	using element_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+private:
+	friend class DynamicArray<T, Allocator, GrowthPolicy>;
+	friend class const_iterator;
+	iterator(pointer ptr, const DynamicArray<T, Allocator, GrowthPolicy> *arr);
+
+public:
+	iterator();
 
 public:
 	bool operator==(const iterator &r) const;
@@ -95,18 +453,53 @@ public:
 	iterator& operator--();
 	iterator operator--(int);
 
-	reference operator*();
-	pointer operator->();
+	iterator& operator+=(difference_type n);
+	iterator& operator-=(difference_type n);
+
+	iterator operator+(difference_type n) const;
+	iterator operator-(difference_type n) const;
+	difference_type operator-(const iterator &r) const;
+
+	friend iterator operator+(difference_type n, const iterator &it) {
+		return it + n;
+	}
+
+	reference operator*() const;
+	pointer operator->() const;
+	reference operator[](difference_type n) const;
 
 private:
-	DynamicArray<T> *arr;
-	size_type pos;
+	// Throws if ptr + n is outside of the array, or is the end and has to be dereferenced.
+	// A no-op, unless DYNAMIC_ARRAY_CHECKED_ITERATORS is defined.
+	void check(difference_type n, bool dereference) const;
+
+	pointer ptr;
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	const DynamicArray<T, Allocator, GrowthPolicy> *arr;
+#endif
 };
 
-template <typename T>
-class DynamicArray<T>::const_iterator {
-	friend class DynamicArray<T>;
-	const_iterator(const DynamicArray<T> *arr, size_type pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+class DynamicArray<T, Allocator, GrowthPolicy>::const_iterator {
+public:
+	using iterator_category = std::random_access_iterator_tag;
+#if DYNAMIC_ARRAY_HAS_CONCEPTS
+	using iterator_concept = std::contiguous_iterator_tag;
+#endif
+	using value_type = T;
+	using element_type = const T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+private:
+	friend class DynamicArray<T, Allocator, GrowthPolicy>;
+	const_iterator(pointer ptr, const DynamicArray<T, Allocator, GrowthPolicy> *arr);
+
+public:
+	const_iterator();
+	const_iterator(const iterator &it);
+
 
 public:
 	bool operator==(const const_iterator &r) const;
@@ -124,26 +517,57 @@ public:
 	const_iterator& operator--();
 	const_iterator operator--(int);
 
-	const_reference operator*() const;
-	const_pointer operator->() const;
+	const_iterator& operator+=(difference_type n);
+	const_iterator& operator-=(difference_type n);
+
+	const_iterator operator+(difference_type n) const;
+	const_iterator operator-(difference_type n) const;
+	difference_type operator-(const const_iterator &r) const;
+
+	friend const_iterator operator+(difference_type n, const const_iterator &it) {
+		return it + n;
+	}
+
+	reference operator*() const;
+	pointer operator->() const;
+	reference operator[](difference_type n) const;
 
 private:
-	const DynamicArray<T> *arr;
-	size_type pos;
+	// Throws if ptr + n is outside of the array, or is the end and has to be dereferenced.
+	// A no-op, unless DYNAMIC_ARRAY_CHECKED_ITERATORS is defined.
+	void check(difference_type n, bool dereference) const;
+
+	pointer ptr;
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	const DynamicArray<T, Allocator, GrowthPolicy> *arr;
+#endif
 };
 
 /* --- DYNAMIC ARRAY --- */
-template <typename T>
-inline DynamicArray<T>::DynamicArray(size_type capacity)
-	: data(nullptr)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(const allocator_type &alloc)
+	: m_data(nullptr)
 	, m_size(0)
-	, m_capacity(0) {
+	, m_capacity(0)
+	, m_allocator(alloc) {
+
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(size_type capacity, const allocator_type &alloc)
+	: DynamicArray<T, Allocator, GrowthPolicy>(alloc) {
 	reallocate(capacity);
 }
 
-template <typename T>
-inline DynamicArray<T>::DynamicArray(const DynamicArray<T> &r)
-	: DynamicArray<T>(r.m_capacity) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(const DynamicArray<T, Allocator, GrowthPolicy> &r)
+	: DynamicArray<T, Allocator, GrowthPolicy>(r, allocator_traits::select_on_container_copy_construction(r.m_allocator)) {
+
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(const DynamicArray<T, Allocator, GrowthPolicy> &r, const allocator_type &alloc)
+	: DynamicArray<T, Allocator, GrowthPolicy>(r.m_capacity, alloc) {
 	try {
 		copyFrom(r);
 	}
@@ -153,169 +577,324 @@ inline DynamicArray<T>::DynamicArray(const DynamicArray<T> &r)
 	}
 }
 
-template <typename T>
-inline DynamicArray<T>& DynamicArray<T>::operator=(const DynamicArray<T> &rhs) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(DynamicArray<T, Allocator, GrowthPolicy> &&r) noexcept
+	: m_data(r.m_data)
+	, m_size(r.m_size)
+	, m_capacity(r.m_capacity)
+	, m_allocator(std::move(r.m_allocator)) {
+	r.m_data = nullptr;
+	r.m_size = 0;
+	r.m_capacity = 0;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::DynamicArray(DynamicArray<T, Allocator, GrowthPolicy> &&r, const allocator_type &alloc)
+	: DynamicArray<T, Allocator, GrowthPolicy>(alloc) {
+	if (m_allocator == r.m_allocator) {
+		swapStorage(r);
+		return;
+	}
+
+	// The storage of r cannot be freed by our allocator, the elements are moved one by one.
+	try {
+		moveFrom(r);
+	}
+	catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>& DynamicArray<T, Allocator, GrowthPolicy>::operator=(const DynamicArray<T, Allocator, GrowthPolicy> &rhs) {
 	if (this != &rhs) {
-		DynamicArray<T> tmp(rhs);
-		swap(tmp);
+		const bool propagate = allocator_traits::propagate_on_container_copy_assignment::value;
+		DynamicArray<T, Allocator, GrowthPolicy> tmp(rhs, propagate ? rhs.m_allocator : m_allocator);
+
+		// tmp takes the old storage, and the old allocator to free it with.
+		swapStorage(tmp);
+		copyAllocator(tmp, typename allocator_traits::propagate_on_container_copy_assignment());
 	}
 
 	return *this;
 }
 
-template <typename T>
-inline DynamicArray<T>::~DynamicArray() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>& DynamicArray<T, Allocator, GrowthPolicy>::operator=(DynamicArray<T, Allocator, GrowthPolicy> &&rhs) noexcept(
+	allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value) {
+	if (this == &rhs) {
+		return *this;
+	}
+
 	clear();
+	moveAssign(rhs, typename allocator_traits::propagate_on_container_move_assignment());
+
+	return *this;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::reference DynamicArray<T>::at(size_type pos) {
-	return const_cast<reference>(static_cast<const DynamicArray<T>&>(*this).at(pos));
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::~DynamicArray() {
+	clear();
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_reference DynamicArray<T>::at(size_type pos) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::allocator_type DynamicArray<T, Allocator, GrowthPolicy>::get_allocator() const {
+	return m_allocator;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::reference DynamicArray<T, Allocator, GrowthPolicy>::at(size_type pos) {
+	return const_cast<reference>(static_cast<const DynamicArray<T, Allocator, GrowthPolicy>&>(*this).at(pos));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_reference DynamicArray<T, Allocator, GrowthPolicy>::at(size_type pos) const {
 	if (pos >= m_size) {
 		throw std::out_of_range("Invalid position!");
 	}
 
-	return data[pos];
+	return m_data[pos];
 }
 
-template <typename T>
-inline typename DynamicArray<T>::reference DynamicArray<T>::front() {
-	return const_cast<reference>(static_cast<const DynamicArray<T>&>(*this).front());
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::reference DynamicArray<T, Allocator, GrowthPolicy>::front() {
+	return const_cast<reference>(static_cast<const DynamicArray<T, Allocator, GrowthPolicy>&>(*this).front());
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_reference DynamicArray<T>::front() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_reference DynamicArray<T, Allocator, GrowthPolicy>::front() const {
 	if (empty()) {
 		throw std::logic_error("Empty array!");
 	}
 
-	return data[0];
+	return m_data[0];
 }
 
-template <typename T>
-inline typename DynamicArray<T>::reference DynamicArray<T>::back() {
-	return const_cast<reference>(static_cast<const DynamicArray<T>&>(*this).back());
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::reference DynamicArray<T, Allocator, GrowthPolicy>::back() {
+	return const_cast<reference>(static_cast<const DynamicArray<T, Allocator, GrowthPolicy>&>(*this).back());
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_reference DynamicArray<T>::back() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_reference DynamicArray<T, Allocator, GrowthPolicy>::back() const {
 	if (empty()) {
 		throw std::logic_error("Empty array!");
 	}
 
-	return data[m_size - 1];
+	return m_data[m_size - 1];
 }
 
-template <typename T>
-inline typename DynamicArray<T>::reference DynamicArray<T>::operator[](size_type pos) {
-	return const_cast<reference>(static_cast<const DynamicArray<T>&>(*this)[pos]);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::reference DynamicArray<T, Allocator, GrowthPolicy>::operator[](size_type pos) {
+	return const_cast<reference>(static_cast<const DynamicArray<T, Allocator, GrowthPolicy>&>(*this)[pos]);
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_reference DynamicArray<T>::operator[](size_type pos) const {
-	return data[pos];
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_reference DynamicArray<T, Allocator, GrowthPolicy>::operator[](size_type pos) const {
+	return m_data[pos];
 }
 
-template <typename T>
-inline void DynamicArray<T>::pop_back() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::pointer DynamicArray<T, Allocator, GrowthPolicy>::data() {
+	return m_data;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_pointer DynamicArray<T, Allocator, GrowthPolicy>::data() const {
+	return m_data;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::pop_back() {
 	if (!empty()) {
 		--m_size;
+		destroy(m_data + m_size);
+		autoShrink();
 	}
 }
 
-template <typename T>
-inline void DynamicArray<T>::push_back(const_reference value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::push_back(const_reference value) {
+	emplace_back(value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::push_back(value_type &&value) {
+	emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::reference DynamicArray<T, Allocator, GrowthPolicy>::emplace_back(Args&&... args) {
 	if (m_size >= m_capacity) {
-		reserve(m_size + 1);
+		// The arguments might refer to an element of the array, so they are used
+		// before the old storage is released.
+		reallocateEmplace(std::forward<Args>(args)...);
+	}
+	else {
+		construct(m_data + m_size, std::forward<Args>(args)...);
 	}
 
-	data[m_size] = value;
 	++m_size;
+	return m_data[m_size - 1];
 }
 
-template <typename T>
-inline void DynamicArray<T>::reserve(size_type newCapacity) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::reserve(size_type newCapacity) {
 	resize(newCapacity);
 }
 
-template <typename T>
-inline void DynamicArray<T>::shrink_to_fit() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::shrink_to_fit() {
 	reallocate(m_size);
 }
 
-template <typename T>
-inline bool DynamicArray<T>::empty() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::empty() const {
 	return !size();
 }
 
-template <typename T>
-inline typename DynamicArray<T>::size_type DynamicArray<T>::size() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::size() const {
 	return m_size;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::size_type DynamicArray<T>::capacity() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::capacity() const {
 	return m_capacity;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator DynamicArray<T>::erase(iterator pos) {
-	iterator resultIterator = end();
-	if (pos != end()) {
-		size_type i = pos.pos;
-		resultIterator = iterator(this, i);
-
-		for (; i < m_size - 1; ++i) {
-			data[i] = data[i + 1];
-		}
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::erase(iterator pos) {
+	const size_type index = indexOf(pos);
+	if (index >= m_size) {
+		return end();
+	}
+
+	if (isTriviallyRelocatable) {
+		// Destroy the element and slide the tail over its slot.
+		destroy(m_data + index);
+		std::memmove(static_cast<void*>(m_data + index), static_cast<const void*>(m_data + index + 1), (m_size - index - 1) * sizeof(value_type));
+		--m_size;
+		autoShrink();
+
+		return iterator(m_data + index, this);
+	}
 
-		pop_back();
+	for (size_type i = index; i < m_size - 1; ++i) {
+		m_data[i] = std::move(m_data[i + 1]);
 	}
 
-	return resultIterator;
+	// The storage might shrink, the iterator is made afterwards.
+	pop_back();
+	return iterator(m_data + index, this);
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator
-DynamicArray<T>::insert(iterator pos, const_reference value) {
-	iterator resultIterator = end();
-	if (pos != end()) {
-		reserve(m_size + 1);
-		size_type insertPos = pos.pos;
-
-		for (size_type i = m_size; i > insertPos; --i) {
-			data[i] = data[i - 1];
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::erase(iterator first, iterator last) {
+	const size_type from = indexOf(first);
+	const size_type to = indexOf(last);
+
+	if (from >= to) {
+		return iterator(m_data + from, this);
+	}
+
+	dynamic_array_detail::eraseRange(m_allocator, m_data, m_size, from, to);
+	autoShrink();
+
+	return iterator(m_data + from, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::swap_erase(iterator pos) {
+	const size_type i = indexOf(pos);
+	if (i >= m_size) {
+		return end();
+	}
+
+	const size_type last = m_size - 1;
+	if (i != last) {
+		if (isTriviallyRelocatable) {
+			destroy(m_data + i);
+			std::memcpy(static_cast<void*>(m_data + i), static_cast<const void*>(m_data + last), sizeof(value_type));
+			--m_size;
+			autoShrink();
+
+			return iterator(m_data + i, this);
 		}
 
-		data[insertPos] = value;
-		++m_size;
+		m_data[i] = std::move(m_data[last]);
 	}
-	else {
-		push_back(value);
-		resultIterator = iterator(this, m_size - 1);
+
+	pop_back();
+	return iterator(m_data + i, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename Predicate>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::erase_if(Predicate pred) {
+	const size_type erased = dynamic_array_detail::eraseIf(m_allocator, m_data, m_size, pred);
+	autoShrink();
+
+	return erased;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insert(iterator pos, const_reference value) {
+	return insertValue(pos, value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insert(iterator pos, value_type &&value) {
+	return insertValue(pos, std::move(value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insert(iterator pos, size_type count, const_reference value) {
+	const size_type index = indexOf(pos);
+	if (!count) {
+		return iterator(m_data + index, this);
 	}
 
-	return resultIterator;
+	// The value might be an element of the array, which is about to move.
+	const value_type tmp(value);
+	insertCount(index, dynamic_array_detail::RepeatIterator<T>(tmp), count);
+
+	return iterator(m_data + index, this);
 }
 
-template <typename T>
-inline void DynamicArray<T>::clear() {
-	delete[] data;
-	data = nullptr;
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename InputIt, typename std::enable_if<!std::is_integral<InputIt>::value, int>::type>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insert(iterator pos, InputIt first, InputIt last) {
+	return insertRange(pos, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::clear() {
+	destroy(m_data, m_data + m_size);
+	deallocate(m_data, m_capacity);
+	m_data = nullptr;
 
 	m_size = 0;
 	m_capacity = 0;
 }
 
-template <typename T>
-inline void DynamicArray<T>::swap(DynamicArray<T> &other) {
-	value_type *tmpData = data;
-	data = other.data;
-	other.data = tmpData;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::swap(DynamicArray<T, Allocator, GrowthPolicy> &other) {
+	swapAllocator(other, typename allocator_traits::propagate_on_container_swap());
+	swapStorage(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::swapStorage(DynamicArray<T, Allocator, GrowthPolicy> &other) {
+	value_type *tmpData = m_data;
+	m_data = other.m_data;
+	other.m_data = tmpData;
 
 	size_type tmpSize = m_size;
 	m_size = other.m_size;
@@ -326,246 +905,696 @@ inline void DynamicArray<T>::swap(DynamicArray<T> &other) {
 	other.m_capacity = tmpCapacity;
 }
 
-template <typename T>
-inline void DynamicArray<T>::reallocate(size_type newCapacity) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::reallocateEmplace(Args&&... args) {
+	if (canReallocateInPlace && m_data) {
+		// The arguments might refer to an element, which moves with the block.
+		value_type tmp(std::forward<Args>(args)...);
+		reallocate(calcSizeIncrease(m_size + 1));
+		construct(m_data + m_size, std::move(tmp));
+		return;
+	}
+
+	size_type newCapacity = calcSizeIncrease(m_size + 1);
+	value_type *tmp = allocate(newCapacity);
+
+	try {
+		construct(tmp + m_size, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		deallocate(tmp, newCapacity);
+		throw;
+	}
+
+	try {
+		relocate(m_data, m_data + m_size, tmp);
+	}
+	catch (...) {
+		destroy(tmp + m_size);
+		deallocate(tmp, newCapacity);
+		throw;
+	}
+
+	deallocate(m_data, m_capacity);
+
+	m_data = tmp;
+	m_capacity = newCapacity;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename U>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::insertValue(iterator pos, U &&value) {
+	if (pos == end()) {
+		emplace_back(std::forward<U>(value));
+		return iterator(m_data + m_size - 1, this);
+	}
+
+	// The value might be an element of the array, which is about to move.
+	value_type tmp(std::forward<U>(value));
+	const size_type insertPos = indexOf(pos);
+
+	reserve(m_size + 1);
+
+	if (isTriviallyRelocatable) {
+		// Slide the tail by one slot and construct the element in the gap.
+		value_type *gap = m_data + insertPos;
+		std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), (m_size - insertPos) * sizeof(value_type));
+
+		try {
+			construct(gap, std::move(tmp));
+		}
+		catch (...) {
+			std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + 1), (m_size - insertPos) * sizeof(value_type));
+			throw;
+		}
+
+		++m_size;
+		return iterator(m_data + insertPos, this);
+	}
+
+	// The last element moves to the uninitialized slot, the rest are shifted by assignment.
+	construct(m_data + m_size, std::move(m_data[m_size - 1]));
+	++m_size;
+
+	for (size_type i = m_size - 2; i > insertPos; --i) {
+		m_data[i] = std::move(m_data[i - 1]);
+	}
+
+	m_data[insertPos] = std::move(tmp);
+
+	return iterator(m_data + insertPos, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename InputIt>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insertRange(iterator pos, InputIt first, InputIt last, std::input_iterator_tag) {
+	// The length of a single pass range is unknown, it is collected first, so the array grows only once.
+	DynamicArray<T, Allocator, GrowthPolicy> tmp(m_allocator);
+	for (; first != last; ++first) {
+		tmp.emplace_back(*first);
+	}
+
+	const size_type index = indexOf(pos);
+	insertCount(index, std::make_move_iterator(tmp.m_data), tmp.m_size);
+
+	return iterator(m_data + index, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename ForwardIt>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator
+DynamicArray<T, Allocator, GrowthPolicy>::insertRange(iterator pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+	const size_type index = indexOf(pos);
+	insertCount(index, first, static_cast<size_type>(std::distance(first, last)));
+
+	return iterator(m_data + index, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename ForwardIt>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::insertCount(size_type index, ForwardIt first, size_type count) {
+	if (!count) {
+		return;
+	}
+
+	if (m_size + count > m_capacity) {
+		size_type newCapacity = calcSizeIncrease(m_size + count);
+
+		if (isNothrowRelocatable && !canReallocateInPlace) {
+			// The new elements go straight to the new storage, the old ones are relocated around them.
+			value_type *tmp = allocate(newCapacity);
+
+			try {
+				constructRange(tmp + index, first, count);
+			}
+			catch (...) {
+				deallocate(tmp, newCapacity);
+				throw;
+			}
+
+			relocate(m_data, m_data + index, tmp);
+			relocate(m_data + index, m_data + m_size, tmp + index + count);
+			deallocate(m_data, m_capacity);
+
+			m_data = tmp;
+			m_size += count;
+			m_capacity = newCapacity;
+			return;
+		}
+
+		reallocate(newCapacity);
+	}
+
+	dynamic_array_detail::insertInPlace(m_allocator, m_data, m_size, index, first, count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename ForwardIt>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::constructRange(value_type *dest, ForwardIt first, size_type count) {
+	dynamic_array_detail::constructRange(m_allocator, dest, first, count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::indexOf(const_iterator pos) const {
+	return static_cast<size_type>(pos.ptr - m_data);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::reallocate(size_type newCapacity) {
 	if (newCapacity == m_capacity) {
 		return;
 	}
 
+	if (canReallocateInPlace && m_data && newCapacity) {
+		reallocateInPlace(newCapacity, std::integral_constant<bool, canReallocateInPlace>());
+		return;
+	}
+
 	value_type *tmp = nullptr;
 	size_type elmntsToCopy = newCapacity < m_size ? newCapacity : m_size;
 
 	if (newCapacity) {
-		try {
-			tmp = new value_type[newCapacity];
+		tmp = allocate(newCapacity);
 
-			for (size_type i = 0; i < elmntsToCopy; ++i) {
-				tmp[i] = data[i];
-			}
+		try {
+			relocate(m_data, m_data + elmntsToCopy, tmp);
 		}
 		catch (...) {
-			delete[] tmp;
+			deallocate(tmp, newCapacity);
 			throw;
 		}
 	}
 
-	delete[] data;
-	data = tmp;
+	// The elements, which do not fit, are dropped.
+	destroy(m_data + elmntsToCopy, m_data + m_size);
+	deallocate(m_data, m_capacity);
+
+	m_data = tmp;
 	m_size = elmntsToCopy;
 	m_capacity = newCapacity;
 }
 
-template <typename T>
-inline void DynamicArray<T>::resize(size_type newCapacity) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::reallocateInPlace(size_type newCapacity, std::true_type) {
+	// The elements, which do not fit, are dropped before the block is cut.
+	if (newCapacity < m_size) {
+		destroy(m_data + newCapacity, m_data + m_size);
+		m_size = newCapacity;
+	}
+
+	m_data = m_allocator.reallocate(m_data, m_capacity, newCapacity);
+	m_capacity = usableCapacity(m_data, newCapacity, has_usable_size<Allocator>());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::reallocateInPlace(size_type, std::false_type) {
+
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::resize(size_type newCapacity) {
 	return reallocate(calcSizeIncrease(newCapacity));
 }
 
-template <typename T>
-inline void DynamicArray<T>::copyFrom(const DynamicArray<T> &other) {
-	for (const_iterator it = other.begin(); it != other.end(); ++it) {
-		push_back(*it);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::copyFrom(const DynamicArray<T, Allocator, GrowthPolicy> &other) {
+	// Not reserve(), which would grow a full array by the growth policy.
+	if (other.m_size > m_capacity) {
+		reallocate(other.m_size);
+	}
+
+	if (isTriviallyCopyable) {
+		if (other.m_size) {
+			std::memcpy(static_cast<void*>(m_data), static_cast<const void*>(other.m_data), other.m_size * sizeof(value_type));
+		}
+
+		m_size = other.m_size;
+		return;
+	}
+
+	for (size_type i = 0; i < other.m_size; ++i) {
+		construct(m_data + m_size, other.m_data[i]);
+		++m_size;
 	}
 }
 
-template <typename T>
-inline typename DynamicArray<T>::size_type DynamicArray<T>::calcSizeIncrease(size_type newCapacity) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::moveAssign(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type) {
+	m_allocator = std::move(other.m_allocator);
+	swapStorage(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::moveAssign(DynamicArray<T, Allocator, GrowthPolicy> &other, std::false_type) {
+	if (m_allocator == other.m_allocator) {
+		swapStorage(other);
+	}
+	else {
+		moveFrom(other);
+	}
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::copyAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type) {
+	using std::swap;
+	swap(m_allocator, other.m_allocator);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::copyAllocator(DynamicArray<T, Allocator, GrowthPolicy>&, std::false_type) {
+
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::swapAllocator(DynamicArray<T, Allocator, GrowthPolicy> &other, std::true_type) {
+	using std::swap;
+	swap(m_allocator, other.m_allocator);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::swapAllocator(DynamicArray<T, Allocator, GrowthPolicy>&, std::false_type) {
+	// Swapping arrays with unequal allocators, which do not propagate, is undefined, like in std::vector.
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::moveFrom(DynamicArray<T, Allocator, GrowthPolicy> &other) {
+	if (other.m_size > m_capacity) {
+		reallocate(other.m_size);
+	}
+
+	for (size_type i = 0; i < other.m_size; ++i) {
+		construct(m_data + m_size, std::move(other.m_data[i]));
+		++m_size;
+	}
+
+	other.clear();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::calcSizeIncrease(size_type newCapacity) const {
 	if (newCapacity < m_capacity) {
 		return m_capacity;
 	}
 
-	size_type resultCapacity = m_capacity ? m_capacity * 2 : 1;
-	return resultCapacity < newCapacity ? newCapacity : resultCapacity;
+	return GrowthPolicy::grow(m_capacity, newCapacity, sizeof(value_type));
 }
 
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::autoShrink() {
+	const size_type newCapacity = GrowthPolicy::shrink(m_size, m_capacity);
+	if (newCapacity >= m_capacity) {
+		return;
+	}
 
-template <typename T>
-inline typename DynamicArray<T>::iterator DynamicArray<T>::begin() {
-	return iterator(this, 0);
+	try {
+		reallocate(newCapacity);
+	}
+	catch (...) {
+		// Shrinking is only an optimization, the array keeps its storage.
+	}
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator DynamicArray<T>::end() {
-	return iterator(this, m_size);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::value_type* DynamicArray<T, Allocator, GrowthPolicy>::allocate(size_type &count) {
+	if (!count) {
+		return nullptr;
+	}
+
+	value_type *ptr = allocator_traits::allocate(m_allocator, count);
+	count = usableCapacity(ptr, count, has_usable_size<Allocator>());
+
+	return ptr;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::begin() const {
-	return const_iterator(this, 0);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::usableCapacity(value_type *ptr, size_type count, std::true_type) const {
+	return GrowthPolicy::usableCapacity(count, m_allocator.usable_size(ptr, count));
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::end() const {
-	return const_iterator(this, m_size);
+// Other allocators need the exact count back.
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::size_type DynamicArray<T, Allocator, GrowthPolicy>::usableCapacity(value_type*, size_type count, std::false_type) const {
+	return count;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::cbegin() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::deallocate(value_type *ptr, size_type count) {
+	if (ptr) {
+		allocator_traits::deallocate(m_allocator, ptr, count);
+	}
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::construct(value_type *ptr, Args&&... args) {
+	allocator_traits::construct(m_allocator, ptr, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::destroy(value_type *ptr) {
+	allocator_traits::destroy(m_allocator, ptr);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::destroy(value_type *first, value_type *last) {
+	dynamic_array_detail::destroy(m_allocator, first, last);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::relocate(value_type *first, value_type *last, value_type *dest) {
+	dynamic_array_detail::relocate(m_allocator, first, last, dest);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::begin() {
+	return iterator(m_data + 0, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::end() {
+	return iterator(m_data + m_size, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::begin() const {
+	return const_iterator(m_data, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::end() const {
+	return const_iterator(m_data + m_size, this);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::cbegin() const {
 	return begin();
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::cend() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::cend() const {
 	return end();
 }
 
 /* --- ITERATOR --- */
-template <typename T>
-inline DynamicArray<T>::iterator::iterator(DynamicArray<T> *arr, size_t pos)
-	: arr(arr)
-	, pos(pos) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::iterator::iterator(pointer ptr, const DynamicArray<T, Allocator, GrowthPolicy> *arr)
+	: ptr(ptr)
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	, arr(arr)
+#endif
+{
+	(void)arr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::iterator::iterator()
+	: ptr(nullptr)
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	, arr(nullptr)
+#endif
+{
 
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator==(const iterator &r) const {
-	return (arr == r.arr && pos == r.pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator==(const iterator &r) const {
+	return ptr == r.ptr;
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator!=(const iterator &r) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator!=(const iterator &r) const {
 	return !(*this == r);
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator<(const iterator &r) const {
-	return (arr == r.arr && pos < r.pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator<(const iterator &r) const {
+	return ptr < r.ptr;
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator<=(const iterator &r) const {
-	return (*this == r || *this < r);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator<=(const iterator &r) const {
+	return !(r < *this);
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator>(const iterator &r) const {
-	return !(*this <= r);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator>(const iterator &r) const {
+	return r < *this;
 }
 
-template <typename T>
-inline bool DynamicArray<T>::iterator::operator>=(const iterator &r) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator>=(const iterator &r) const {
 	return !(*this < r);
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator& DynamicArray<T>::iterator::operator++() {
-	++pos;
-	return *this;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator& DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator++() {
+	return *this += 1;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator DynamicArray<T>::iterator::operator++(int) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator++(int) {
 	iterator res(*this);
 	++(*this);
 	return res;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator& DynamicArray<T>::iterator::operator--() {
-	if (pos) {
-		--pos;
-	}
-
-	return *this;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator& DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator--() {
+	return *this -= 1;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::iterator DynamicArray<T>::iterator::operator--(int) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator--(int) {
 	iterator res(*this);
 	--(*this);
 	return res;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::reference DynamicArray<T>::iterator::operator*() {
-	return arr->at(pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator& DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator+=(difference_type n) {
+	check(n, false);
+	ptr += n;
+	return *this;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::pointer DynamicArray<T>::iterator::operator->() {
-	return &(operator*());
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator& DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator-=(difference_type n) {
+	return *this += -n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator+(difference_type n) const {
+	iterator res(*this);
+	return res += n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator-(difference_type n) const {
+	iterator res(*this);
+	return res -= n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator::difference_type DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator-(const iterator &r) const {
+	return ptr - r.ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator::reference DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator*() const {
+	check(0, true);
+	return *ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator::pointer DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator->() const {
+	check(0, true);
+	return ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::iterator::reference DynamicArray<T, Allocator, GrowthPolicy>::iterator::operator[](difference_type n) const {
+	check(n, true);
+	return ptr[n];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::iterator::check(difference_type n, bool dereference) const {
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	const difference_type size = arr ? static_cast<difference_type>(arr->m_size) : 0;
+	const difference_type index = (arr ? ptr - arr->m_data : 0) + n;
+
+	if (!arr || index < 0 || index > size || (dereference && index == size)) {
+		throw std::out_of_range("Invalid iterator!");
+	}
+#else
+	(void)n;
+	(void)dereference;
+#endif
 }
 
 /* --- CONST_ITERATOR METHODS --- */
-template <typename T>
-inline DynamicArray<T>::const_iterator::const_iterator(const DynamicArray<T> *arr, size_t pos)
-	: arr(arr)
-	, pos(pos) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::const_iterator(pointer ptr, const DynamicArray<T, Allocator, GrowthPolicy> *arr)
+	: ptr(ptr)
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	, arr(arr)
+#endif
+{
+	(void)arr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::const_iterator()
+	: ptr(nullptr)
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	, arr(nullptr)
+#endif
+{
 
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator==(const const_iterator &r) const {
-	return (arr == r.arr && pos == r.pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::const_iterator(const iterator &it)
+	: ptr(it.ptr)
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	, arr(it.arr)
+#endif
+{
+
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator!=(const const_iterator &r) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator==(const const_iterator &r) const {
+	return ptr == r.ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator!=(const const_iterator &r) const {
 	return !(*this == r);
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator<(const const_iterator &r) const {
-	return (arr == r.arr && pos < r.pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator<(const const_iterator &r) const {
+	return ptr < r.ptr;
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator<=(const const_iterator &r) const {
-	return (*this == r || *this < r);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator<=(const const_iterator &r) const {
+	return !(r < *this);
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator>(const const_iterator &r) const {
-	return !(*this <= r);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator>(const const_iterator &r) const {
+	return r < *this;
 }
 
-template <typename T>
-inline bool DynamicArray<T>::const_iterator::operator>=(const const_iterator &r) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator>=(const const_iterator &r) const {
 	return !(*this < r);
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator& DynamicArray<T>::const_iterator::operator++() {
-	++pos;
-	return *this;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator& DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator++() {
+	return *this += 1;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::const_iterator::operator++(int) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator++(int) {
 	const_iterator res(*this);
 	++(*this);
 	return res;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator& DynamicArray<T>::const_iterator::operator--() {
-	if (pos) {
-		--pos;
-	}
-
-	return *this;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator& DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator--() {
+	return *this -= 1;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_iterator DynamicArray<T>::const_iterator::operator--(int) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator--(int) {
 	const_iterator res(*this);
 	--(*this);
 	return res;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_reference DynamicArray<T>::const_iterator::operator*() const {
-	return arr->at(pos);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator& DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator+=(difference_type n) {
+	check(n, false);
+	ptr += n;
+	return *this;
 }
 
-template <typename T>
-inline typename DynamicArray<T>::const_pointer DynamicArray<T>::const_iterator::operator->() const {
-	return &(operator*());
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator& DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator-=(difference_type n) {
+	return *this += -n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator+(difference_type n) const {
+	const_iterator res(*this);
+	return res += n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator-(difference_type n) const {
+	const_iterator res(*this);
+	return res -= n;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::difference_type DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator-(const const_iterator &r) const {
+	return ptr - r.ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::reference DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator*() const {
+	check(0, true);
+	return *ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::pointer DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator->() const {
+	check(0, true);
+	return ptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::reference DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::operator[](difference_type n) const {
+	check(n, true);
+	return ptr[n];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void DynamicArray<T, Allocator, GrowthPolicy>::const_iterator::check(difference_type n, bool dereference) const {
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	const difference_type size = arr ? static_cast<difference_type>(arr->m_size) : 0;
+	const difference_type index = (arr ? ptr - arr->m_data : 0) + n;
+
+	if (!arr || index < 0 || index > size || (dereference && index == size)) {
+		throw std::out_of_range("Invalid iterator!");
+	}
+#else
+	(void)n;
+	(void)dereference;
+#endif
 }
 
 /* std::swap */
-template <typename T>
-inline void swap(DynamicArray<T> &lhs, DynamicArray<T> &rhs) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void swap(DynamicArray<T, Allocator, GrowthPolicy> &lhs, DynamicArray<T, Allocator, GrowthPolicy> &rhs) {
 	lhs.swap(rhs);
 }
 
+#if DYNAMIC_ARRAY_HAS_PMR
+namespace pmr {
+
+// DynamicArray, whose storage comes from a std::pmr::memory_resource, e.g. a per-request arena.
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using DynamicArray = ::DynamicArray<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+} // namespace pmr
+#endif
+
 #endif // !DYNAMIC_ARRAY_CLASS_HEADER
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef DYNAMIC_ARRAY_GROWTH_POLICY_HEADER
+#define DYNAMIC_ARRAY_GROWTH_POLICY_HEADER
+
+#include <cstddef>
+
+// The growth policies of DynamicArray. A policy provides:
+//   grow(capacity, required, elementSize) - the new capacity, at least required;
+//   usableCapacity(capacity, usable) - the capacity of a fresh block of capacity elements,
+//       which can hold usable elements according to the allocator's usable_size();
+//   shrink(size, capacity) - the capacity to shrink to after removing elements,
+//       returning capacity keeps the storage.
+
+// Doubles the capacity, starting from one element.
+struct DoublingGrowth {
+	static size_t grow(size_t capacity, size_t required, size_t elementSize) {
+		(void)elementSize;
+
+		const size_t result = capacity ? capacity * 2 : 1;
+		return result < required ? required : result;
+	}
+
+	static size_t usableCapacity(size_t capacity, size_t usable) {
+		(void)usable;
+
+		return capacity;
+	}
+
+	static size_t shrink(size_t size, size_t capacity) {
+		(void)size;
+
+		return capacity;
+	}
+};
+
+// Grows by 1.5x. The sum of the freed blocks eventually exceeds the next request,
+// so the allocator can reuse them, and at most a third of the storage is unused.
+struct OneAndHalfGrowth : DoublingGrowth {
+	static size_t grow(size_t capacity, size_t required, size_t elementSize) {
+		(void)elementSize;
+
+		const size_t result = capacity + capacity / 2 + 1;
+		return result < required ? required : result;
+	}
+};
+
+// Grows by 1.5x and then takes all the space, which the allocator rounded the block up to.
+// Only the allocators with usable_size(), like ReallocAllocator, report it, with the others
+// it behaves like OneAndHalfGrowth.
+struct SizeClassGrowth : OneAndHalfGrowth {
+	static size_t usableCapacity(size_t capacity, size_t usable) {
+		return usable > capacity ? usable : capacity;
+	}
+};
+
+// Adds hysteresis-based shrinking to another policy: once the array is down to a quarter
+// of its capacity, the capacity is halved. The array is still at most half full, so
+// a few pushes do not grow it right back. Small arrays are never shrunk.
+template <typename Growth, size_t MinCapacity = 16>
+struct AutoShrink : Growth {
+	static size_t shrink(size_t size, size_t capacity) {
+		if (capacity <= MinCapacity || size > capacity / 4) {
+			return capacity;
+		}
+
+		const size_t result = capacity / 2;
+		return result < MinCapacity ? MinCapacity : result;
+	}
+};
+
+#endif // !DYNAMIC_ARRAY_GROWTH_POLICY_HEADER
@@ -0,0 +1,199 @@
+#pragma once
+#ifndef DYNAMIC_ARRAY_REALLOC_ALLOCATOR_HEADER
+#define DYNAMIC_ARRAY_REALLOC_ALLOCATOR_HEADER
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#endif
+
+// Blocks of at least Bytes are mapped with mmap() and grown with mremap(), so the kernel
+// moves the page tables instead of the bytes. Smaller blocks come from malloc() and are
+// grown with realloc(). Mapping needs Linux, elsewhere every block comes from malloc().
+template <size_t Bytes = 1024 * 1024>
+struct MapThreshold {
+	static bool useMap(size_t bytes) {
+#if defined(__linux__)
+		return bytes >= Bytes;
+#else
+		(void)bytes;
+		return false;
+#endif
+	}
+};
+
+// An allocator, which can resize a block in place. DynamicArray uses reallocate() instead of
+// allocate-relocate-deallocate for trivially relocatable types, so growing a large array
+// neither copies it nor needs both the old and the new block at the same time.
+template <typename T, typename Threshold = MapThreshold<>>
+class ReallocAllocator {
+	static_assert(alignof(T) <= alignof(std::max_align_t), "malloc() does not align the blocks enough.");
+
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template <typename U>
+	struct rebind {
+		using other = ReallocAllocator<U, Threshold>;
+	};
+
+public:
+	ReallocAllocator() = default;
+
+	template <typename U>
+	ReallocAllocator(const ReallocAllocator<U, Threshold>&) {}
+
+public:
+	T* allocate(size_t count);
+	void deallocate(T *ptr, size_t count);
+
+	// Resizes the block to newCount elements, keeping min(oldCount, newCount) of them as raw bytes.
+	// The block might move. Throws std::bad_alloc and keeps the old block, if it fails.
+	T* reallocate(T *ptr, size_t oldCount, size_t newCount);
+
+	// The number of elements, which the block of count elements can hold: malloc() rounds
+	// up to its size classes and mmap() to pages. deallocate() and reallocate() accept
+	// any count from count to the result for the block.
+	size_t usable_size(T *ptr, size_t count) const;
+
+	bool operator==(const ReallocAllocator&) const { return true; }
+	bool operator!=(const ReallocAllocator&) const { return false; }
+
+private:
+	static size_t bytesFor(size_t count);
+
+	static void* mapBlock(size_t bytes);
+	static void unmapBlock(void *ptr, size_t bytes);
+	static size_t mappedSize(size_t bytes);
+};
+
+template <typename T, typename Threshold>
+inline T* ReallocAllocator<T, Threshold>::allocate(size_t count) {
+	const size_t bytes = bytesFor(count);
+	void *ptr = Threshold::useMap(bytes) ? mapBlock(bytes) : std::malloc(bytes);
+
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+
+	return static_cast<T*>(ptr);
+}
+
+template <typename T, typename Threshold>
+inline void ReallocAllocator<T, Threshold>::deallocate(T *ptr, size_t count) {
+	const size_t bytes = count * sizeof(T);
+
+	if (Threshold::useMap(bytes)) {
+		unmapBlock(ptr, bytes);
+	}
+	else {
+		std::free(ptr);
+	}
+}
+
+template <typename T, typename Threshold>
+inline T* ReallocAllocator<T, Threshold>::reallocate(T *ptr, size_t oldCount, size_t newCount) {
+	const size_t oldBytes = oldCount * sizeof(T);
+	const size_t newBytes = bytesFor(newCount);
+
+	const bool oldMapped = Threshold::useMap(oldBytes);
+	const bool newMapped = Threshold::useMap(newBytes);
+
+	if (!oldMapped && !newMapped) {
+		void *result = std::realloc(static_cast<void*>(ptr), newBytes);
+		if (!result) {
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T*>(result);
+	}
+
+#if defined(__linux__)
+	if (oldMapped && newMapped) {
+		void *result = mremap(ptr, mappedSize(oldBytes), mappedSize(newBytes), MREMAP_MAYMOVE);
+		if (result == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T*>(result);
+	}
+#endif
+
+	// Crossing the threshold, the bytes are copied once.
+	T *result = allocate(newCount);
+	std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr), oldBytes < newBytes ? oldBytes : newBytes);
+	deallocate(ptr, oldCount);
+
+	return result;
+}
+
+template <typename T, typename Threshold>
+inline size_t ReallocAllocator<T, Threshold>::usable_size(T *ptr, size_t count) const {
+	const size_t bytes = count * sizeof(T);
+
+	if (Threshold::useMap(bytes)) {
+		return mappedSize(bytes) / sizeof(T);
+	}
+
+#if defined(__GLIBC__) || defined(__linux__)
+	// A count past the threshold would be taken for a mapped block.
+	const size_t usable = malloc_usable_size(static_cast<void*>(ptr)) / sizeof(T);
+	return usable > count && !Threshold::useMap(usable * sizeof(T)) ? usable : count;
+#else
+	(void)ptr;
+	return count;
+#endif
+}
+
+template <typename T, typename Threshold>
+inline size_t ReallocAllocator<T, Threshold>::bytesFor(size_t count) {
+	if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+
+	return count ? count * sizeof(T) : 1;
+}
+
+template <typename T, typename Threshold>
+inline void* ReallocAllocator<T, Threshold>::mapBlock(size_t bytes) {
+#if defined(__linux__)
+	void *ptr = mmap(nullptr, mappedSize(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return ptr == MAP_FAILED ? nullptr : ptr;
+#else
+	return std::malloc(bytes);
+#endif
+}
+
+template <typename T, typename Threshold>
+inline void ReallocAllocator<T, Threshold>::unmapBlock(void *ptr, size_t bytes) {
+#if defined(__linux__)
+	munmap(ptr, mappedSize(bytes));
+#else
+	(void)bytes;
+	std::free(ptr);
+#endif
+}
+
+template <typename T, typename Threshold>
+inline size_t ReallocAllocator<T, Threshold>::mappedSize(size_t bytes) {
+#if defined(__linux__)
+	static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	return (bytes + pageSize - 1) / pageSize * pageSize;
+#else
+	return bytes;
+#endif
+}
+
+#endif // !DYNAMIC_ARRAY_REALLOC_ALLOCATOR_HEADER
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "DynamicArray.h"
+#include "ReallocAllocator.h"
+
+// Grows an array of floats with push_back() up to the given size. Every run happens in a
+// child process, so its peak RSS is not mixed with the previous runs.
+template <typename Array>
+void grow(size_t bytes) {
+	const size_t count = bytes / sizeof(float);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	Array arr;
+	for (size_t i = 0; i < count; ++i) {
+		arr.push_back(static_cast<float>(i));
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	std::printf("%10.1f ms, peak RSS %8ld MB", std::chrono::duration<double, std::milli>(end - start).count(), usage.ru_maxrss / 1024);
+}
+
+template <typename Array>
+void run(const char *name, size_t bytes) {
+	std::printf("%-20s %8zu MB: ", name, bytes >> 20);
+	std::fflush(stdout);
+
+	const pid_t pid = fork();
+	if (pid == 0) {
+		grow<Array>(bytes);
+		std::printf("\n");
+		std::fflush(stdout);
+		_exit(0);
+	}
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+		std::printf("failed\n");
+	}
+}
+
+int main(int argc, char **argv) {
+	// The largest size in MB, 4 GB by default.
+	const size_t maxMegabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+
+	for (size_t megabytes = 1; megabytes <= maxMegabytes; megabytes *= 2) {
+		run<DynamicArray<float>>("std::allocator", megabytes << 20);
+		run<DynamicArray<float, ReallocAllocator<float>>>("ReallocAllocator", megabytes << 20);
+	}
+
+	return 0;
+}
@@ -1,5 +1,641 @@
 #include <iostream>
+#include <cassert>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <algorithm>
+#include <numeric>
+
 #include "DynamicArray.h"
+#include "ReallocAllocator.h"
+
+// Counts the live objects and the copies.
+struct Tracked {
+	static int alive;
+	static int copies;
+
+	int value;
+
+	Tracked(int value = 0) : value(value) { ++alive; }
+	Tracked(const Tracked &r) : value(r.value) { ++alive; ++copies; }
+	Tracked(Tracked &&r) noexcept : value(r.value) { ++alive; }
+	Tracked& operator=(const Tracked &rhs) { value = rhs.value; ++copies; return *this; }
+	Tracked& operator=(Tracked &&rhs) noexcept { value = rhs.value; return *this; }
+	~Tracked() { --alive; }
+};
+
+int Tracked::alive = 0;
+int Tracked::copies = 0;
+
+// Owns a heap buffer, so it is not trivially copyable, but it can be moved with memcpy().
+struct Buffer {
+	static int moves;
+
+	int *ptr;
+
+	Buffer(int value = 0) : ptr(new int(value)) {}
+	Buffer(const Buffer &r) : ptr(new int(*r.ptr)) {}
+	Buffer(Buffer &&r) noexcept : ptr(r.ptr) { r.ptr = nullptr; ++moves; }
+	Buffer& operator=(Buffer rhs) { std::swap(ptr, rhs.ptr); return *this; }
+	~Buffer() { delete ptr; }
+};
+
+int Buffer::moves = 0;
+
+template <>
+struct is_trivially_relocatable<Buffer> : std::true_type {};
+
+// Counts the allocations and the bytes in use, shared by all the rebound copies.
+struct AllocationStats {
+	static size_t allocations;
+	static size_t bytesInUse;
+};
+
+size_t AllocationStats::allocations = 0;
+size_t AllocationStats::bytesInUse = 0;
+
+template <typename T>
+struct CountingAllocator {
+	using value_type = T;
+
+	CountingAllocator() = default;
+
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t count) {
+		++AllocationStats::allocations;
+		AllocationStats::bytesInUse += count * sizeof(T);
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T *ptr, size_t count) {
+		AllocationStats::bytesInUse -= count * sizeof(T);
+		std::allocator<T>().deallocate(ptr, count);
+	}
+
+	bool operator==(const CountingAllocator&) const { return true; }
+	bool operator!=(const CountingAllocator&) const { return false; }
+};
+
+// A stateful allocator, which propagates on copy assignment, move assignment and swap.
+// Every block must come back to the allocator with the same tag.
+template <typename T>
+struct TaggedAllocator {
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	static std::map<const void*, int> owners;
+
+	explicit TaggedAllocator(int tag)
+		: tag(tag) {
+
+	}
+
+	template <typename U>
+	TaggedAllocator(const TaggedAllocator<U> &r)
+		: tag(r.tag) {
+
+	}
+
+	T* allocate(size_t count) {
+		T *ptr = std::allocator<T>().allocate(count);
+		owners[ptr] = tag;
+		return ptr;
+	}
+
+	void deallocate(T *ptr, size_t count) {
+		assert(owners[ptr] == tag);
+		owners.erase(ptr);
+		std::allocator<T>().deallocate(ptr, count);
+	}
+
+	bool operator==(const TaggedAllocator &r) const { return tag == r.tag; }
+	bool operator!=(const TaggedAllocator &r) const { return tag != r.tag; }
+
+	int tag;
+};
+
+template <typename T>
+std::map<const void*, int> TaggedAllocator<T>::owners;
+
+void testPropagatingAllocator() {
+	using Array = DynamicArray<std::string, TaggedAllocator<std::string>>;
+
+	{
+		Array a(TaggedAllocator<std::string>(1));
+		Array b(TaggedAllocator<std::string>(2));
+		for (int i = 0; i < 10; ++i) {
+			a.push_back(std::to_string(i));
+			b.push_back(std::to_string(i * 2));
+		}
+
+		// The copy takes the allocator of the source, the old storage goes back to its own.
+		a = b;
+		assert(a.get_allocator().tag == 2 && a[9] == "18");
+		a.push_back("more");
+
+		Array c(TaggedAllocator<std::string>(3));
+		c.push_back("three");
+		c = std::move(a);
+		assert(c.get_allocator().tag == 2 && c.size() == 11);
+
+		Array d(TaggedAllocator<std::string>(4));
+		d.push_back("four");
+		c.swap(d);
+		assert(c.get_allocator().tag == 4 && d.get_allocator().tag == 2 && d.back() == "more");
+	}
+
+	assert(TaggedAllocator<std::string>::owners.empty());
+}
+
+template <template <typename> class Alloc>
+void testMoveSemantics() {
+	Tracked::copies = 0;
+
+	{
+		DynamicArray<Tracked, Alloc<Tracked>> a(100);
+
+		// The capacity is not constructed.
+		assert(Tracked::alive == 0);
+
+		for (int i = 0; i < 1000; ++i) {
+			a.emplace_back(i);
+		}
+
+		// Growing moves the elements instead of copying them.
+		assert(Tracked::alive == 1000);
+		assert(Tracked::copies == 0);
+
+		DynamicArray<Tracked, Alloc<Tracked>> b(std::move(a));
+		assert(a.empty() && b.size() == 1000);
+
+		a = std::move(b);
+		assert(b.empty() && a.size() == 1000);
+		assert(Tracked::copies == 0);
+
+		a.pop_back();
+		assert(Tracked::alive == 999);
+
+		a.insert(a.begin(), Tracked(-1));
+		a.erase(a.begin());
+		assert(a.front().value == 0 && a.back().value == 998);
+
+		DynamicArray<Tracked, Alloc<Tracked>> c(a);
+		assert(Tracked::copies == 999);
+	}
+
+	assert(Tracked::alive == 0);
+
+	// Move-only elements.
+	DynamicArray<std::unique_ptr<int>, Alloc<std::unique_ptr<int>>> ptrs;
+	for (int i = 0; i < 100; ++i) {
+		ptrs.push_back(std::unique_ptr<int>(new int(i)));
+	}
+
+	ptrs.insert(ptrs.begin(), std::unique_ptr<int>(new int(-1)));
+	assert(*ptrs.front() == -1 && *ptrs.back() == 99);
+}
+
+template <template <typename> class Alloc>
+void testStrings() {
+	DynamicArray<std::string, Alloc<std::string>> strings;
+
+	for (int i = 0; i < 100; ++i) {
+		strings.push_back(std::string(50, char('a' + i % 26)));
+	}
+
+	// The argument refers to an element, which moves when the array grows.
+	while (strings.size() != strings.capacity()) {
+		strings.push_back("fill");
+	}
+
+	strings.push_back(strings[0]);
+	assert(strings.back() == std::string(50, 'a'));
+
+	strings.insert(strings.begin(), strings[1]);
+	assert(strings.front() == std::string(50, 'b'));
+	assert(strings[1] == std::string(50, 'a'));
+
+	strings.shrink_to_fit();
+	assert(strings.size() == strings.capacity());
+}
+
+template <template <typename> class Alloc>
+void testTriviallyRelocatable() {
+	DynamicArray<int, Alloc<int>> numbers;
+	for (int i = 0; i < 1000; ++i) {
+		numbers.push_back(i);
+	}
+
+	DynamicArray<int, Alloc<int>> copy(numbers);
+	assert(copy.size() == 1000 && copy.back() == 999);
+
+	numbers.erase(numbers.begin());
+	numbers.insert(numbers.begin(), -1);
+	assert(numbers.front() == -1 && numbers.size() == 1000 && numbers.back() == 999);
+
+	{
+		Buffer::moves = 0;
+		DynamicArray<Buffer, Alloc<Buffer>> buffers;
+		for (int i = 0; i < 1000; ++i) {
+			buffers.emplace_back(i);
+		}
+
+		// Growing and erasing relocate the buffers with memcpy().
+		buffers.erase(buffers.begin());
+		assert(Buffer::moves == 0);
+
+		// Only the inserted buffer is moved, the rest slide with memmove().
+		buffers.insert(buffers.begin(), Buffer(-1));
+		const int moves = Buffer::moves;
+
+		buffers.shrink_to_fit();
+		assert(Buffer::moves == moves);
+		assert(*buffers.front().ptr == -1 && *buffers.back().ptr == 999);
+
+		DynamicArray<Buffer, Alloc<Buffer>> copies(buffers);
+		assert(*copies.at(500).ptr == 500);
+		assert(copies.at(500).ptr != buffers.at(500).ptr);
+	}
+}
+
+template <typename T>
+bool equals(const DynamicArray<T> &arr, std::initializer_list<T> expected) {
+	if (arr.size() != expected.size()) {
+		return false;
+	}
+
+	size_t i = 0;
+	for (const T &value : expected) {
+		if (!(arr[i++] == value)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <typename T>
+struct MakeValue {
+	static T make(int i) { return T(i); }
+};
+
+template <>
+struct MakeValue<std::string> {
+	// Long enough to live on the heap.
+	static std::string make(int i) { return std::string(40, 'x') + std::to_string(i); }
+};
+
+template <typename T>
+void testRangeOperations() {
+	auto v = [](int i) { return MakeValue<T>::make(i); };
+	const T values[] = { v(10), v(11), v(12) };
+
+	DynamicArray<T> a;
+	for (int i = 0; i < 5; ++i) {
+		a.push_back(v(i));
+	}
+
+	// Into the middle with a short tail, a long tail, at the end and with growing.
+	a.insert(a.end(), values, values + 3);
+	assert(equals(a, { v(0), v(1), v(2), v(3), v(4), v(10), v(11), v(12) }));
+
+	a.erase(a.begin(), a.end());
+	assert(a.empty());
+
+	for (int i = 0; i < 5; ++i) {
+		a.push_back(v(i));
+	}
+
+	a.shrink_to_fit();
+	a.insert(a.begin(), values, values + 3);
+	assert(equals(a, { v(10), v(11), v(12), v(0), v(1), v(2), v(3), v(4) }));
+
+	a.reserve(100);
+	std::list<T> list(values, values + 3);
+	typename DynamicArray<T>::iterator it = a.insert(++++++++++++a.begin(), list.begin(), list.end());
+	assert(*it == v(10));
+	assert(equals(a, { v(10), v(11), v(12), v(0), v(1), v(2), v(10), v(11), v(12), v(3), v(4) }));
+
+	// Filling, also with a value from the array itself.
+	a.insert(++a.begin(), 2, a[0]);
+	assert(equals(a, { v(10), v(10), v(10), v(11), v(12), v(0), v(1), v(2), v(10), v(11), v(12), v(3), v(4) }));
+
+	assert(a.erase_if([&v](const T &value) { return value == v(10); }) == 4);
+	assert(equals(a, { v(11), v(12), v(0), v(1), v(2), v(11), v(12), v(3), v(4) }));
+
+	typename DynamicArray<T>::iterator first = ++++a.begin();
+	typename DynamicArray<T>::iterator last = first;
+	for (int i = 0; i < 4; ++i) {
+		++last;
+	}
+
+	it = a.erase(first, last);
+	assert(*it == v(12));
+	assert(equals(a, { v(11), v(12), v(12), v(3), v(4) }));
+
+	it = a.swap_erase(a.begin());
+	assert(*it == v(4));
+	assert(equals(a, { v(4), v(12), v(12), v(3) }));
+
+	it = a.swap_erase(++++++a.begin());
+	assert(it == a.end());
+	assert(equals(a, { v(4), v(12), v(12) }));
+
+	a.reserve(100);
+	a.insert(++++a.begin(), values, values + 3);
+	assert(equals(a, { v(4), v(12), v(10), v(11), v(12), v(12) }));
+}
+
+void testRanges() {
+	testRangeOperations<int>();
+	testRangeOperations<std::string>();
+
+	// A single pass range grows the array only once, straight to the needed capacity.
+	DynamicArray<int> a;
+	a.push_back(1);
+	a.push_back(2);
+
+	std::istringstream in("3 4 5 6 7 8 9");
+	a.insert(++a.begin(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+	assert(a.capacity() == 9);
+	assert(a.size() == 9 && a[1] == 3 && a[7] == 9 && a[8] == 2);
+
+	{
+		DynamicArray<Tracked> tracked;
+		tracked.insert(tracked.end(), 100, Tracked(7));
+		assert(Tracked::alive == 100);
+
+		tracked.erase_if([](const Tracked &t) { return t.value == 7; });
+		assert(Tracked::alive == 0 && tracked.empty());
+	}
+
+	DynamicArray<Buffer> buffers;
+	buffers.insert(buffers.end(), 10, Buffer(1));
+	assert(buffers.erase_if([](const Buffer &b) { return *b.ptr == 1; }) == 10);
+}
+
+#if __cplusplus >= 202002L
+static_assert(std::contiguous_iterator<DynamicArray<int>::iterator>);
+static_assert(std::contiguous_iterator<DynamicArray<int>::const_iterator>);
+#endif
+
+void testIterators() {
+	DynamicArray<int> a;
+	for (int i = 0; i < 100; ++i) {
+		a.push_back((i * 37) % 100);
+	}
+
+	std::sort(a.begin(), a.end());
+	assert(std::is_sorted(a.cbegin(), a.cend()));
+	assert(a.end() - a.begin() == 100);
+	assert(&*(a.begin() + 10) == a.data() + 10);
+	assert(a.begin()[99] == 99 && *(a.end() - 1) == 99 && *(2 + a.begin()) == 2);
+
+	const DynamicArray<int> &ca = a;
+	DynamicArray<int>::const_iterator it = a.begin();
+	it += 50;
+	assert(*it == 50 && it - ca.begin() == 50);
+	assert(std::accumulate(ca.begin(), ca.end(), 0) == 4950);
+	assert(std::lower_bound(ca.begin(), ca.end(), 42) - ca.begin() == 42);
+
+	std::reverse(a.begin(), a.end());
+	assert(a.front() == 99 && ca.data()[99] == 0);
+
+#ifdef DYNAMIC_ARRAY_CHECKED_ITERATORS
+	bool thrown = false;
+	try {
+		*a.end();
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	thrown = false;
+	try {
+		a.begin() - 1;
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+#endif
+}
+
+template <typename GrowthPolicy>
+void testGrowthPolicy() {
+	{
+		DynamicArray<Tracked, std::allocator<Tracked>, GrowthPolicy> a;
+		for (int i = 0; i < 1000; ++i) {
+			a.emplace_back(i);
+			assert(a.capacity() >= a.size());
+		}
+
+		a.insert(a.begin() + 10, 5, Tracked(-1));
+		a.erase(a.begin(), a.begin() + 500);
+		while (a.size() > 10) {
+			a.pop_back();
+		}
+
+		assert(a.front().value == 495 && a.back().value == 504);
+	}
+
+	assert(Tracked::alive == 0);
+}
+
+void testGrowthPolicies() {
+	testGrowthPolicy<DoublingGrowth>();
+	testGrowthPolicy<OneAndHalfGrowth>();
+	testGrowthPolicy<SizeClassGrowth>();
+	testGrowthPolicy<AutoShrink<DoublingGrowth>>();
+	testGrowthPolicy<AutoShrink<SizeClassGrowth, 4>>();
+
+	DynamicArray<int, std::allocator<int>, OneAndHalfGrowth> slow;
+	size_t capacities[6];
+	for (size_t &capacity : capacities) {
+		slow.push_back(0);
+		slow.reserve(slow.capacity() + 1);
+		capacity = slow.capacity();
+	}
+
+	assert(capacities[0] == 2 && capacities[1] == 4 && capacities[2] == 7 && capacities[3] == 11 && capacities[4] == 17);
+
+	static_assert(has_usable_size<ReallocAllocator<char>>::value, "ReallocAllocator reports the usable size.");
+	static_assert(!has_usable_size<std::allocator<char>>::value, "std::allocator does not.");
+
+	// The allocators without usable_size() need the exact count back, so it is not rounded up.
+	DynamicArray<char, CountingAllocator<char>, SizeClassGrowth> exact;
+	exact.push_back('a');
+	assert(exact.capacity() == 1);
+
+#if defined(__GLIBC__)
+	// The whole block, which malloc() handed out, is used.
+	DynamicArray<char, ReallocAllocator<char, MapThreshold<4096>>, SizeClassGrowth> chars;
+	chars.push_back('a');
+	assert(chars.capacity() == malloc_usable_size(chars.data()));
+
+	// Crosses from malloc() to mmap(), where the capacity is rounded up to the pages.
+	for (int i = 0; i < 10000; ++i) {
+		chars.push_back('b');
+	}
+
+	assert(chars.size() == 10001 && chars.front() == 'a' && chars.capacity() % 4096 == 0);
+
+	chars.erase(chars.begin() + 100, chars.end());
+	chars.shrink_to_fit();
+	assert(chars.capacity() == malloc_usable_size(chars.data()) && chars.back() == 'b');
+#endif
+
+	// Shrinks at a quarter of the capacity, but not back and forth around the boundary.
+	DynamicArray<int, std::allocator<int>, AutoShrink<DoublingGrowth>> shrinking;
+	for (int i = 0; i < 1024; ++i) {
+		shrinking.push_back(i);
+	}
+
+	while (shrinking.size() > 256) {
+		shrinking.pop_back();
+	}
+
+	assert(shrinking.capacity() == 512);
+
+	shrinking.push_back(0);
+	shrinking.pop_back();
+	shrinking.pop_back();
+	assert(shrinking.capacity() == 512);
+
+	while (shrinking.size() > 3) {
+		shrinking.pop_back();
+	}
+
+	assert(shrinking.capacity() == 16 && shrinking.back() == 2);
+}
+
+void testReallocAllocator() {
+	using SmallThreshold = MapThreshold<4096>;
+
+	static_assert(has_reallocate<ReallocAllocator<int>>::value, "ReallocAllocator resizes in place.");
+	static_assert(!has_reallocate<std::allocator<int>>::value, "std::allocator does not.");
+
+	DynamicArray<int, ReallocAllocator<int, SmallThreshold>> numbers;
+	for (int i = 0; i < 100000; ++i) {
+		// Crosses from malloc() to mmap() on the way.
+		numbers.push_back(i);
+	}
+
+	// The argument refers to an element, which moves with the block.
+	while (numbers.size() != numbers.capacity()) {
+		numbers.push_back(0);
+	}
+
+	numbers.push_back(numbers[1]);
+	assert(numbers.back() == 1 && numbers[99999] == 99999);
+
+	numbers.insert(numbers.begin() + 5, 3, -1);
+	numbers.erase(numbers.begin(), numbers.begin() + 5);
+	assert(numbers[0] == -1 && numbers[3] == 5);
+
+	numbers.erase(numbers.begin() + 100, numbers.end());
+	numbers.shrink_to_fit();
+	assert(numbers.capacity() == 100 && numbers[99] == 101);
+
+	DynamicArray<int, ReallocAllocator<int, SmallThreshold>> copy(numbers);
+	assert(copy.size() == 100 && copy[99] == 101);
+
+	{
+		DynamicArray<Buffer, ReallocAllocator<Buffer, SmallThreshold>> buffers;
+		for (int i = 0; i < 10000; ++i) {
+			buffers.emplace_back(i);
+		}
+
+		buffers.erase(buffers.begin() + 10, buffers.end());
+		buffers.shrink_to_fit();
+		assert(*buffers.back().ptr == 9);
+	}
+
+	// Not trivially relocatable, so the elements are moved one by one.
+	DynamicArray<std::string, ReallocAllocator<std::string, SmallThreshold>> strings;
+	for (int i = 0; i < 1000; ++i) {
+		strings.push_back(std::string(40, char('a' + i % 26)));
+	}
+
+	assert(strings[999] == std::string(40, 'l'));
+}
+
+void testCopyCapacity() {
+	DynamicArray<int> full(8);
+	for (int i = 0; i < 8; ++i) {
+		full.push_back(i);
+	}
+
+	// The copy of a full array is full too, it is not grown by the growth policy.
+	DynamicArray<int> copy(full);
+	assert(copy.capacity() == 8 && copy[7] == 7);
+
+	DynamicArray<std::string> strings(4);
+	for (int i = 0; i < 4; ++i) {
+		strings.push_back(std::string(40, char('a' + i)));
+	}
+
+	DynamicArray<std::string> stringsCopy(strings);
+	assert(stringsCopy.capacity() == 4 && stringsCopy[3] == std::string(40, 'd'));
+
+	const DynamicArray<int> empty;
+	DynamicArray<int> emptyCopy(empty);
+	assert(emptyCopy.capacity() == 0 && emptyCopy.data() == nullptr);
+
+	// The elements moved between unequal allocators get exactly the room they need.
+	char arena[4096];
+	std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena));
+	pmr::DynamicArray<int> source(&resource);
+	for (int i = 0; i < 5; ++i) {
+		source.push_back(i);
+	}
+
+	pmr::DynamicArray<int> moved(std::move(source), std::pmr::get_default_resource());
+	assert(moved.capacity() == 5 && moved[4] == 4);
+
+	pmr::DynamicArray<int> assigned(&resource);
+	assigned = std::move(moved);
+	assert(assigned.capacity() == 5 && assigned.size() == 5);
+}
+
+void testPmr() {
+	char arena[16 * 1024];
+	std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+
+	pmr::DynamicArray<std::pmr::string> strings(&resource);
+	for (int i = 0; i < 20; ++i) {
+		strings.emplace_back(40, char('a' + i));
+	}
+
+	// The elements get the allocator of the array.
+	assert(strings.back().get_allocator().resource() == &resource);
+
+	// Copies get the default resource, moves and allocator-extended copies keep theirs.
+	pmr::DynamicArray<std::pmr::string> copy(strings);
+	assert(copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+	pmr::DynamicArray<std::pmr::string> arenaCopy(strings, &resource);
+	assert(arenaCopy.get_allocator().resource() == &resource);
+	assert(arenaCopy[19] == std::pmr::string(40, 't'));
+
+	// The allocators are not propagated on assignment, the elements are moved over.
+	copy = std::move(arenaCopy);
+	assert(copy.get_allocator().resource() == std::pmr::get_default_resource());
+	assert(copy.size() == 20 && arenaCopy.empty());
+	assert(copy[0].get_allocator().resource() == std::pmr::get_default_resource());
+
+	pmr::DynamicArray<std::pmr::string> moved(std::move(strings));
+	assert(moved.get_allocator().resource() == &resource && strings.empty());
+}
 
 int main() {
 	DynamicArray<int> a;
@@ -13,5 +649,22 @@ int main() {
 		std::cout << *it << '\n';
 	}
 
+	testMoveSemantics<std::allocator>();
+	testStrings<std::allocator>();
+	testTriviallyRelocatable<std::allocator>();
+
+	testMoveSemantics<CountingAllocator>();
+	testStrings<CountingAllocator>();
+	testTriviallyRelocatable<CountingAllocator>();
+	assert(AllocationStats::allocations && !AllocationStats::bytesInUse);
+
+	testPropagatingAllocator();
+	testPmr();
+	testCopyCapacity();
+	testRanges();
+	testIterators();
+	testGrowthPolicies();
+	testReallocAllocator();
+
 	return 0;
 }
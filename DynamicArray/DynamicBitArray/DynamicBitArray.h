@@ -0,0 +1,677 @@
+#pragma once
+#ifndef DYNAMIC_BIT_ARRAY_HEADER
+#define DYNAMIC_BIT_ARRAY_HEADER
+
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../DynamicArray/DynamicArray.h"
+
+// The word loops are compiled for AVX-512, AVX2 and the baseline, and the loader picks one
+// of them for the CPU. That needs GCC and ifunc support, elsewhere they are compiled once.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define DYNAMIC_BIT_ARRAY_VECTOR_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#define DYNAMIC_BIT_ARRAY_POPCOUNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define DYNAMIC_BIT_ARRAY_VECTOR_CLONES
+#define DYNAMIC_BIT_ARRAY_POPCOUNT_CLONES
+#endif
+
+namespace bit_array_detail {
+
+enum class BitOp {
+	And,
+	Or,
+	Xor,
+	AndNot
+};
+
+inline size_t popcount(uint64_t word) {
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_popcountll(word));
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// The index of the lowest set bit, the word must not be 0.
+inline size_t lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_ctzll(word));
+#else
+	size_t result = 0;
+	while (!(word & 1)) {
+		word >>= 1;
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+// a = a op b. The vectors are passed by reference, so it needs no vector calling convention.
+template <BitOp Op, typename Word>
+inline void combine(Word &a, const Word &b) {
+	switch (Op) {
+	case BitOp::And:
+		a &= b;
+		break;
+	case BitOp::Or:
+		a |= b;
+		break;
+	case BitOp::Xor:
+		a ^= b;
+		break;
+	case BitOp::AndNot:
+		a &= ~b;
+		break;
+	}
+}
+
+#if defined(__GNUC__)
+// Eight words, which the compiler splits into the widest registers of the target.
+typedef uint64_t WordBlock __attribute__((vector_size(64)));
+
+const size_t blockWords = sizeof(WordBlock) / sizeof(uint64_t);
+
+template <BitOp Op>
+inline __attribute__((always_inline)) void applyWords(uint64_t *dst, const uint64_t *src, size_t count) {
+	size_t i = 0;
+	for (; i + blockWords <= count; i += blockWords) {
+		WordBlock a, b;
+		std::memcpy(&a, dst + i, sizeof(a));
+		std::memcpy(&b, src + i, sizeof(b));
+
+		combine<Op>(a, b);
+		std::memcpy(dst + i, &a, sizeof(a));
+	}
+
+	for (; i < count; ++i) {
+		combine<Op>(dst[i], src[i]);
+	}
+}
+#else
+template <BitOp Op>
+inline void applyWords(uint64_t *dst, const uint64_t *src, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		combine<Op>(dst[i], src[i]);
+	}
+}
+#endif
+
+// dst = dst op src for every word. The arrays may be the same, but must not overlap otherwise.
+DYNAMIC_BIT_ARRAY_VECTOR_CLONES
+inline void bitwiseWords(BitOp op, uint64_t *dst, const uint64_t *src, size_t count) {
+	switch (op) {
+	case BitOp::And:
+		applyWords<BitOp::And>(dst, src, count);
+		break;
+	case BitOp::Or:
+		applyWords<BitOp::Or>(dst, src, count);
+		break;
+	case BitOp::Xor:
+		applyWords<BitOp::Xor>(dst, src, count);
+		break;
+	case BitOp::AndNot:
+		applyWords<BitOp::AndNot>(dst, src, count);
+		break;
+	}
+}
+
+DYNAMIC_BIT_ARRAY_POPCOUNT_CLONES
+inline size_t countWords(const uint64_t *words, size_t count) {
+	// Independent sums keep several popcounts in flight.
+	size_t sums[4] = {};
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		sums[0] += popcount(words[i]);
+		sums[1] += popcount(words[i + 1]);
+		sums[2] += popcount(words[i + 2]);
+		sums[3] += popcount(words[i + 3]);
+	}
+
+	for (; i < count; ++i) {
+		sums[0] += popcount(words[i]);
+	}
+
+	return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+} // namespace bit_array_detail
+
+// A packed array of bits in 64-bit words. The bits past the size in the last word are
+// always 0, so the word loops need no masking, and a bit of the array costs 1/8 byte.
+template <typename Allocator = std::allocator<uint64_t>>
+class DynamicBitArray {
+public:
+	using word_type = uint64_t;
+	using size_type = size_t;
+	using allocator_type = Allocator;
+
+	static const size_type npos = static_cast<size_type>(-1);
+	static const size_type bitsPerWord = 64;
+
+	// Refers to one bit, like the reference of std::vector<bool>.
+	class reference;
+
+public:
+	DynamicBitArray();
+	explicit DynamicBitArray(size_type size, bool value = false, const allocator_type &alloc = allocator_type());
+	DynamicBitArray(const DynamicBitArray &r) = default;
+	DynamicBitArray(DynamicBitArray &&r) noexcept;
+	~DynamicBitArray() = default;
+
+	DynamicBitArray& operator=(const DynamicBitArray &rhs) = default;
+	DynamicBitArray& operator=(DynamicBitArray &&rhs);
+
+public:
+	reference operator[](size_type pos);
+	bool operator[](size_type pos) const;
+
+	reference at(size_type pos);
+	bool at(size_type pos) const;
+
+	// The checked accessors of single bits.
+	bool test(size_type pos) const;
+	void set(size_type pos, bool value = true);
+	void reset(size_type pos);
+	void flip(size_type pos);
+
+	// Set, clear or flip all the bits.
+	DynamicBitArray& set();
+	DynamicBitArray& reset();
+	DynamicBitArray& flip();
+
+	void push_back(bool value);
+	void pop_back();
+
+	// The new bits get value, whole words are filled at once.
+	void resize(size_type size, bool value = false);
+
+	void reserve(size_type newCapacity);
+	void shrink_to_fit();
+	void clear();
+	void swap(DynamicBitArray &other);
+
+	bool empty() const;
+	size_type size() const;
+	size_type capacity() const;
+
+	// The number of the set bits.
+	size_type count() const;
+	bool all() const;
+	bool any() const;
+	bool none() const;
+
+	// The index of the first set bit, and of the first set bit after pos, or npos.
+	size_type find_first() const;
+	size_type find_next(size_type pos) const;
+
+	// The bulk operations need arrays of the same size.
+	DynamicBitArray& operator&=(const DynamicBitArray &rhs);
+	DynamicBitArray& operator|=(const DynamicBitArray &rhs);
+	DynamicBitArray& operator^=(const DynamicBitArray &rhs);
+
+	// Clears the bits, which are set in rhs: *this &= ~rhs.
+	DynamicBitArray& and_not(const DynamicBitArray &rhs);
+
+	DynamicBitArray operator&(const DynamicBitArray &rhs) const;
+	DynamicBitArray operator|(const DynamicBitArray &rhs) const;
+	DynamicBitArray operator^(const DynamicBitArray &rhs) const;
+	DynamicBitArray operator~() const;
+
+	bool operator==(const DynamicBitArray &rhs) const;
+	bool operator!=(const DynamicBitArray &rhs) const;
+
+	// The raw words, bit i is bit i % 64 of word i / 64.
+	const word_type* words() const;
+	size_type word_count() const;
+
+private:
+	static size_type wordCount(size_type bits);
+	static word_type bitMask(size_type pos);
+
+	void checkPosition(size_type pos) const;
+	DynamicBitArray& bitwise(bit_array_detail::BitOp op, const DynamicBitArray &rhs);
+	void clearUnusedBits();
+
+private:
+	DynamicArray<word_type, Allocator> m_words;
+	size_type m_size;
+};
+
+template <typename Allocator>
+const typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::npos;
+
+template <typename Allocator>
+const typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::bitsPerWord;
+
+template <typename Allocator>
+class DynamicBitArray<Allocator>::reference {
+	friend class DynamicBitArray<Allocator>;
+
+public:
+	reference& operator=(bool value);
+	reference& operator=(const reference &r);
+
+	operator bool() const;
+	bool operator~() const;
+
+	reference& flip();
+
+private:
+	reference(word_type *word, word_type mask);
+
+private:
+	word_type *m_word;
+	word_type m_mask;
+};
+
+/* --- DYNAMIC BIT ARRAY --- */
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>::DynamicBitArray()
+	: m_words()
+	, m_size(0) {
+
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>::DynamicBitArray(size_type size, bool value, const allocator_type &alloc)
+	: m_words(wordCount(size), alloc)
+	, m_size(0) {
+	resize(size, value);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>::DynamicBitArray(DynamicBitArray &&r) noexcept
+	: m_words(std::move(r.m_words))
+	, m_size(r.m_size) {
+	r.m_size = 0;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::operator=(DynamicBitArray &&rhs) {
+	if (this != &rhs) {
+		m_words = std::move(rhs.m_words);
+		m_size = rhs.m_size;
+
+		rhs.clear();
+	}
+
+	return *this;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::reference DynamicBitArray<Allocator>::operator[](size_type pos) {
+	return reference(&m_words[pos / bitsPerWord], bitMask(pos));
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::operator[](size_type pos) const {
+	return (m_words[pos / bitsPerWord] & bitMask(pos)) != 0;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::reference DynamicBitArray<Allocator>::at(size_type pos) {
+	checkPosition(pos);
+	return (*this)[pos];
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::at(size_type pos) const {
+	checkPosition(pos);
+	return (*this)[pos];
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::test(size_type pos) const {
+	return at(pos);
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::set(size_type pos, bool value) {
+	at(pos) = value;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::reset(size_type pos) {
+	at(pos) = false;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::flip(size_type pos) {
+	at(pos).flip();
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::set() {
+	std::fill(m_words.begin(), m_words.end(), ~word_type(0));
+	clearUnusedBits();
+
+	return *this;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::reset() {
+	std::fill(m_words.begin(), m_words.end(), word_type(0));
+	return *this;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::flip() {
+	for (word_type &word : m_words) {
+		word = ~word;
+	}
+
+	clearUnusedBits();
+
+	return *this;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::push_back(bool value) {
+	if (m_size % bitsPerWord == 0) {
+		m_words.push_back(0);
+	}
+
+	if (value) {
+		m_words.back() |= bitMask(m_size);
+	}
+
+	++m_size;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::pop_back() {
+	if (!m_size) {
+		throw std::logic_error("Empty array!");
+	}
+
+	--m_size;
+	if (m_size % bitsPerWord == 0) {
+		m_words.pop_back();
+	}
+	else {
+		m_words.back() &= ~bitMask(m_size);
+	}
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::resize(size_type size, bool value) {
+	const size_type words = wordCount(size);
+
+	if (size > m_size) {
+		// The rest of the last word, then whole words.
+		if (value && m_size % bitsPerWord) {
+			m_words.back() |= ~word_type(0) << (m_size % bitsPerWord);
+		}
+
+		m_words.insert(m_words.end(), words - m_words.size(), value ? ~word_type(0) : word_type(0));
+	}
+	else {
+		m_words.erase(m_words.begin() + static_cast<ptrdiff_t>(words), m_words.end());
+	}
+
+	m_size = size;
+	clearUnusedBits();
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::reserve(size_type newCapacity) {
+	m_words.reserve(wordCount(newCapacity));
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::shrink_to_fit() {
+	m_words.shrink_to_fit();
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::clear() {
+	m_words.clear();
+	m_size = 0;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::swap(DynamicBitArray &other) {
+	m_words.swap(other.m_words);
+	std::swap(m_size, other.m_size);
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::empty() const {
+	return m_size == 0;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::size() const {
+	return m_size;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::capacity() const {
+	return m_words.capacity() * bitsPerWord;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::count() const {
+	return bit_array_detail::countWords(m_words.data(), m_words.size());
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::all() const {
+	const size_type fullWords = m_size / bitsPerWord;
+	for (size_type i = 0; i < fullWords; ++i) {
+		if (m_words[i] != ~word_type(0)) {
+			return false;
+		}
+	}
+
+	return m_size % bitsPerWord == 0 || m_words.back() == bitMask(m_size) - 1;
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::any() const {
+	return find_first() != npos;
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::none() const {
+	return !any();
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::find_first() const {
+	for (size_type i = 0; i < m_words.size(); ++i) {
+		if (m_words[i]) {
+			return i * bitsPerWord + bit_array_detail::lowestBit(m_words[i]);
+		}
+	}
+
+	return npos;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::find_next(size_type pos) const {
+	if (pos == npos || pos + 1 >= m_size) {
+		return npos;
+	}
+
+	++pos;
+
+	// The bits before pos are masked out of its word, then whole words are skipped.
+	size_type i = pos / bitsPerWord;
+	word_type word = m_words[i] & (~word_type(0) << (pos % bitsPerWord));
+
+	while (!word) {
+		if (++i == m_words.size()) {
+			return npos;
+		}
+
+		word = m_words[i];
+	}
+
+	return i * bitsPerWord + bit_array_detail::lowestBit(word);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::operator&=(const DynamicBitArray &rhs) {
+	return bitwise(bit_array_detail::BitOp::And, rhs);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::operator|=(const DynamicBitArray &rhs) {
+	return bitwise(bit_array_detail::BitOp::Or, rhs);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::operator^=(const DynamicBitArray &rhs) {
+	return bitwise(bit_array_detail::BitOp::Xor, rhs);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::and_not(const DynamicBitArray &rhs) {
+	return bitwise(bit_array_detail::BitOp::AndNot, rhs);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator> DynamicBitArray<Allocator>::operator&(const DynamicBitArray &rhs) const {
+	DynamicBitArray result(*this);
+	result &= rhs;
+
+	return result;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator> DynamicBitArray<Allocator>::operator|(const DynamicBitArray &rhs) const {
+	DynamicBitArray result(*this);
+	result |= rhs;
+
+	return result;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator> DynamicBitArray<Allocator>::operator^(const DynamicBitArray &rhs) const {
+	DynamicBitArray result(*this);
+	result ^= rhs;
+
+	return result;
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator> DynamicBitArray<Allocator>::operator~() const {
+	DynamicBitArray result(*this);
+	result.flip();
+
+	return result;
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::operator==(const DynamicBitArray &rhs) const {
+	// The unused bits are 0 in both, so the words can be compared whole.
+	return m_size == rhs.m_size && std::equal(m_words.begin(), m_words.end(), rhs.m_words.begin());
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::operator!=(const DynamicBitArray &rhs) const {
+	return !(*this == rhs);
+}
+
+template <typename Allocator>
+inline const typename DynamicBitArray<Allocator>::word_type* DynamicBitArray<Allocator>::words() const {
+	return m_words.data();
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::word_count() const {
+	return m_words.size();
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::size_type DynamicBitArray<Allocator>::wordCount(size_type bits) {
+	return bits / bitsPerWord + (bits % bitsPerWord != 0);
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::word_type DynamicBitArray<Allocator>::bitMask(size_type pos) {
+	return word_type(1) << (pos % bitsPerWord);
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::checkPosition(size_type pos) const {
+	if (pos >= m_size) {
+		throw std::out_of_range("Invalid position!");
+	}
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>& DynamicBitArray<Allocator>::bitwise(bit_array_detail::BitOp op, const DynamicBitArray &rhs) {
+	if (m_size != rhs.m_size) {
+		throw std::logic_error("Different sizes!");
+	}
+
+	// None of the operations sets the unused bits, which are 0 in both.
+	bit_array_detail::bitwiseWords(op, m_words.data(), rhs.m_words.data(), m_words.size());
+
+	return *this;
+}
+
+template <typename Allocator>
+inline void DynamicBitArray<Allocator>::clearUnusedBits() {
+	if (m_size % bitsPerWord) {
+		m_words.back() &= bitMask(m_size) - 1;
+	}
+}
+
+/* --- REFERENCE --- */
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>::reference::reference(word_type *word, word_type mask)
+	: m_word(word)
+	, m_mask(mask) {
+
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::reference& DynamicBitArray<Allocator>::reference::operator=(bool value) {
+	if (value) {
+		*m_word |= m_mask;
+	}
+	else {
+		*m_word &= ~m_mask;
+	}
+
+	return *this;
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::reference& DynamicBitArray<Allocator>::reference::operator=(const reference &r) {
+	return *this = static_cast<bool>(r);
+}
+
+template <typename Allocator>
+inline DynamicBitArray<Allocator>::reference::operator bool() const {
+	return (*m_word & m_mask) != 0;
+}
+
+template <typename Allocator>
+inline bool DynamicBitArray<Allocator>::reference::operator~() const {
+	return !static_cast<bool>(*this);
+}
+
+template <typename Allocator>
+inline typename DynamicBitArray<Allocator>::reference& DynamicBitArray<Allocator>::reference::flip() {
+	*m_word ^= m_mask;
+	return *this;
+}
+
+#endif // !DYNAMIC_BIT_ARRAY_HEADER
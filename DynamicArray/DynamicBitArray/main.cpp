@@ -0,0 +1,247 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <random>
+#include <stdexcept>
+
+#include "DynamicBitArray.h"
+#include "../DynamicArray/ReallocAllocator.h"
+
+template <typename Bits>
+bool equals(const Bits &bits, const std::vector<bool> &expected) {
+	if (bits.size() != expected.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < expected.size(); ++i) {
+		if (bits[i] != expected[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <typename Bits>
+std::vector<bool> toVector(const Bits &bits) {
+	std::vector<bool> result;
+	for (size_t i = 0; i < bits.size(); ++i) {
+		result.push_back(bits[i]);
+	}
+
+	return result;
+}
+
+void testBasics() {
+	DynamicBitArray<> bits;
+	assert(bits.empty() && bits.none() && bits.all() && bits.count() == 0);
+	assert(bits.find_first() == DynamicBitArray<>::npos);
+
+	for (int i = 0; i < 130; ++i) {
+		bits.push_back(i % 3 == 0);
+	}
+
+	assert(bits.size() == 130 && bits.word_count() == 3);
+	assert(bits.count() == 44);
+	assert(bits[129] && !bits[128]);
+
+	// The proxy reference.
+	bits[1] = true;
+	bits[0] = bits[2];
+	assert(bits[1] && !bits[0]);
+	bits[1].flip();
+	assert(!bits[1] && ~bits[1]);
+
+	DynamicBitArray<>::reference ref = bits[5];
+	ref = true;
+	assert(bits.test(5));
+
+	bits.set(7);
+	bits.reset(3);
+	bits.flip(8);
+	assert(bits.test(7) && !bits.test(3) && bits.test(8));
+
+	bool thrown = false;
+	try {
+		bits.at(130);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	while (!bits.empty()) {
+		bits.pop_back();
+	}
+	assert(bits.word_count() == 0);
+
+	thrown = false;
+	try {
+		bits.pop_back();
+	}
+	catch (const std::logic_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void testResize() {
+	DynamicBitArray<> bits(10, true);
+	assert(bits.count() == 10 && bits.all());
+
+	// Fills the rest of the word, then whole words.
+	bits.resize(200, true);
+	assert(bits.count() == 200 && bits.all() && bits.word_count() == 4);
+
+	bits.resize(300);
+	assert(bits.count() == 200 && !bits.all() && bits.find_next(199) == DynamicBitArray<>::npos);
+
+	// Shrinking clears the bits past the size, so growing again gives zeros.
+	bits.resize(70);
+	assert(bits.count() == 70 && bits.word_count() == 2);
+	bits.resize(128);
+	assert(bits.count() == 70);
+
+	bits.flip();
+	assert(bits.count() == 58 && bits.find_first() == 70);
+
+	bits.set();
+	assert(bits.all() && bits.count() == 128);
+	bits.reset();
+	assert(bits.none());
+
+	bits.resize(0, true);
+	assert(bits.empty() && bits.word_count() == 0);
+}
+
+void testFind() {
+	DynamicBitArray<> bits(1000);
+	const size_t positions[] = { 0, 1, 63, 64, 65, 127, 500, 999 };
+	for (size_t pos : positions) {
+		bits[pos] = true;
+	}
+
+	size_t index = 0;
+	for (size_t pos = bits.find_first(); pos != DynamicBitArray<>::npos; pos = bits.find_next(pos)) {
+		assert(pos == positions[index++]);
+	}
+	assert(index == 8);
+	assert(bits.find_next(999) == DynamicBitArray<>::npos);
+	assert(bits.find_next(DynamicBitArray<>::npos) == DynamicBitArray<>::npos);
+}
+
+// Random operations against std::vector<bool>.
+template <typename Allocator>
+void testRandom() {
+	std::mt19937 random(42);
+
+	for (size_t size : { size_t(0), size_t(1), size_t(63), size_t(64), size_t(65), size_t(255), size_t(1000), size_t(4099) }) {
+		DynamicBitArray<Allocator> a(size), b(size);
+		std::vector<bool> va(size), vb(size);
+
+		for (size_t i = 0; i < size; ++i) {
+			va[i] = random() % 2;
+			vb[i] = random() % 3 == 0;
+			a[i] = va[i];
+			b[i] = vb[i];
+		}
+
+		size_t expectedCount = 0;
+		for (bool bit : va) {
+			expectedCount += bit;
+		}
+		assert(a.count() == expectedCount);
+
+		std::vector<bool> expected(size);
+
+		for (size_t i = 0; i < size; ++i) {
+			expected[i] = va[i] && vb[i];
+		}
+		assert(equals(a & b, expected));
+
+		for (size_t i = 0; i < size; ++i) {
+			expected[i] = va[i] || vb[i];
+		}
+		assert(equals(a | b, expected));
+
+		for (size_t i = 0; i < size; ++i) {
+			expected[i] = va[i] != vb[i];
+		}
+		assert(equals(a ^ b, expected));
+
+		for (size_t i = 0; i < size; ++i) {
+			expected[i] = !va[i];
+		}
+		assert(equals(~a, expected));
+		assert((~a).count() == size - expectedCount);
+
+		DynamicBitArray<Allocator> c(a);
+		c.and_not(b);
+		for (size_t i = 0; i < size; ++i) {
+			expected[i] = va[i] && !vb[i];
+		}
+		assert(equals(c, expected));
+
+		// The same array on both sides.
+		c = a;
+		c &= c;
+		assert(c == a);
+		c ^= c;
+		assert(c.none() && (size == 0 || c != a || a.none()));
+	}
+
+	DynamicBitArray<Allocator> a(10), b(11);
+	bool thrown = false;
+	try {
+		a |= b;
+	}
+	catch (const std::logic_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void testCopyMove() {
+	DynamicBitArray<> a(100, true);
+	DynamicBitArray<> b(a);
+	assert(a == b);
+
+	DynamicBitArray<> c(std::move(b));
+	assert(c == a && b.empty() && b.word_count() == 0);
+
+	b = std::move(c);
+	assert(b == a && c.empty());
+
+	c.push_back(true);
+	assert(c.size() == 1 && c.count() == 1);
+
+	b.swap(c);
+	assert(b.size() == 1 && c == a);
+
+	// The copies and the results of the operators take only the words they need.
+	DynamicBitArray<> full(128, true);
+	DynamicBitArray<> fullCopy(full);
+	assert(full.capacity() == 128 && fullCopy.capacity() == 128);
+	assert((full & fullCopy).capacity() == 128 && (~full).capacity() == 128);
+}
+
+int main() {
+	DynamicBitArray<> bits;
+	for (int i = 0; i < 10; ++i) {
+		bits.push_back(i % 2);
+	}
+
+	for (size_t i = 0; i < bits.size(); ++i) {
+		std::cout << bits[i];
+	}
+	std::cout << ' ' << bits.count() << '\n';
+
+	testBasics();
+	testResize();
+	testFind();
+	testRandom<std::allocator<uint64_t>>();
+	testRandom<ReallocAllocator<uint64_t>>();
+	testCopyMove();
+
+	return 0;
+}
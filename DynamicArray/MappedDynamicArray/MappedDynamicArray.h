@@ -0,0 +1,490 @@
+#pragma once
+#ifndef MAPPED_DYNAMIC_ARRAY_CLASS_HEADER
+#define MAPPED_DYNAMIC_ARRAY_CLASS_HEADER
+
+#include <string>
+#include <cerrno>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+enum class MapMode {
+	ReadOnly,
+	ReadWrite
+};
+
+// DynamicArray, whose storage is a shared mapping of a file with raw records of T.
+// Opening maps the file without reading it, the pages are loaded on first access and
+// shared with the other processes through the page cache.
+//
+// While the array is open for writing, the file is extended to the capacity with
+// ftruncate(). It is cut back to the size by close() and the destructor, so after a
+// crash the file might end with zero records.
+//
+// A trailing partial record is not a part of the array. It stays in the file, unless
+// the array grows over it or records are removed, which cut the file to the size.
+template <typename T>
+class MappedDynamicArray {
+	static_assert(std::is_trivially_copyable<T>::value, "The records are stored as raw bytes.");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+public:
+	// Opens the file, or creates it in the read-write mode. A trailing partial record is skipped.
+	MappedDynamicArray(const std::string &path, MapMode mode = MapMode::ReadWrite);
+	MappedDynamicArray(MappedDynamicArray &&r) noexcept;
+	MappedDynamicArray& operator=(MappedDynamicArray &&rhs) noexcept;
+	~MappedDynamicArray();
+
+	MappedDynamicArray(const MappedDynamicArray&) = delete;
+	MappedDynamicArray& operator=(const MappedDynamicArray&) = delete;
+
+public:
+	// In the read-only mode the mapping is not writable, the records must not be modified
+	// through the non-const accessors. The functions, which change the size, throw.
+	reference at(size_type pos);
+	const_reference at(size_type pos) const;
+
+	reference front();
+	const_reference front() const;
+
+	reference back();
+	const_reference back() const;
+
+	reference operator[](size_type pos);
+	const_reference operator[](size_type pos) const;
+
+	pointer data();
+	const_pointer data() const;
+
+	void pop_back();
+	void push_back(const_reference value);
+
+	// Grows the file and the mapping to hold at least newCapacity records.
+	void reserve(size_type newCapacity);
+
+	bool empty() const;
+	size_type size() const;
+	size_type capacity() const;
+
+	bool is_open() const;
+	bool is_read_only() const;
+
+	void clear();
+
+	// Writes the dirty pages back to the file and waits for it.
+	void sync();
+
+	// Cuts the file to the size and unmaps it, the partial record is kept while the array covers
+	// the records before it. Called by the destructor, which ignores the errors.
+	void close();
+
+private:
+	void checkWritable() const;
+
+	// Maps the first newCapacity records of the file, which has to be long enough.
+	void remap(size_type newCapacity);
+
+	static size_type pageSize();
+	[[noreturn]] static void throwError(const char *what);
+
+private:
+	int m_fd;
+	MapMode m_mode;
+	value_type *m_data;
+	size_type m_size;
+	size_type m_capacity;
+
+	// The bytes of the partial record after the capacity, until the file is extended over it.
+	size_type m_tailBytes;
+};
+
+template <typename T>
+inline MappedDynamicArray<T>::MappedDynamicArray(const std::string &path, MapMode mode)
+	: m_fd(-1)
+	, m_mode(mode)
+	, m_data(nullptr)
+	, m_size(0)
+	, m_capacity(0)
+	, m_tailBytes(0) {
+	const int flags = mode == MapMode::ReadOnly ? O_RDONLY : O_RDWR | O_CREAT;
+
+	m_fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+	if (m_fd < 0) {
+		throwError("open");
+	}
+
+	struct stat st;
+	if (fstat(m_fd, &st) != 0) {
+		const int error = errno;
+		::close(m_fd);
+		throw std::system_error(error, std::generic_category(), "fstat");
+	}
+
+	const size_type records = static_cast<size_type>(st.st_size) / sizeof(value_type);
+
+	try {
+		remap(records);
+	}
+	catch (...) {
+		::close(m_fd);
+		throw;
+	}
+
+	m_size = records;
+	m_tailBytes = static_cast<size_type>(st.st_size) % sizeof(value_type);
+}
+
+template <typename T>
+inline MappedDynamicArray<T>::MappedDynamicArray(MappedDynamicArray<T> &&r) noexcept
+	: m_fd(r.m_fd)
+	, m_mode(r.m_mode)
+	, m_data(r.m_data)
+	, m_size(r.m_size)
+	, m_capacity(r.m_capacity)
+	, m_tailBytes(r.m_tailBytes) {
+	r.m_fd = -1;
+	r.m_data = nullptr;
+	r.m_size = 0;
+	r.m_capacity = 0;
+	r.m_tailBytes = 0;
+}
+
+template <typename T>
+inline MappedDynamicArray<T>& MappedDynamicArray<T>::operator=(MappedDynamicArray<T> &&rhs) noexcept {
+	if (this != &rhs) {
+		try {
+			close();
+		}
+		catch (...) {
+		}
+
+		std::swap(m_fd, rhs.m_fd);
+		std::swap(m_mode, rhs.m_mode);
+		std::swap(m_data, rhs.m_data);
+		std::swap(m_size, rhs.m_size);
+		std::swap(m_capacity, rhs.m_capacity);
+		std::swap(m_tailBytes, rhs.m_tailBytes);
+	}
+
+	return *this;
+}
+
+template <typename T>
+inline MappedDynamicArray<T>::~MappedDynamicArray() {
+	try {
+		close();
+	}
+	catch (...) {
+	}
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::reference MappedDynamicArray<T>::at(size_type pos) {
+	return const_cast<reference>(static_cast<const MappedDynamicArray<T>&>(*this).at(pos));
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_reference MappedDynamicArray<T>::at(size_type pos) const {
+	if (pos >= m_size) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return m_data[pos];
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::reference MappedDynamicArray<T>::front() {
+	return const_cast<reference>(static_cast<const MappedDynamicArray<T>&>(*this).front());
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_reference MappedDynamicArray<T>::front() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return m_data[0];
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::reference MappedDynamicArray<T>::back() {
+	return const_cast<reference>(static_cast<const MappedDynamicArray<T>&>(*this).back());
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_reference MappedDynamicArray<T>::back() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return m_data[m_size - 1];
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::reference MappedDynamicArray<T>::operator[](size_type pos) {
+	return m_data[pos];
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_reference MappedDynamicArray<T>::operator[](size_type pos) const {
+	return m_data[pos];
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::pointer MappedDynamicArray<T>::data() {
+	return m_data;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_pointer MappedDynamicArray<T>::data() const {
+	return m_data;
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::pop_back() {
+	checkWritable();
+
+	if (!empty()) {
+		--m_size;
+	}
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::push_back(const_reference value) {
+	checkWritable();
+
+	if (m_size == m_capacity) {
+		// The value might be a record of the array, which moves with the mapping.
+		const value_type tmp(value);
+		reserve(m_size + 1);
+		m_data[m_size] = tmp;
+	}
+	else {
+		m_data[m_size] = value;
+	}
+
+	++m_size;
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::reserve(size_type newCapacity) {
+	checkWritable();
+
+	if (newCapacity <= m_capacity) {
+		return;
+	}
+
+	// Doubles, but never maps less than a page.
+	const size_type minCapacity = pageSize() / sizeof(value_type) + 1;
+	size_type resultCapacity = m_capacity * 2;
+
+	if (resultCapacity < minCapacity) {
+		resultCapacity = minCapacity;
+	}
+
+	if (resultCapacity < newCapacity) {
+		resultCapacity = newCapacity;
+	}
+
+	if (ftruncate(m_fd, static_cast<off_t>(resultCapacity * sizeof(value_type))) != 0) {
+		throwError("ftruncate");
+	}
+
+	try {
+		remap(resultCapacity);
+	}
+	catch (...) {
+		// The file goes back to its old length, so it does not keep the zero records.
+		// If that fails too, close() still cuts it to the size.
+		const int result = ftruncate(m_fd, static_cast<off_t>(m_capacity * sizeof(value_type) + m_tailBytes));
+		(void)result;
+
+		throw;
+	}
+
+	// The partial record is in the new capacity now, the records overwrite or cut it.
+	m_tailBytes = 0;
+}
+
+template <typename T>
+inline bool MappedDynamicArray<T>::empty() const {
+	return !size();
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::size_type MappedDynamicArray<T>::size() const {
+	return m_size;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::size_type MappedDynamicArray<T>::capacity() const {
+	return m_capacity;
+}
+
+template <typename T>
+inline bool MappedDynamicArray<T>::is_open() const {
+	return m_fd >= 0;
+}
+
+template <typename T>
+inline bool MappedDynamicArray<T>::is_read_only() const {
+	return m_mode == MapMode::ReadOnly;
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::clear() {
+	checkWritable();
+	m_size = 0;
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::sync() {
+	if (m_data && m_mode == MapMode::ReadWrite && msync(m_data, m_capacity * sizeof(value_type), MS_SYNC) != 0) {
+		throwError("msync");
+	}
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::close() {
+	if (!is_open()) {
+		return;
+	}
+
+	if (m_data) {
+		munmap(m_data, m_capacity * sizeof(value_type));
+		m_data = nullptr;
+	}
+
+	const int fd = m_fd;
+	// Even if the size is the capacity, a failed reserve() might have left the file longer.
+	// With a partial record the file was never extended, so it is only cut, if records were removed.
+	const bool truncate = m_mode == MapMode::ReadWrite && (!m_tailBytes || m_size < m_capacity);
+	const off_t bytes = static_cast<off_t>(m_size * sizeof(value_type));
+
+	m_fd = -1;
+	m_size = 0;
+	m_capacity = 0;
+	m_tailBytes = 0;
+
+	const bool truncated = !truncate || ftruncate(fd, bytes) == 0;
+	const int error = errno;
+	::close(fd);
+
+	if (!truncated) {
+		throw std::system_error(error, std::generic_category(), "ftruncate");
+	}
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::checkWritable() const {
+	if (!is_open()) {
+		throw std::logic_error("Closed array!");
+	}
+
+	if (m_mode == MapMode::ReadOnly) {
+		throw std::logic_error("Read-only array!");
+	}
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::remap(size_type newCapacity) {
+	const size_type oldBytes = m_capacity * sizeof(value_type);
+	const size_type newBytes = newCapacity * sizeof(value_type);
+
+	if (!newBytes) {
+		return;
+	}
+
+	void *result = MAP_FAILED;
+
+#if defined(__linux__)
+	if (m_data) {
+		// The kernel moves the page tables, the pages themselves stay in the page cache.
+		result = mremap(m_data, oldBytes, newBytes, MREMAP_MAYMOVE);
+	}
+	else
+#endif
+	{
+		const int prot = m_mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+		result = mmap(nullptr, newBytes, prot, MAP_SHARED, m_fd, 0);
+
+		if (result != MAP_FAILED && m_data) {
+			munmap(m_data, oldBytes);
+		}
+	}
+
+	if (result == MAP_FAILED) {
+		throwError("mmap");
+	}
+
+	m_data = static_cast<value_type*>(result);
+	m_capacity = newCapacity;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::size_type MappedDynamicArray<T>::pageSize() {
+	static const size_type size = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+template <typename T>
+inline void MappedDynamicArray<T>::throwError(const char *what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::iterator MappedDynamicArray<T>::begin() {
+	return m_data;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::iterator MappedDynamicArray<T>::end() {
+	return m_data + m_size;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_iterator MappedDynamicArray<T>::begin() const {
+	return m_data;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_iterator MappedDynamicArray<T>::end() const {
+	return m_data + m_size;
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_iterator MappedDynamicArray<T>::cbegin() const {
+	return begin();
+}
+
+template <typename T>
+inline typename MappedDynamicArray<T>::const_iterator MappedDynamicArray<T>::cend() const {
+	return end();
+}
+
+#endif // !MAPPED_DYNAMIC_ARRAY_CLASS_HEADER
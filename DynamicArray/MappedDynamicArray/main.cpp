@@ -0,0 +1,230 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include "MappedDynamicArray.h"
+
+struct Record {
+	int id;
+	double value;
+};
+
+static long fileSize(const std::string &path) {
+	FILE *file = std::fopen(path.c_str(), "rb");
+	std::fseek(file, 0, SEEK_END);
+	const long size = std::ftell(file);
+	std::fclose(file);
+
+	return size;
+}
+
+void testReadWrite(const std::string &path) {
+	{
+		MappedDynamicArray<Record> records(path);
+		assert(records.empty() && !records.is_read_only());
+
+		for (int i = 0; i < 10000; ++i) {
+			records.push_back(Record{ i, i * 0.5 });
+		}
+
+		// The argument refers to a record, which moves with the mapping.
+		while (records.size() != records.capacity()) {
+			records.push_back(Record{ -1, 0.0 });
+		}
+
+		records.push_back(records[1]);
+		assert(records.back().id == 1);
+
+		records.pop_back();
+		records.sync();
+	}
+
+	// The file is cut back to the records.
+	assert(fileSize(path) % sizeof(Record) == 0);
+
+	MappedDynamicArray<Record> records(path);
+	assert(records.size() == static_cast<size_t>(fileSize(path)) / sizeof(Record));
+	assert(records[9999].id == 9999 && records[9999].value == 9999 * 0.5);
+
+	while (records.size() > 100) {
+		records.pop_back();
+	}
+
+	records.close();
+	assert(!records.is_open());
+	assert(fileSize(path) == 100 * sizeof(Record));
+}
+
+void testFailedReserve(const std::string &path) {
+	MappedDynamicArray<Record> records(path);
+	for (int i = 0; i < 1000; ++i) {
+		records.push_back(Record{ i, 0.0 });
+	}
+
+	const size_t capacity = records.capacity();
+	const long size = fileSize(path);
+
+	// More than the address space: either the file cannot grow or the mapping fails.
+	bool thrown = false;
+	try {
+		records.reserve((size_t(1) << 50) / sizeof(Record));
+	}
+	catch (const std::system_error&) {
+		thrown = true;
+	}
+
+	assert(thrown);
+	assert(records.capacity() == capacity && fileSize(path) == size);
+	assert(records[999].id == 999);
+
+	records.push_back(Record{ 1000, 0.0 });
+	records.close();
+	assert(fileSize(path) == 1001 * sizeof(Record));
+}
+
+// Writes count plain records of int and the first bytes of one more.
+static void writeWithTail(const std::string &path, int count, size_t tailBytes) {
+	FILE *file = std::fopen(path.c_str(), "wb");
+	for (int i = 0; i < count; ++i) {
+		std::fwrite(&i, sizeof(i), 1, file);
+	}
+
+	const char tail[sizeof(int)] = { 'a', 'b', 'c' };
+	std::fwrite(tail, 1, tailBytes, file);
+	std::fclose(file);
+}
+
+void testPartialRecord(const std::string &path) {
+	const long length = 10 * sizeof(int) + 3;
+
+	// Opening and closing for writing keeps the partial record, so does a failed reserve().
+	writeWithTail(path, 10, 3);
+	{
+		MappedDynamicArray<int> numbers(path);
+		assert(numbers.size() == 10 && numbers[9] == 9);
+
+		bool thrown = false;
+		try {
+			numbers.reserve((size_t(1) << 50) / sizeof(int));
+		}
+		catch (const std::system_error&) {
+			thrown = true;
+		}
+
+		assert(thrown && fileSize(path) == length);
+	}
+	assert(fileSize(path) == length);
+
+	char tail[3] = {};
+	FILE *file = std::fopen(path.c_str(), "rb");
+	std::fseek(file, 10 * sizeof(int), SEEK_SET);
+	assert(std::fread(tail, 1, 3, file) == 3 && tail[0] == 'a' && tail[2] == 'c');
+	std::fclose(file);
+
+	// Growing overwrites it with the new record.
+	{
+		MappedDynamicArray<int> numbers(path);
+		numbers.push_back(10);
+	}
+	assert(fileSize(path) == 11 * sizeof(int));
+
+	// Removing records cuts it off with them.
+	writeWithTail(path, 10, 3);
+	{
+		MappedDynamicArray<int> numbers(path);
+		numbers.pop_back();
+	}
+	assert(fileSize(path) == 9 * sizeof(int));
+
+	// A file with the partial record only.
+	writeWithTail(path, 0, 2);
+	{
+		MappedDynamicArray<int> numbers(path);
+		assert(numbers.empty() && numbers.capacity() == 0);
+	}
+	assert(fileSize(path) == 2);
+}
+
+void testReadOnly(const std::string &path) {
+	// A file with plain records, written without the array.
+	FILE *file = std::fopen(path.c_str(), "wb");
+	for (int i = 0; i < 1000; ++i) {
+		std::fwrite(&i, sizeof(i), 1, file);
+	}
+
+	std::fclose(file);
+
+	MappedDynamicArray<int> numbers(path, MapMode::ReadOnly);
+	assert(numbers.is_read_only() && numbers.size() == 1000);
+
+	const MappedDynamicArray<int> &view = numbers;
+	long sum = 0;
+	for (int value : view) {
+		sum += value;
+	}
+
+	assert(sum == 999 * 1000 / 2);
+
+	MappedDynamicArray<int> moved(std::move(numbers));
+	assert(moved.size() == 1000 && !numbers.is_open());
+
+	bool thrown = false;
+	try {
+		moved.push_back(1);
+	}
+	catch (const std::logic_error&) {
+		thrown = true;
+	}
+
+	assert(thrown);
+	assert(fileSize(path) == 1000 * sizeof(int));
+
+	thrown = false;
+	try {
+		MappedDynamicArray<int> missing(path + ".missing", MapMode::ReadOnly);
+	}
+	catch (const std::system_error&) {
+		thrown = true;
+	}
+
+	assert(thrown);
+}
+
+int main() {
+	const std::string path = "/tmp/mapped_dynamic_array_" + std::to_string(getpid());
+
+	MappedDynamicArray<int> a(path);
+	for (int i = 0; i < 10; ++i) {
+		a.push_back(i);
+	}
+
+	std::cout << a.at(5) << "\n\n";
+
+	for (int value : a) {
+		std::cout << value << '\n';
+	}
+
+	a.close();
+	std::remove(path.c_str());
+
+	testReadWrite(path);
+	std::remove(path.c_str());
+
+	// On tmpfs the file grows, so it is the mapping, which fails.
+	const std::string shmPath = "/dev/shm/mapped_dynamic_array_" + std::to_string(getpid());
+	const std::string &reservePath = access("/dev/shm", W_OK) == 0 ? shmPath : path;
+
+	testFailedReserve(reservePath);
+	std::remove(reservePath.c_str());
+
+	testPartialRecord(reservePath);
+	std::remove(reservePath.c_str());
+
+	testReadOnly(path);
+	std::remove(path.c_str());
+
+	return 0;
+}
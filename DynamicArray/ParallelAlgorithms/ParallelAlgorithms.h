@@ -0,0 +1,312 @@
+#pragma once
+#ifndef PARALLEL_ALGORITHMS_HEADER
+#define PARALLEL_ALGORITHMS_HEADER
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+#include "../../ThreadPool/WorkStealingThreadPool/ThreadPool.h"
+#include "../DynamicArray/DynamicArray.h"
+
+// Parallel versions of the standard algorithms over random access ranges, like the ones
+// of DynamicArray. The range is split into equal chunks, a few per worker of the pool, and
+// the idle workers steal the chunks of the busy ones, so there is no need to know about
+// the NUMA nodes or the speed of the cores. grainSize is the number of elements in a chunk,
+// 0 picks it from the number of workers. The algorithms wait for all their chunks and
+// rethrow the first exception of them.
+
+// Calls f(*it) for every element.
+template <typename RandomIt, typename F>
+void parallel_for_each(ThreadPool &pool, RandomIt first, RandomIt last, F f, size_t grainSize = 0);
+
+// Writes op(*it) to the output range and returns its end. The output may be the input.
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, UnaryOp op, size_t grainSize = 0);
+
+// Folds the elements into init with op, which has to be associative.
+// The order of the elements is kept, so op does not have to be commutative.
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<T>>
+T parallel_reduce(ThreadPool &pool, RandomIt first, RandomIt last, T init, BinaryOp op = BinaryOp(), size_t grainSize = 0);
+
+// The prefix sums with op, which has to be associative. The output may be the input.
+template <typename RandomIt, typename OutputIt, typename BinaryOp = std::plus<typename std::iterator_traits<RandomIt>::value_type>>
+OutputIt parallel_inclusive_scan(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, BinaryOp op = BinaryOp(), size_t grainSize = 0);
+
+template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp = std::plus<T>>
+OutputIt parallel_exclusive_scan(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, T init, BinaryOp op = BinaryOp(), size_t grainSize = 0);
+
+// A stable merge sort. The chunks are sorted in parallel, then merged in rounds, where
+// every merge is split further along its merge path, so the last rounds stay parallel too.
+template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+void parallel_sort(ThreadPool &pool, RandomIt first, RandomIt last, Compare comp = Compare(), size_t grainSize = 0);
+
+namespace parallel_detail {
+
+inline size_t chunkCount(const ThreadPool &pool, size_t length, size_t grainSize) {
+	if (!length) {
+		return 0;
+	}
+
+	// A few chunks per worker leave room for balancing the load by stealing.
+	const size_t chunks = grainSize ? (length + grainSize - 1) / grainSize : pool.size() * 4;
+	return std::min(std::max<size_t>(chunks, 1), length);
+}
+
+// The chunks differ by at most one element.
+inline size_t chunkBegin(size_t length, size_t chunks, size_t chunk) {
+	return static_cast<size_t>(static_cast<unsigned long long>(length) * chunk / chunks);
+}
+
+// Runs f(chunk, chunkFirst, chunkLast) for every chunk of [0, length).
+template <typename F>
+void forEachChunk(ThreadPool &pool, size_t length, size_t chunks, F f) {
+	pool.parallel_for(0, chunks, [&](size_t chunk) {
+		f(chunk, chunkBegin(length, chunks, chunk), chunkBegin(length, chunks, chunk + 1));
+	}, 1);
+}
+
+// The number of elements of a, which come before the d-th output of the stable merge of a and b.
+template <typename RandomIt, typename Compare>
+size_t mergePathSplit(RandomIt a, size_t aLength, RandomIt b, size_t bLength, size_t d, Compare &comp) {
+	size_t low = d > bLength ? d - bLength : 0;
+	size_t high = std::min(d, aLength);
+
+	while (low < high) {
+		const size_t i = low + (high - low) / 2;
+		const size_t j = d - i;
+
+		// On ties the elements of a go first, so a[i] belongs to the first d, if b[j - 1] is not less.
+		if (j > 0 && !comp(b[j - 1], a[i])) {
+			low = i + 1;
+		}
+		else {
+			high = i;
+		}
+	}
+
+	return low;
+}
+
+// Moves the outputs [dBegin, dEnd) of the stable merge of a and b to out + dBegin,
+// where iBegin and iEnd are the merge path splits of dBegin and dEnd.
+template <typename SrcIt, typename DstIt, typename Compare>
+void mergePiece(SrcIt a, SrcIt b, size_t dBegin, size_t dEnd, size_t iBegin, size_t iEnd, DstIt out, Compare &comp) {
+	std::merge(std::make_move_iterator(a + iBegin), std::make_move_iterator(a + iEnd),
+		std::make_move_iterator(b + (dBegin - iBegin)), std::make_move_iterator(b + (dEnd - iEnd)),
+		out + dBegin, comp);
+}
+
+} // namespace parallel_detail
+
+template <typename RandomIt, typename F>
+inline void parallel_for_each(ThreadPool &pool, RandomIt first, RandomIt last, F f, size_t grainSize) {
+	const size_t length = static_cast<size_t>(last - first);
+
+	parallel_detail::forEachChunk(pool, length, parallel_detail::chunkCount(pool, length, grainSize), [&](size_t, size_t begin, size_t end) {
+		std::for_each(first + begin, first + end, f);
+	});
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+inline OutputIt parallel_transform(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, UnaryOp op, size_t grainSize) {
+	const size_t length = static_cast<size_t>(last - first);
+
+	parallel_detail::forEachChunk(pool, length, parallel_detail::chunkCount(pool, length, grainSize), [&](size_t, size_t begin, size_t end) {
+		std::transform(first + begin, first + end, out + begin, op);
+	});
+
+	return out + length;
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+inline T parallel_reduce(ThreadPool &pool, RandomIt first, RandomIt last, T init, BinaryOp op, size_t grainSize) {
+	const size_t length = static_cast<size_t>(last - first);
+	const size_t chunks = parallel_detail::chunkCount(pool, length, grainSize);
+
+	// Every chunk starts from its first element, so op needs no identity.
+	std::vector<T> partials(chunks, init);
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t chunk, size_t begin, size_t end) {
+		T partial = first[begin];
+		for (size_t i = begin + 1; i < end; ++i) {
+			partial = op(std::move(partial), first[i]);
+		}
+
+		partials[chunk] = std::move(partial);
+	});
+
+	for (T &partial : partials) {
+		init = op(std::move(init), std::move(partial));
+	}
+
+	return init;
+}
+
+template <typename RandomIt, typename OutputIt, typename BinaryOp>
+inline OutputIt parallel_inclusive_scan(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, BinaryOp op, size_t grainSize) {
+	using T = typename std::iterator_traits<RandomIt>::value_type;
+
+	const size_t length = static_cast<size_t>(last - first);
+	const size_t chunks = parallel_detail::chunkCount(pool, length, grainSize);
+	if (!chunks) {
+		return out;
+	}
+
+	// The totals of the chunks, then the total of everything before each chunk.
+	std::vector<T> totals;
+	totals.reserve(chunks);
+	for (size_t chunk = 0; chunk < chunks; ++chunk) {
+		totals.push_back(first[parallel_detail::chunkBegin(length, chunks, chunk)]);
+	}
+
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t chunk, size_t begin, size_t end) {
+		T &total = totals[chunk];
+		for (size_t i = begin + 1; i < end; ++i) {
+			total = op(std::move(total), first[i]);
+		}
+	});
+
+	for (size_t i = 1; i < chunks; ++i) {
+		totals[i] = op(totals[i - 1], std::move(totals[i]));
+	}
+
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t chunk, size_t begin, size_t end) {
+		T sum = chunk ? op(totals[chunk - 1], first[begin]) : T(first[begin]);
+		for (size_t i = begin + 1; i < end; ++i) {
+			// The input is read before the output is written, so they may be the same.
+			T next = op(sum, first[i]);
+			out[i - 1] = std::move(sum);
+			sum = std::move(next);
+		}
+
+		out[end - 1] = std::move(sum);
+	});
+
+	return out + length;
+}
+
+template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp>
+inline OutputIt parallel_exclusive_scan(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt out, T init, BinaryOp op, size_t grainSize) {
+	const size_t length = static_cast<size_t>(last - first);
+	const size_t chunks = parallel_detail::chunkCount(pool, length, grainSize);
+	if (!chunks) {
+		return out;
+	}
+
+	std::vector<T> totals(chunks, init);
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t chunk, size_t begin, size_t end) {
+		T total = first[begin];
+		for (size_t i = begin + 1; i < end; ++i) {
+			total = op(std::move(total), first[i]);
+		}
+
+		totals[chunk] = std::move(total);
+	});
+
+	// Shift the totals, so every chunk gets the sum of init and the chunks before it.
+	T sum = init;
+	for (T &total : totals) {
+		T next = op(sum, std::move(total));
+		total = std::move(sum);
+		sum = std::move(next);
+	}
+
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t chunk, size_t begin, size_t end) {
+		T prefix = totals[chunk];
+		for (size_t i = begin; i < end; ++i) {
+			T next = op(prefix, first[i]);
+			out[i] = std::move(prefix);
+			prefix = std::move(next);
+		}
+	});
+
+	return out + length;
+}
+
+template <typename RandomIt, typename Compare>
+inline void parallel_sort(ThreadPool &pool, RandomIt first, RandomIt last, Compare comp, size_t grainSize) {
+	using T = typename std::iterator_traits<RandomIt>::value_type;
+
+	const size_t length = static_cast<size_t>(last - first);
+	size_t runs = parallel_detail::chunkCount(pool, length, grainSize);
+	if (runs < 2) {
+		std::stable_sort(first, last, comp);
+		return;
+	}
+
+	// The tasks of one merge round, the merges are split along their merge paths to get them.
+	const size_t tasks = pool.size() * 4;
+
+	const size_t chunks = runs;
+	parallel_detail::forEachChunk(pool, length, chunks, [&](size_t, size_t begin, size_t end) {
+		std::stable_sort(first + begin, first + end, comp);
+	});
+
+	std::vector<T> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+
+	// Every round merges pairs of neighbouring runs from src into dst and halves their count.
+	// The run boundaries are the chunk boundaries, which are recomputed from the run index.
+	size_t runChunks = 1;
+	bool inBuffer = true;
+
+	for (; runs > 1; runs = (runs + 1) / 2, runChunks *= 2, inBuffer = !inBuffer) {
+		const size_t pairs = (runs + 1) / 2;
+		const size_t pieces = std::max<size_t>(1, tasks / pairs);
+
+		// The run of a pair, and the output range of a piece of its merge.
+		struct Piece {
+			size_t aBegin, bBegin, bEnd;
+			size_t dBegin, dEnd;
+		};
+
+		const auto piece = [&](size_t task) {
+			const size_t pair = task / pieces;
+			const size_t index = task % pieces;
+
+			Piece result;
+			result.aBegin = parallel_detail::chunkBegin(length, chunks, std::min(chunks, pair * 2 * runChunks));
+			result.bBegin = parallel_detail::chunkBegin(length, chunks, std::min(chunks, (pair * 2 + 1) * runChunks));
+			result.bEnd = parallel_detail::chunkBegin(length, chunks, std::min(chunks, (pair * 2 + 2) * runChunks));
+
+			const size_t total = result.bEnd - result.aBegin;
+			result.dBegin = total * index / pieces;
+			result.dEnd = total * (index + 1) / pieces;
+
+			return result;
+		};
+
+		// All the splits are searched before any element is moved, as the pieces of a merge
+		// read each other's elements while searching.
+		std::vector<size_t> splits(pairs * pieces);
+		pool.parallel_for(0, pairs * pieces, [&](size_t task) {
+			const Piece p = piece(task);
+			if (inBuffer) {
+				splits[task] = parallel_detail::mergePathSplit(buffer.begin() + p.aBegin, p.bBegin - p.aBegin, buffer.begin() + p.bBegin, p.bEnd - p.bBegin, p.dBegin, comp);
+			}
+			else {
+				splits[task] = parallel_detail::mergePathSplit(first + p.aBegin, p.bBegin - p.aBegin, first + p.bBegin, p.bEnd - p.bBegin, p.dBegin, comp);
+			}
+		}, 1);
+
+		pool.parallel_for(0, pairs * pieces, [&](size_t task) {
+			const Piece p = piece(task);
+
+			// The last piece of a merge ends with all of a.
+			const size_t iEnd = (task + 1) % pieces ? splits[task + 1] : p.bBegin - p.aBegin;
+			if (inBuffer) {
+				parallel_detail::mergePiece(buffer.begin() + p.aBegin, buffer.begin() + p.bBegin, p.dBegin, p.dEnd, splits[task], iEnd, first + p.aBegin, comp);
+			}
+			else {
+				parallel_detail::mergePiece(first + p.aBegin, first + p.bBegin, p.dBegin, p.dEnd, splits[task], iEnd, buffer.begin() + p.aBegin, comp);
+			}
+		}, 1);
+	}
+
+	// The last round wrote into the buffer.
+	if (inBuffer) {
+		parallel_transform(pool, buffer.begin(), buffer.end(), first, [](T &value) { return std::move(value); });
+	}
+}
+
+#endif // !PARALLEL_ALGORITHMS_HEADER
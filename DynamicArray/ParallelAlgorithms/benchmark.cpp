@@ -0,0 +1,79 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+
+#include "ParallelAlgorithms.h"
+
+// The sequential std algorithms against the parallel ones with 1, 2, 4, ... workers,
+// on argv[1] million elements (10 by default).
+
+DynamicArray<double> makeNumbers(size_t count) {
+	DynamicArray<double> numbers(count);
+	for (size_t i = 0; i < count; ++i) {
+		numbers.push_back(static_cast<double>((i * 2654435761u) % 1000003));
+	}
+
+	return numbers;
+}
+
+template <typename F>
+double measure(F f) {
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void report(const char *name, double sequential, double parallel) {
+	std::cout << "  " << name << parallel << " ms (x" << sequential / parallel << ")\n";
+}
+
+int main(int argc, char *argv[]) {
+	const size_t count = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10) * 1000000;
+	const DynamicArray<double> input = makeNumbers(count);
+
+	// Keeps the results alive, so the work is not optimized away.
+	double checksum = 0;
+
+	DynamicArray<double> numbers = input;
+	const double transformTime = measure([&] { std::transform(numbers.begin(), numbers.end(), numbers.begin(), [](double x) { return x * 1.5 + 1; }); });
+	const double reduceTime = measure([&] { checksum += std::accumulate(numbers.begin(), numbers.end(), 0.0); });
+	const double scanTime = measure([&] { std::partial_sum(numbers.begin(), numbers.end(), numbers.begin()); });
+
+	numbers = input;
+	const double sortTime = measure([&] { std::stable_sort(numbers.begin(), numbers.end()); });
+	checksum += numbers[count / 2];
+
+	std::cout << count << " elements, sequential:\n"
+		<< "  transform: " << transformTime << " ms\n"
+		<< "  reduce: " << reduceTime << " ms\n"
+		<< "  inclusive scan: " << scanTime << " ms\n"
+		<< "  stable sort: " << sortTime << " ms\n";
+
+	const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	for (size_t threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+		ThreadPool pool(threads);
+
+		numbers = input;
+		std::cout << threads << " workers:\n";
+		report("transform: ", transformTime, measure([&] { parallel_transform(pool, numbers.begin(), numbers.end(), numbers.begin(), [](double x) { return x * 1.5 + 1; }); }));
+		report("reduce: ", reduceTime, measure([&] { checksum += parallel_reduce(pool, numbers.begin(), numbers.end(), 0.0); }));
+		report("inclusive scan: ", scanTime, measure([&] { parallel_inclusive_scan(pool, numbers.begin(), numbers.end(), numbers.begin()); }));
+
+		numbers = input;
+		report("stable sort: ", sortTime, measure([&] { parallel_sort(pool, numbers.begin(), numbers.end()); }));
+		checksum += numbers[count / 2];
+
+		if (threads == maxThreads) {
+			break;
+		}
+	}
+
+	std::cout << "checksum: " << checksum << '\n';
+
+	return 0;
+}
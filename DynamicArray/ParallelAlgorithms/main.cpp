@@ -0,0 +1,119 @@
+#include <iostream>
+#include <cassert>
+#include <numeric>
+#include <string>
+#include <stdexcept>
+
+#include "ParallelAlgorithms.h"
+
+DynamicArray<int> makeNumbers(size_t count) {
+	DynamicArray<int> numbers(count);
+	for (size_t i = 0; i < count; ++i) {
+		numbers.push_back(static_cast<int>((i * 2654435761u) % 1000));
+	}
+
+	return numbers;
+}
+
+void testSizes(ThreadPool &pool) {
+	const size_t sizes[] = { 0, 1, 2, 7, 31, 1000, 20011 };
+	const size_t grains[] = { 0, 1, 100 };
+
+	for (size_t size : sizes) {
+		for (size_t grain : grains) {
+			DynamicArray<int> numbers = makeNumbers(size);
+
+			const long long expected = std::accumulate(numbers.begin(), numbers.end(), 0LL);
+			assert(parallel_reduce(pool, numbers.begin(), numbers.end(), 0LL, std::plus<long long>(), grain) == expected);
+
+			DynamicArray<int> scanned = makeNumbers(size);
+			parallel_inclusive_scan(pool, scanned.begin(), scanned.end(), scanned.begin(), std::plus<int>(), grain);
+
+			DynamicArray<int> exclusive = makeNumbers(size);
+			parallel_exclusive_scan(pool, exclusive.begin(), exclusive.end(), exclusive.begin(), 5, std::plus<int>(), grain);
+
+			int sum = 0;
+			for (size_t i = 0; i < size; ++i) {
+				assert(exclusive[i] == sum + 5);
+				sum += numbers[i];
+				assert(scanned[i] == sum);
+			}
+
+			parallel_transform(pool, numbers.begin(), numbers.end(), numbers.begin(), [](int value) { return value * 2; }, grain);
+			parallel_for_each(pool, numbers.begin(), numbers.end(), [](int &value) { value += 1; }, grain);
+			assert(parallel_reduce(pool, numbers.cbegin(), numbers.cend(), 0LL, std::plus<long long>(), grain) == expected * 2 + static_cast<long long>(size));
+
+			parallel_sort(pool, numbers.begin(), numbers.end(), std::less<int>(), grain);
+			assert(std::is_sorted(numbers.begin(), numbers.end()));
+		}
+	}
+}
+
+void testOrder(ThreadPool &pool) {
+	// A reduction, which is associative, but not commutative.
+	DynamicArray<std::string> letters;
+	for (int i = 0; i < 1000; ++i) {
+		letters.push_back(std::string(1, char('a' + i % 26)));
+	}
+
+	const std::string joined = parallel_reduce(pool, letters.begin(), letters.end(), std::string(">"));
+	assert(joined == std::accumulate(letters.begin(), letters.end(), std::string(">")));
+
+	// The sort is stable.
+	DynamicArray<std::pair<int, int>> pairs;
+	for (int i = 0; i < 100000; ++i) {
+		pairs.push_back(std::make_pair(i % 10, i));
+	}
+
+	parallel_sort(pool, pairs.begin(), pairs.end(), [](const std::pair<int, int> &l, const std::pair<int, int> &r) { return l.first < r.first; });
+	for (size_t i = 1; i < pairs.size(); ++i) {
+		assert(pairs[i - 1].first < pairs[i].first || (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+	}
+
+	// Move-only elements.
+	DynamicArray<std::unique_ptr<int>> ptrs;
+	for (int i = 0; i < 10000; ++i) {
+		ptrs.push_back(std::unique_ptr<int>(new int(10000 - i)));
+	}
+
+	parallel_sort(pool, ptrs.begin(), ptrs.end(), [](const std::unique_ptr<int> &l, const std::unique_ptr<int> &r) { return *l < *r; });
+	assert(*ptrs.front() == 1 && *ptrs.back() == 10000);
+}
+
+void testExceptions(ThreadPool &pool) {
+	DynamicArray<int> numbers = makeNumbers(10000);
+
+	bool thrown = false;
+	try {
+		parallel_for_each(pool, numbers.begin(), numbers.end(), [](int value) {
+			if (value == 999) {
+				throw std::runtime_error("999");
+			}
+		});
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+
+	assert(thrown);
+}
+
+int main() {
+	ThreadPool pool(4);
+
+	DynamicArray<int> a = makeNumbers(10);
+	parallel_sort(pool, a.begin(), a.end());
+
+	for (int value : a) {
+		std::cout << value << '\n';
+	}
+
+	testSizes(pool);
+	testOrder(pool);
+	testExceptions(pool);
+
+	ThreadPool single(1);
+	testSizes(single);
+
+	return 0;
+}
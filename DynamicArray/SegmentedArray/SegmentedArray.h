@@ -0,0 +1,690 @@
+#pragma once
+#ifndef SEGMENTED_ARRAY_HEADER
+#define SEGMENTED_ARRAY_HEADER
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+namespace segmented_array_detail {
+
+// The index of the highest set bit, the value must not be 0.
+inline size_t highestBit(size_t value) {
+#if defined(__GNUC__)
+	return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+	size_t result = 0;
+	while (value >>= 1) {
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+} // namespace segmented_array_detail
+
+// An array of segments, which double in size. The segment of an index is its highest bit,
+// so the random access is O(1) with one lookup in the segment table. Growing allocates
+// the next segment and never moves the elements, so the pointers, the references and the
+// iterators stay valid, a push_back never copies the array, and a huge array needs no
+// contiguous block of twice its size. Use for_each_chunk() for loops, which should be
+// vectorized: the iterators have to check for the end of a segment at every step.
+template <typename T, typename Allocator = std::allocator<T>>
+class SegmentedArray {
+	using allocator_traits = std::allocator_traits<Allocator>;
+
+	static_assert(std::is_same<typename allocator_traits::value_type, T>::value, "The allocator must allocate T.");
+
+	// Segment k holds FirstSize << k elements, starting at (FirstSize << k) - FirstSize.
+	static const size_t FirstBits = 6;
+	static const size_t FirstSize = size_t(1) << FirstBits;
+	static const size_t MaxSegments = sizeof(size_t) * 8 - FirstBits;
+
+public:
+	using value_type = T;
+	using allocator_type = Allocator;
+	using size_type = size_t;
+	using reference = T&;
+	using const_reference = const T&;
+
+	template <typename ArrayType, typename ValueType>
+	class basic_iterator;
+
+	using iterator = basic_iterator<SegmentedArray, T>;
+	using const_iterator = basic_iterator<const SegmentedArray, const T>;
+
+public:
+	explicit SegmentedArray(const allocator_type &alloc = allocator_type());
+	SegmentedArray(size_type count, const_reference value, const allocator_type &alloc = allocator_type());
+	SegmentedArray(std::initializer_list<T> values, const allocator_type &alloc = allocator_type());
+	SegmentedArray(const SegmentedArray &r);
+	SegmentedArray(const SegmentedArray &r, const allocator_type &alloc);
+	SegmentedArray(SegmentedArray &&r) noexcept;
+	SegmentedArray(SegmentedArray &&r, const allocator_type &alloc);
+	SegmentedArray& operator=(const SegmentedArray &rhs);
+	SegmentedArray& operator=(SegmentedArray &&rhs) noexcept(
+		allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value);
+	~SegmentedArray();
+
+public:
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+	allocator_type get_allocator() const;
+
+	reference at(size_type pos);
+	const_reference at(size_type pos) const;
+
+	reference front();
+	const_reference front() const;
+
+	reference back();
+	const_reference back() const;
+
+	reference operator[](size_type pos);
+	const_reference operator[](size_type pos) const;
+
+	void pop_back();
+	void push_back(const_reference value);
+	void push_back(value_type &&value);
+
+	template <typename... Args>
+	reference emplace_back(Args&&... args);
+
+	void resize(size_type count);
+	void resize(size_type count, const_reference value);
+
+	// Allocates the segments for newCapacity elements.
+	void reserve(size_type newCapacity);
+
+	// Frees the segments, which hold no elements.
+	void shrink_to_fit();
+
+	bool empty() const;
+	size_type size() const;
+	size_type capacity() const;
+
+	// Calls f(first, last) with the pointers to the contiguous elements of each segment in order.
+	template <typename F>
+	void for_each_chunk(F f);
+
+	template <typename F>
+	void for_each_chunk(F f) const;
+
+	void clear();
+
+	// The allocators are swapped only if they propagate on swap. Otherwise they must be equal.
+	void swap(SegmentedArray &other) noexcept;
+
+private:
+	static size_t segmentOf(size_t pos);
+	static size_t segmentBase(size_t segment);
+	static size_t segmentSize(size_t segment);
+
+	T* element(size_t pos) const;
+
+	void addSegment();
+	void freeSegments(size_t count);
+
+	void copyFrom(const SegmentedArray &other);
+	void moveFrom(SegmentedArray &other);
+	void swapStorage(SegmentedArray &other) noexcept;
+
+	// The allocator propagation, selected by the allocator_traits tags, like in DynamicArray.
+	void moveAssign(SegmentedArray &other, std::true_type);
+	void moveAssign(SegmentedArray &other, std::false_type);
+	void copyAllocator(SegmentedArray &other, std::true_type);
+	void copyAllocator(SegmentedArray &other, std::false_type);
+	void swapAllocator(SegmentedArray &other, std::true_type) noexcept;
+	void swapAllocator(SegmentedArray &other, std::false_type) noexcept;
+
+private:
+	T *m_segments[MaxSegments];
+	size_t m_segmentCount;
+	size_t m_size;
+	allocator_type m_allocator;
+};
+
+/* --- ITERATOR --- */
+
+// Keeps the pointer to the element and the end of its segment, so the steps within
+// a segment do not look up the segment table.
+template <typename T, typename Allocator>
+template <typename ArrayType, typename ValueType>
+class SegmentedArray<T, Allocator>::basic_iterator {
+	friend class SegmentedArray<T, Allocator>;
+
+	template <typename OtherArray, typename OtherValue>
+	friend class basic_iterator;
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = typename std::remove_const<ValueType>::type;
+	using difference_type = ptrdiff_t;
+	using pointer = ValueType*;
+	using reference = ValueType&;
+
+public:
+	basic_iterator()
+		: m_array(nullptr)
+		, m_pos(0)
+		, m_ptr(nullptr)
+		, m_segmentEnd(0) {
+
+	}
+
+	// The iterator converts to the const_iterator.
+	template <typename OtherArray, typename OtherValue, typename = typename std::enable_if<std::is_convertible<OtherValue*, ValueType*>::value>::type>
+	basic_iterator(const basic_iterator<OtherArray, OtherValue> &r)
+		: m_array(r.m_array)
+		, m_pos(r.m_pos)
+		, m_ptr(r.m_ptr)
+		, m_segmentEnd(r.m_segmentEnd) {
+
+	}
+
+	reference operator*() const { return *m_ptr; }
+	pointer operator->() const { return m_ptr; }
+	reference operator[](difference_type n) const { return (*m_array)[m_pos + static_cast<size_t>(n)]; }
+
+	basic_iterator& operator++() {
+		++m_ptr;
+		if (++m_pos == m_segmentEnd) {
+			seek(m_pos);
+		}
+
+		return *this;
+	}
+
+	basic_iterator operator++(int) {
+		basic_iterator result(*this);
+		++*this;
+
+		return result;
+	}
+
+	basic_iterator& operator--() {
+		seek(m_pos - 1);
+		return *this;
+	}
+
+	basic_iterator operator--(int) {
+		basic_iterator result(*this);
+		--*this;
+
+		return result;
+	}
+
+	basic_iterator& operator+=(difference_type n) {
+		seek(m_pos + static_cast<size_t>(n));
+		return *this;
+	}
+
+	basic_iterator& operator-=(difference_type n) {
+		seek(m_pos - static_cast<size_t>(n));
+		return *this;
+	}
+
+	basic_iterator operator+(difference_type n) const { basic_iterator result(*this); return result += n; }
+	basic_iterator operator-(difference_type n) const { basic_iterator result(*this); return result -= n; }
+	friend basic_iterator operator+(difference_type n, const basic_iterator &it) { return it + n; }
+
+	template <typename OtherArray, typename OtherValue>
+	difference_type operator-(const basic_iterator<OtherArray, OtherValue> &r) const { return static_cast<difference_type>(m_pos - r.m_pos); }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator==(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos == r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator!=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos != r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator<(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos < r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator>(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos > r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator<=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos <= r.m_pos; }
+
+	template <typename OtherArray, typename OtherValue>
+	bool operator>=(const basic_iterator<OtherArray, OtherValue> &r) const { return m_pos >= r.m_pos; }
+
+private:
+	basic_iterator(ArrayType *array, size_t pos)
+		: m_array(array) {
+		seek(pos);
+	}
+
+	// The position past the allocated segments has no pointer, it is only compared.
+	void seek(size_t pos) {
+		const size_t segment = segmentOf(pos);
+
+		m_pos = pos;
+		m_ptr = segment < m_array->m_segmentCount ? m_array->m_segments[segment] + (pos - segmentBase(segment)) : nullptr;
+		m_segmentEnd = segmentBase(segment + 1);
+	}
+
+private:
+	ArrayType *m_array;
+	size_t m_pos;
+	ValueType *m_ptr;
+	size_t m_segmentEnd;
+};
+
+/* --- SEGMENTED ARRAY --- */
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(const allocator_type &alloc)
+	: m_segments()
+	, m_segmentCount(0)
+	, m_size(0)
+	, m_allocator(alloc) {
+
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(size_type count, const_reference value, const allocator_type &alloc)
+	: SegmentedArray(alloc) {
+	resize(count, value);
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(std::initializer_list<T> values, const allocator_type &alloc)
+	: SegmentedArray(alloc) {
+	reserve(values.size());
+	for (const T &value : values) {
+		push_back(value);
+	}
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(const SegmentedArray &r)
+	: SegmentedArray(allocator_traits::select_on_container_copy_construction(r.m_allocator)) {
+	copyFrom(r);
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(const SegmentedArray &r, const allocator_type &alloc)
+	: SegmentedArray(alloc) {
+	copyFrom(r);
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(SegmentedArray &&r) noexcept
+	: SegmentedArray(r.m_allocator) {
+	swapStorage(r);
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::SegmentedArray(SegmentedArray &&r, const allocator_type &alloc)
+	: SegmentedArray(alloc) {
+	if (m_allocator == r.m_allocator) {
+		swapStorage(r);
+	}
+	else {
+		// The segments of r cannot be freed by our allocator, the elements are moved one by one.
+		moveFrom(r);
+	}
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>& SegmentedArray<T, Allocator>::operator=(const SegmentedArray &rhs) {
+	if (this != &rhs) {
+		const bool propagate = allocator_traits::propagate_on_container_copy_assignment::value;
+		SegmentedArray copy(rhs, propagate ? rhs.m_allocator : m_allocator);
+
+		// copy takes the old segments, and the old allocator to free them with.
+		swapStorage(copy);
+		copyAllocator(copy, typename allocator_traits::propagate_on_container_copy_assignment());
+	}
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>& SegmentedArray<T, Allocator>::operator=(SegmentedArray &&rhs) noexcept(
+	allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value) {
+	if (this != &rhs) {
+		clear();
+		moveAssign(rhs, typename allocator_traits::propagate_on_container_move_assignment());
+	}
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+inline SegmentedArray<T, Allocator>::~SegmentedArray() {
+	clear();
+	freeSegments(0);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::iterator SegmentedArray<T, Allocator>::begin() {
+	return iterator(this, 0);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::iterator SegmentedArray<T, Allocator>::end() {
+	return iterator(this, m_size);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_iterator SegmentedArray<T, Allocator>::begin() const {
+	return const_iterator(this, 0);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_iterator SegmentedArray<T, Allocator>::end() const {
+	return const_iterator(this, m_size);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_iterator SegmentedArray<T, Allocator>::cbegin() const {
+	return begin();
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_iterator SegmentedArray<T, Allocator>::cend() const {
+	return end();
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::allocator_type SegmentedArray<T, Allocator>::get_allocator() const {
+	return m_allocator;
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::reference SegmentedArray<T, Allocator>::at(size_type pos) {
+	return const_cast<reference>(static_cast<const SegmentedArray&>(*this).at(pos));
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_reference SegmentedArray<T, Allocator>::at(size_type pos) const {
+	if (pos >= m_size) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::reference SegmentedArray<T, Allocator>::front() {
+	return const_cast<reference>(static_cast<const SegmentedArray&>(*this).front());
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_reference SegmentedArray<T, Allocator>::front() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return *m_segments[0];
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::reference SegmentedArray<T, Allocator>::back() {
+	return const_cast<reference>(static_cast<const SegmentedArray&>(*this).back());
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_reference SegmentedArray<T, Allocator>::back() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return *element(m_size - 1);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::reference SegmentedArray<T, Allocator>::operator[](size_type pos) {
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::const_reference SegmentedArray<T, Allocator>::operator[](size_type pos) const {
+	return *element(pos);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::pop_back() {
+	if (!empty()) {
+		--m_size;
+		allocator_traits::destroy(m_allocator, element(m_size));
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::push_back(const_reference value) {
+	emplace_back(value);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::push_back(value_type &&value) {
+	emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+inline typename SegmentedArray<T, Allocator>::reference SegmentedArray<T, Allocator>::emplace_back(Args&&... args) {
+	if (m_size == capacity()) {
+		addSegment();
+	}
+
+	T *ptr = element(m_size);
+	allocator_traits::construct(m_allocator, ptr, std::forward<Args>(args)...);
+	++m_size;
+
+	return *ptr;
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::resize(size_type count) {
+	reserve(count);
+	while (m_size < count) {
+		emplace_back();
+	}
+	while (m_size > count) {
+		pop_back();
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::resize(size_type count, const_reference value) {
+	reserve(count);
+	while (m_size < count) {
+		emplace_back(value);
+	}
+	while (m_size > count) {
+		pop_back();
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::reserve(size_type newCapacity) {
+	while (capacity() < newCapacity) {
+		addSegment();
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::shrink_to_fit() {
+	freeSegments(m_size ? segmentOf(m_size - 1) + 1 : 0);
+}
+
+template <typename T, typename Allocator>
+inline bool SegmentedArray<T, Allocator>::empty() const {
+	return m_size == 0;
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::size_type SegmentedArray<T, Allocator>::size() const {
+	return m_size;
+}
+
+template <typename T, typename Allocator>
+inline typename SegmentedArray<T, Allocator>::size_type SegmentedArray<T, Allocator>::capacity() const {
+	return segmentBase(m_segmentCount);
+}
+
+template <typename T, typename Allocator>
+template <typename F>
+inline void SegmentedArray<T, Allocator>::for_each_chunk(F f) {
+	for (size_t segment = 0; segment < m_segmentCount && segmentBase(segment) < m_size; ++segment) {
+		f(m_segments[segment], m_segments[segment] + std::min(segmentSize(segment), m_size - segmentBase(segment)));
+	}
+}
+
+template <typename T, typename Allocator>
+template <typename F>
+inline void SegmentedArray<T, Allocator>::for_each_chunk(F f) const {
+	for (size_t segment = 0; segment < m_segmentCount && segmentBase(segment) < m_size; ++segment) {
+		const T *first = m_segments[segment];
+		f(first, first + std::min(segmentSize(segment), m_size - segmentBase(segment)));
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::clear() {
+	for_each_chunk([this](T *first, T *last) {
+		for (; first != last; ++first) {
+			allocator_traits::destroy(m_allocator, first);
+		}
+	});
+
+	m_size = 0;
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::swap(SegmentedArray &other) noexcept {
+	swapAllocator(other, typename allocator_traits::propagate_on_container_swap());
+	swapStorage(other);
+}
+
+template <typename T, typename Allocator>
+inline size_t SegmentedArray<T, Allocator>::segmentOf(size_t pos) {
+	return segmented_array_detail::highestBit(pos + FirstSize) - FirstBits;
+}
+
+template <typename T, typename Allocator>
+inline size_t SegmentedArray<T, Allocator>::segmentBase(size_t segment) {
+	return (FirstSize << segment) - FirstSize;
+}
+
+template <typename T, typename Allocator>
+inline size_t SegmentedArray<T, Allocator>::segmentSize(size_t segment) {
+	return FirstSize << segment;
+}
+
+template <typename T, typename Allocator>
+inline T* SegmentedArray<T, Allocator>::element(size_t pos) const {
+	const size_t segment = segmentOf(pos);
+	return m_segments[segment] + (pos - segmentBase(segment));
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::addSegment() {
+	if (m_segmentCount == MaxSegments) {
+		throw std::length_error("Too many elements!");
+	}
+
+	m_segments[m_segmentCount] = allocator_traits::allocate(m_allocator, segmentSize(m_segmentCount));
+	++m_segmentCount;
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::freeSegments(size_t count) {
+	while (m_segmentCount > count) {
+		--m_segmentCount;
+		allocator_traits::deallocate(m_allocator, m_segments[m_segmentCount], segmentSize(m_segmentCount));
+		m_segments[m_segmentCount] = nullptr;
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::copyFrom(const SegmentedArray &other) {
+	reserve(other.size());
+	other.for_each_chunk([this](const T *first, const T *last) {
+		for (; first != last; ++first) {
+			push_back(*first);
+		}
+	});
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::moveFrom(SegmentedArray &other) {
+	reserve(other.size());
+	other.for_each_chunk([this](T *first, T *last) {
+		for (; first != last; ++first) {
+			emplace_back(std::move(*first));
+		}
+	});
+
+	other.clear();
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::swapStorage(SegmentedArray &other) noexcept {
+	std::swap(m_segments, other.m_segments);
+	std::swap(m_segmentCount, other.m_segmentCount);
+	std::swap(m_size, other.m_size);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::moveAssign(SegmentedArray &other, std::true_type) {
+	// other takes the old segments, and the old allocator to free them with.
+	using std::swap;
+	swap(m_allocator, other.m_allocator);
+	swapStorage(other);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::moveAssign(SegmentedArray &other, std::false_type) {
+	if (m_allocator == other.m_allocator) {
+		swapStorage(other);
+	}
+	else {
+		moveFrom(other);
+	}
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::copyAllocator(SegmentedArray &other, std::true_type) {
+	using std::swap;
+	swap(m_allocator, other.m_allocator);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::copyAllocator(SegmentedArray&, std::false_type) {
+
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::swapAllocator(SegmentedArray &other, std::true_type) noexcept {
+	using std::swap;
+	swap(m_allocator, other.m_allocator);
+}
+
+template <typename T, typename Allocator>
+inline void SegmentedArray<T, Allocator>::swapAllocator(SegmentedArray&, std::false_type) noexcept {
+	// Swapping arrays with unequal allocators, which do not propagate, is undefined, like in std::vector.
+}
+
+template <typename T, typename Allocator>
+inline void swap(SegmentedArray<T, Allocator> &lhs, SegmentedArray<T, Allocator> &rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+#endif // !SEGMENTED_ARRAY_HEADER
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+
+#include "../DynamicArray/DynamicArray.h"
+#include "SegmentedArray.h"
+
+// Appending 32M numbers to DynamicArray and SegmentedArray: the total time and the
+// slowest single push_back, which for DynamicArray is the copy of the whole array.
+// Then the sums of the elements in milliseconds, through the DynamicArray pointers,
+// the SegmentedArray indices, its iterators and its chunks.
+
+const size_t Count = size_t(32) * 1024 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::time_point start, Clock::time_point end) {
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename Array>
+void appends(const char *name, Array &array) {
+	double slowest = 0;
+
+	const auto start = Clock::now();
+	for (size_t i = 0; i < Count; ++i) {
+		const auto before = Clock::now();
+		array.push_back(i);
+		const double time = milliseconds(before, Clock::now());
+
+		slowest = time > slowest ? time : slowest;
+	}
+	const auto end = Clock::now();
+
+	std::cout << "  " << name << ": " << milliseconds(start, end) << " ms, slowest push_back " << slowest << " ms\n";
+}
+
+template <typename F>
+void sum(const char *name, F f) {
+	const auto start = Clock::now();
+	const uint64_t result = f();
+	const auto end = Clock::now();
+
+	std::cout << "  " << name << ": " << milliseconds(start, end) << " ms (" << result << ")\n";
+}
+
+int main() {
+	DynamicArray<uint64_t> dynamic;
+	SegmentedArray<uint64_t> segmented;
+
+	std::cout << "Appending " << Count << " numbers:\n";
+	appends("DynamicArray", dynamic);
+	appends("SegmentedArray", segmented);
+
+	std::cout << "Sums:\n";
+	sum("DynamicArray", [&] {
+		return std::accumulate(dynamic.data(), dynamic.data() + dynamic.size(), uint64_t(0));
+	});
+	sum("SegmentedArray, indices", [&] {
+		uint64_t result = 0;
+		for (size_t i = 0; i < segmented.size(); ++i) {
+			result += segmented[i];
+		}
+
+		return result;
+	});
+	sum("SegmentedArray, iterators", [&] {
+		return std::accumulate(segmented.begin(), segmented.end(), uint64_t(0));
+	});
+	sum("SegmentedArray, chunks", [&] {
+		uint64_t result = 0;
+		segmented.for_each_chunk([&result](const uint64_t *first, const uint64_t *last) {
+			result = std::accumulate(first, last, result);
+		});
+
+		return result;
+	});
+
+	return 0;
+}
@@ -0,0 +1,315 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <random>
+#include <vector>
+#include <map>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#include "SegmentedArray.h"
+
+// Random operations against std::vector across many segment boundaries.
+void testRandom() {
+	std::mt19937 random(7);
+
+	SegmentedArray<int> array;
+	std::vector<int> expected;
+
+	for (int i = 0; i < 100000; ++i) {
+		switch (random() % 8) {
+		case 0:
+			array.pop_back();
+			if (!expected.empty()) {
+				expected.pop_back();
+			}
+			break;
+		case 1: {
+			const size_t count = random() % 300;
+			array.resize(count, i);
+			expected.resize(count, i);
+			break;
+		}
+		default:
+			array.push_back(i);
+			expected.push_back(i);
+			break;
+		}
+
+		assert(array.size() == expected.size());
+		assert(array.empty() || (array.front() == expected.front() && array.back() == expected.back()));
+	}
+
+	assert(std::equal(array.begin(), array.end(), expected.begin(), expected.end()));
+	for (size_t i = 0; i < expected.size(); ++i) {
+		assert(array[i] == expected[i] && array.at(i) == expected[i]);
+	}
+}
+
+// Growing never moves the elements.
+void testStablePointers() {
+	SegmentedArray<std::string> array;
+	array.push_back("first");
+
+	const std::string *first = &array[0];
+	auto it = array.begin();
+
+	std::vector<const std::string*> pointers;
+	for (int i = 0; i < 10000; ++i) {
+		array.emplace_back(std::to_string(i));
+		pointers.push_back(&array.back());
+	}
+
+	assert(first == &array[0] && *it == "first" && it->size() == 5);
+	for (size_t i = 0; i < pointers.size(); ++i) {
+		assert(pointers[i] == &array[i + 1] && *pointers[i] == std::to_string(i));
+	}
+
+	SegmentedArray<std::string> copy(array);
+	assert(std::equal(copy.begin(), copy.end(), array.begin(), array.end()));
+
+	SegmentedArray<std::string> moved(std::move(copy));
+	assert(copy.empty() && moved.size() == array.size() && &moved[0] != first);
+
+	copy = moved;
+	moved = std::move(copy);
+	assert(copy.empty() && moved.back() == "9999");
+}
+
+// The chunks cover the elements in order, each of them contiguous.
+void testChunks() {
+	SegmentedArray<int> array;
+	array.for_each_chunk([](int*, int*) { assert(false); });
+
+	for (int i = 0; i < 5000; ++i) {
+		array.push_back(i);
+	}
+
+	int next = 0;
+	size_t chunks = 0;
+	array.for_each_chunk([&](int *first, int *last) {
+		assert(first < last);
+		for (; first != last; ++first) {
+			assert(*first == next++);
+		}
+		++chunks;
+	});
+	assert(next == 5000 && chunks > 1 && chunks < 10);
+
+	const SegmentedArray<int> &constant = array;
+	long long sum = 0;
+	constant.for_each_chunk([&sum](const int *first, const int *last) {
+		sum = std::accumulate(first, last, sum);
+	});
+	assert(sum == 4999LL * 5000 / 2);
+}
+
+void testIterators() {
+	SegmentedArray<int> array;
+	for (int i = 0; i < 1000; ++i) {
+		array.push_back((i * 7919) % 1000);
+	}
+
+	std::sort(array.begin(), array.end());
+	for (int i = 0; i < 1000; ++i) {
+		assert(array[static_cast<size_t>(i)] == i);
+	}
+
+	auto it = array.end();
+	--it;
+	assert(*it == 999 && it - array.begin() == 999 && *(it - 935) == 64 && it[-936] == 63);
+
+	SegmentedArray<int>::const_iterator cit = array.begin() + 64;
+	assert(*cit == 64 && *--cit == 63 && cit < array.end() && array.cend() - cit == 937);
+
+	std::reverse(array.begin(), array.end());
+	assert(array.front() == 999 && array.back() == 0);
+}
+
+void testCapacity() {
+	SegmentedArray<int> array;
+	assert(array.capacity() == 0 && array.begin() == array.end());
+
+	bool thrown = false;
+	try {
+		array.front();
+	}
+	catch (const std::logic_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	array.reserve(1000);
+	const size_t capacity = array.capacity();
+	assert(capacity >= 1000 && capacity < 2100);
+
+	array.resize(1000);
+	assert(array.capacity() == capacity && array[999] == 0);
+
+	array.resize(10);
+	array.shrink_to_fit();
+	assert(array.capacity() < 100 && array.size() == 10);
+
+	array.clear();
+	array.shrink_to_fit();
+	assert(array.capacity() == 0);
+
+	thrown = false;
+	try {
+		array.at(0);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	SegmentedArray<int> filled(100, 3);
+	SegmentedArray<int> listed = { 1, 2, 3 };
+	swap(filled, listed);
+	assert(filled.size() == 3 && listed.size() == 100 && listed[99] == 3);
+}
+
+// A stateful allocator, which propagates on copy assignment, move assignment and swap.
+// Every segment must come back to the allocator with the same tag.
+template <typename T>
+struct TaggedAllocator {
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	static std::map<const void*, int> owners;
+
+	explicit TaggedAllocator(int tag)
+		: tag(tag) {
+
+	}
+
+	template <typename U>
+	TaggedAllocator(const TaggedAllocator<U> &r)
+		: tag(r.tag) {
+
+	}
+
+	T* allocate(size_t count) {
+		T *ptr = std::allocator<T>().allocate(count);
+		owners[ptr] = tag;
+		return ptr;
+	}
+
+	void deallocate(T *ptr, size_t count) {
+		assert(owners[ptr] == tag);
+		owners.erase(ptr);
+		std::allocator<T>().deallocate(ptr, count);
+	}
+
+	bool operator==(const TaggedAllocator &r) const { return tag == r.tag; }
+	bool operator!=(const TaggedAllocator &r) const { return tag != r.tag; }
+
+	int tag;
+};
+
+template <typename T>
+std::map<const void*, int> TaggedAllocator<T>::owners;
+
+void testPropagatingAllocator() {
+	using Array = SegmentedArray<std::string, TaggedAllocator<std::string>>;
+
+	{
+		Array a(TaggedAllocator<std::string>(1));
+		Array b(TaggedAllocator<std::string>(2));
+		for (int i = 0; i < 100; ++i) {
+			a.push_back(std::to_string(i));
+			b.push_back(std::to_string(i * 2));
+		}
+
+		// The copy takes the allocator of the source, the old segments go back to their own.
+		a = b;
+		assert(a.get_allocator().tag == 2 && a[99] == "198");
+		a.push_back("more");
+
+		Array c(TaggedAllocator<std::string>(3));
+		c.push_back("three");
+		c = std::move(a);
+		assert(c.get_allocator().tag == 2 && c.size() == 101);
+
+		Array d(TaggedAllocator<std::string>(4));
+		d.push_back("four");
+		c.swap(d);
+		assert(c.get_allocator().tag == 4 && d.get_allocator().tag == 2 && d.back() == "more");
+
+		Array e(std::move(d), TaggedAllocator<std::string>(5));
+		assert(e.get_allocator().tag == 5 && e.size() == 101 && d.empty());
+	}
+
+	assert(TaggedAllocator<std::string>::owners.empty());
+}
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+void testPmr() {
+	using Array = SegmentedArray<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+
+	std::pmr::unsynchronized_pool_resource first;
+	std::pmr::unsynchronized_pool_resource second;
+
+	Array a(&first);
+	for (int i = 0; i < 100; ++i) {
+		a.emplace_back(40, char('a' + i % 26));
+	}
+
+	// The elements get the allocator of the array.
+	assert(a.back().get_allocator().resource() == &first);
+
+	// Copies get the default resource, moves and allocator-extended copies keep theirs.
+	Array copy(a);
+	assert(copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+	Array moved(std::move(copy));
+	assert(moved.get_allocator().resource() == std::pmr::get_default_resource() && copy.empty());
+
+	Array other(a, &second);
+	assert(other.get_allocator().resource() == &second && other[99] == a[99]);
+
+	// The allocators are not propagated on assignment, the elements are moved or copied over.
+	other = std::move(a);
+	assert(other.get_allocator().resource() == &second && a.empty());
+	assert(other.size() == 100 && other[0].get_allocator().resource() == &second);
+
+	a = other;
+	assert(a.get_allocator().resource() == &first && a.size() == 100 && a[25] == std::pmr::string(40, 'z'));
+
+	Array extended(std::move(a), &second);
+	assert(extended.get_allocator().resource() == &second && extended.size() == 100);
+
+	// Equal allocators, so the segments are swapped.
+	const std::pmr::string *element = &extended[0];
+	extended.swap(other);
+	assert(&other[0] == element);
+}
+#endif
+
+int main() {
+	SegmentedArray<int> array = { 1, 2, 3 };
+	array.push_back(4);
+	for (int value : array) {
+		std::cout << value << ' ';
+	}
+	std::cout << '\n';
+
+	testRandom();
+	testStablePointers();
+	testChunks();
+	testIterators();
+	testCapacity();
+	testPropagatingAllocator();
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+	testPmr();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,664 @@
+#pragma once
+#ifndef SIMD_ALGORITHMS_HEADER
+#define SIMD_ALGORITHMS_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../DynamicArray/DynamicArray.h"
+
+// The kernels are compiled for every instruction set with target pragmas and picked at
+// runtime, so the binary does not need -mavx2 to use AVX2. That needs GCC on x86, other
+// compilers and platforms get the scalar loops.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(__clang__)
+#define SIMD_ALGORITHMS_HAS_X86
+
+// The AVX-512 intrinsics of GCC 12 start from _mm512_undefined_*(), which -Wuninitialized
+// reports in every function using them.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+// Vectorized linear searches and aggregates over the arrays of int32_t, float and uint8_t.
+// They work on the raw storage, so there are no bounds-checked iterators in the loops.
+// The floats are compared with ==, so NaNs are never found, and min/max do not support NaNs.
+
+enum class SimdLevel {
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+// The instruction set, which the algorithms use. It is the best one of the CPU by default.
+SimdLevel simd_level();
+
+// Limits the instruction set to level, for the tests and the benchmarks.
+// Returns the instruction set, which is used from now on.
+SimdLevel simd_set_level(SimdLevel level);
+
+namespace simd_detail {
+
+template <typename T>
+struct Identity {
+	using type = T;
+};
+
+template <typename T>
+struct SumType;
+
+template <>
+struct SumType<int32_t> {
+	using type = int64_t;
+};
+
+template <>
+struct SumType<uint8_t> {
+	using type = uint64_t;
+};
+
+// The floats are added in double lanes, so long arrays do not lose the small elements.
+template <>
+struct SumType<float> {
+	using type = double;
+};
+
+template <typename T>
+struct IsSimdType : std::integral_constant<bool, std::is_same<T, int32_t>::value || std::is_same<T, float>::value || std::is_same<T, uint8_t>::value> {};
+
+// The largest set of find_first_of, which is searched with SIMD.
+const size_t MaxSetSize = 16;
+
+} // namespace simd_detail
+
+// The index of the first element equal to value, or size if there is none.
+template <typename T>
+size_t simd_find(const T *data, size_t size, typename simd_detail::Identity<T>::type value);
+
+// The number of the elements equal to value.
+template <typename T>
+size_t simd_count(const T *data, size_t size, typename simd_detail::Identity<T>::type value);
+
+// The index of the first element equal to any of the set, or size if there is none.
+// Sets of up to 16 elements are searched with SIMD.
+template <typename T>
+size_t simd_find_first_of(const T *data, size_t size, const T *set, size_t setSize);
+
+// The smallest and the largest element. Throws std::logic_error for an empty array.
+template <typename T>
+T simd_min(const T *data, size_t size);
+
+template <typename T>
+T simd_max(const T *data, size_t size);
+
+// The sum in a wider type: int64_t, uint64_t and double. The lanes are added separately,
+// so the floats are added in a different order than by a loop.
+template <typename T>
+typename simd_detail::SumType<T>::type simd_sum(const T *data, size_t size);
+
+/* --- DynamicArray --- */
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator simd_find(const DynamicArray<T, Allocator, GrowthPolicy> &array, typename simd_detail::Identity<T>::type value);
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+size_t simd_count(const DynamicArray<T, Allocator, GrowthPolicy> &array, typename simd_detail::Identity<T>::type value);
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename SetAllocator, typename SetGrowthPolicy>
+typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator simd_find_first_of(const DynamicArray<T, Allocator, GrowthPolicy> &array, const DynamicArray<T, SetAllocator, SetGrowthPolicy> &set);
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+T simd_min(const DynamicArray<T, Allocator, GrowthPolicy> &array);
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+T simd_max(const DynamicArray<T, Allocator, GrowthPolicy> &array);
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename simd_detail::SumType<T>::type simd_sum(const DynamicArray<T, Allocator, GrowthPolicy> &array);
+
+/* --- KERNELS --- */
+
+namespace simd_detail {
+
+namespace scalar {
+
+template <typename T>
+size_t find(const T *data, size_t size, T value) {
+	return static_cast<size_t>(std::find(data, data + size, value) - data);
+}
+
+template <typename T>
+size_t count(const T *data, size_t size, T value) {
+	return static_cast<size_t>(std::count(data, data + size, value));
+}
+
+template <typename T>
+size_t find_first_of(const T *data, size_t size, const T *set, size_t setSize) {
+	return static_cast<size_t>(std::find_first_of(data, data + size, set, set + setSize) - data);
+}
+
+template <typename T>
+T minimum(const T *data, size_t size) {
+	return *std::min_element(data, data + size);
+}
+
+template <typename T>
+T maximum(const T *data, size_t size) {
+	return *std::max_element(data, data + size);
+}
+
+template <typename T>
+typename SumType<T>::type sum(const T *data, size_t size) {
+	typename SumType<T>::type result = 0;
+	for (size_t i = 0; i < size; ++i) {
+		result += data[i];
+	}
+
+	return result;
+}
+
+} // namespace scalar
+
+#ifdef SIMD_ALGORITHMS_HAS_X86
+
+namespace sse2 {
+
+// Some SSE2 processors have no POPCNT, where __builtin_popcountll() is a library call.
+// The masks have at most 16 bits, the ones of 4 lanes are looked up in a nibble table.
+inline size_t countBits4(uint64_t mask) {
+	return static_cast<size_t>((0x4332322132212110ULL >> (mask * 4)) & 0xF);
+}
+
+inline size_t countBits(uint64_t mask) {
+	mask = mask - ((mask >> 1) & 0x5555);
+	mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+	mask = (mask + (mask >> 4)) & 0x0F0F;
+	return static_cast<size_t>((mask + (mask >> 8)) & 0x1F);
+}
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+template <typename T>
+struct Ops;
+
+template <>
+struct Ops<int32_t> {
+	using reg = __m128i;
+	using acc = __m128i;
+	static const size_t lanes = 4;
+
+	static reg load(const int32_t *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+	static void store(int32_t *ptr, reg a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), a); }
+	static reg set1(int32_t value) { return _mm_set1_epi32(value); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+	static size_t bits(uint64_t mask) { return countBits4(mask); }
+
+	// SSE2 has no 32-bit min and max, they are blended from a comparison.
+	static reg min(reg a, reg b) {
+		const reg greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+	}
+
+	static reg max(reg a, reg b) {
+		const reg greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+	}
+
+	static acc zero() { return _mm_setzero_si128(); }
+
+	// Sign-extends the lanes to 64 bits by interleaving them with their signs.
+	static acc add(acc sum, reg a) {
+		const reg sign = _mm_srai_epi32(a, 31);
+		return _mm_add_epi64(sum, _mm_add_epi64(_mm_unpacklo_epi32(a, sign), _mm_unpackhi_epi32(a, sign)));
+	}
+
+	static int64_t total(acc sum) {
+		int64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+		return lanes[0] + lanes[1];
+	}
+};
+
+template <>
+struct Ops<float> {
+	using reg = __m128;
+	using acc = __m128d;
+	static const size_t lanes = 4;
+
+	static reg load(const float *ptr) { return _mm_loadu_ps(ptr); }
+	static void store(float *ptr, reg a) { _mm_storeu_ps(ptr, a); }
+	static reg set1(float value) { return _mm_set1_ps(value); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint64_t>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+	static size_t bits(uint64_t mask) { return countBits4(mask); }
+	static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+	static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+
+	static acc zero() { return _mm_setzero_pd(); }
+	static acc add(acc sum, reg a) { return _mm_add_pd(sum, _mm_add_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(_mm_movehl_ps(a, a)))); }
+
+	static double total(acc sum) {
+		double lanes[2];
+		_mm_storeu_pd(lanes, sum);
+		return lanes[0] + lanes[1];
+	}
+};
+
+template <>
+struct Ops<uint8_t> {
+	using reg = __m128i;
+	using acc = __m128i;
+	static const size_t lanes = 16;
+
+	static reg load(const uint8_t *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+	static void store(uint8_t *ptr, reg a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), a); }
+	static reg set1(uint8_t value) { return _mm_set1_epi8(static_cast<char>(value)); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))); }
+	static size_t bits(uint64_t mask) { return countBits(mask); }
+	static reg min(reg a, reg b) { return _mm_min_epu8(a, b); }
+	static reg max(reg a, reg b) { return _mm_max_epu8(a, b); }
+
+	// The sum of absolute differences from zero adds up the bytes of each half.
+	static acc zero() { return _mm_setzero_si128(); }
+	static acc add(acc sum, reg a) { return _mm_add_epi64(sum, _mm_sad_epu8(a, _mm_setzero_si128())); }
+
+	static uint64_t total(acc sum) {
+		uint64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+		return lanes[0] + lanes[1];
+	}
+};
+
+#include "SimdKernels.inl"
+
+#pragma GCC pop_options
+
+} // namespace sse2
+
+namespace avx2 {
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+template <typename T>
+struct Ops;
+
+template <>
+struct Ops<int32_t> {
+	using reg = __m256i;
+	using acc = __m256i;
+	static const size_t lanes = 8;
+
+	static reg load(const int32_t *ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+	static void store(int32_t *ptr, reg a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), a); }
+	static reg set1(int32_t value) { return _mm256_set1_epi32(value); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+	static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+
+	static acc zero() { return _mm256_setzero_si256(); }
+
+	static acc add(acc sum, reg a) {
+		const acc low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a));
+		const acc high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1));
+		return _mm256_add_epi64(sum, _mm256_add_epi64(low, high));
+	}
+
+	static int64_t total(acc sum) {
+		int64_t lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+};
+
+template <>
+struct Ops<float> {
+	using reg = __m256;
+	using acc = __m256d;
+	static const size_t lanes = 8;
+
+	static reg load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+	static void store(float *ptr, reg a) { _mm256_storeu_ps(ptr, a); }
+	static reg set1(float value) { return _mm256_set1_ps(value); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+	static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+
+	static acc zero() { return _mm256_setzero_pd(); }
+
+	static acc add(acc sum, reg a) {
+		const acc low = _mm256_cvtps_pd(_mm256_castps256_ps128(a));
+		const acc high = _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1));
+		return _mm256_add_pd(sum, _mm256_add_pd(low, high));
+	}
+
+	static double total(acc sum) {
+		double lanes[4];
+		_mm256_storeu_pd(lanes, sum);
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+};
+
+template <>
+struct Ops<uint8_t> {
+	using reg = __m256i;
+	using acc = __m256i;
+	static const size_t lanes = 32;
+
+	static reg load(const uint8_t *ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+	static void store(uint8_t *ptr, reg a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), a); }
+	static reg set1(uint8_t value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+	static uint64_t eq(reg a, reg b) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm256_min_epu8(a, b); }
+	static reg max(reg a, reg b) { return _mm256_max_epu8(a, b); }
+
+	static acc zero() { return _mm256_setzero_si256(); }
+	static acc add(acc sum, reg a) { return _mm256_add_epi64(sum, _mm256_sad_epu8(a, _mm256_setzero_si256())); }
+
+	static uint64_t total(acc sum) {
+		uint64_t lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+};
+
+#include "SimdKernels.inl"
+
+#pragma GCC pop_options
+
+} // namespace avx2
+
+namespace avx512 {
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+
+template <typename T>
+struct Ops;
+
+template <>
+struct Ops<int32_t> {
+	using reg = __m512i;
+	using acc = __m512i;
+	static const size_t lanes = 16;
+
+	static reg load(const int32_t *ptr) { return _mm512_loadu_si512(ptr); }
+	static void store(int32_t *ptr, reg a) { _mm512_storeu_si512(ptr, a); }
+	static reg set1(int32_t value) { return _mm512_set1_epi32(value); }
+	static uint64_t eq(reg a, reg b) { return _mm512_cmpeq_epi32_mask(a, b); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+	static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+
+	static acc zero() { return _mm512_setzero_si512(); }
+
+	static acc add(acc sum, reg a) {
+		const acc low = _mm512_cvtepi32_epi64(_mm512_castsi512_si256(a));
+		const acc high = _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(a, 1));
+		return _mm512_add_epi64(sum, _mm512_add_epi64(low, high));
+	}
+
+	static int64_t total(acc sum) { return _mm512_reduce_add_epi64(sum); }
+};
+
+template <>
+struct Ops<float> {
+	using reg = __m512;
+	using acc = __m512d;
+	static const size_t lanes = 16;
+
+	static reg load(const float *ptr) { return _mm512_loadu_ps(ptr); }
+	static void store(float *ptr, reg a) { _mm512_storeu_ps(ptr, a); }
+	static reg set1(float value) { return _mm512_set1_ps(value); }
+	static uint64_t eq(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+	static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+
+	static acc zero() { return _mm512_setzero_pd(); }
+
+	static acc add(acc sum, reg a) {
+		const acc low = _mm512_cvtps_pd(_mm512_castps512_ps256(a));
+		const acc high = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+		return _mm512_add_pd(sum, _mm512_add_pd(low, high));
+	}
+
+	static double total(acc sum) { return _mm512_reduce_add_pd(sum); }
+};
+
+template <>
+struct Ops<uint8_t> {
+	using reg = __m512i;
+	using acc = __m512i;
+	static const size_t lanes = 64;
+
+	static reg load(const uint8_t *ptr) { return _mm512_loadu_si512(ptr); }
+	static void store(uint8_t *ptr, reg a) { _mm512_storeu_si512(ptr, a); }
+	static reg set1(uint8_t value) { return _mm512_set1_epi8(static_cast<char>(value)); }
+	static uint64_t eq(reg a, reg b) { return _mm512_cmpeq_epi8_mask(a, b); }
+	static size_t bits(uint64_t mask) { return static_cast<size_t>(__builtin_popcountll(mask)); }
+	static reg min(reg a, reg b) { return _mm512_min_epu8(a, b); }
+	static reg max(reg a, reg b) { return _mm512_max_epu8(a, b); }
+
+	static acc zero() { return _mm512_setzero_si512(); }
+	static acc add(acc sum, reg a) { return _mm512_add_epi64(sum, _mm512_sad_epu8(a, _mm512_setzero_si512())); }
+	static uint64_t total(acc sum) { return static_cast<uint64_t>(_mm512_reduce_add_epi64(sum)); }
+};
+
+#include "SimdKernels.inl"
+
+#pragma GCC pop_options
+
+} // namespace avx512
+
+#endif // SIMD_ALGORITHMS_HAS_X86
+
+inline SimdLevel detectLevel() {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+		return SimdLevel::Avx512;
+	}
+
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdLevel::Avx2;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return SimdLevel::Sse2;
+	}
+#endif
+
+	return SimdLevel::Scalar;
+}
+
+inline std::atomic<SimdLevel>& currentLevel() {
+	static std::atomic<SimdLevel> level(detectLevel());
+	return level;
+}
+
+} // namespace simd_detail
+
+inline SimdLevel simd_level() {
+	return simd_detail::currentLevel().load(std::memory_order_relaxed);
+}
+
+inline SimdLevel simd_set_level(SimdLevel level) {
+	const SimdLevel result = std::min(level, simd_detail::detectLevel());
+	simd_detail::currentLevel().store(result, std::memory_order_relaxed);
+
+	return result;
+}
+
+/* --- DISPATCH --- */
+
+// Every function goes to the kernel of the current instruction set. The switch is cheap
+// next to even a short array, and it lets the tests and the benchmarks change the set.
+
+template <typename T>
+inline size_t simd_find(const T *data, size_t size, typename simd_detail::Identity<T>::type value) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	switch (simd_level()) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::find(data, size, value);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::find(data, size, value);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::find(data, size, value);
+#endif
+	default:
+		return simd_detail::scalar::find(data, size, value);
+	}
+}
+
+template <typename T>
+inline size_t simd_count(const T *data, size_t size, typename simd_detail::Identity<T>::type value) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	switch (simd_level()) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::count(data, size, value);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::count(data, size, value);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::count(data, size, value);
+#endif
+	default:
+		return simd_detail::scalar::count(data, size, value);
+	}
+}
+
+template <typename T>
+inline size_t simd_find_first_of(const T *data, size_t size, const T *set, size_t setSize) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	const SimdLevel level = setSize <= simd_detail::MaxSetSize ? simd_level() : SimdLevel::Scalar;
+
+	switch (level) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::find_first_of(data, size, set, setSize);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::find_first_of(data, size, set, setSize);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::find_first_of(data, size, set, setSize);
+#endif
+	default:
+		return simd_detail::scalar::find_first_of(data, size, set, setSize);
+	}
+}
+
+template <typename T>
+inline T simd_min(const T *data, size_t size) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	if (!size) {
+		throw std::logic_error("Empty array!");
+	}
+
+	// The kernels need at least one full vector.
+	const SimdLevel level = size >= 64 ? simd_level() : SimdLevel::Scalar;
+
+	switch (level) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::minimum(data, size);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::minimum(data, size);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::minimum(data, size);
+#endif
+	default:
+		return simd_detail::scalar::minimum(data, size);
+	}
+}
+
+template <typename T>
+inline T simd_max(const T *data, size_t size) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	if (!size) {
+		throw std::logic_error("Empty array!");
+	}
+
+	const SimdLevel level = size >= 64 ? simd_level() : SimdLevel::Scalar;
+
+	switch (level) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::maximum(data, size);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::maximum(data, size);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::maximum(data, size);
+#endif
+	default:
+		return simd_detail::scalar::maximum(data, size);
+	}
+}
+
+template <typename T>
+inline typename simd_detail::SumType<T>::type simd_sum(const T *data, size_t size) {
+	static_assert(simd_detail::IsSimdType<T>::value, "Only int32_t, float and uint8_t are supported.");
+
+	switch (simd_level()) {
+#ifdef SIMD_ALGORITHMS_HAS_X86
+	case SimdLevel::Avx512:
+		return simd_detail::avx512::sum(data, size);
+	case SimdLevel::Avx2:
+		return simd_detail::avx2::sum(data, size);
+	case SimdLevel::Sse2:
+		return simd_detail::sse2::sum(data, size);
+#endif
+	default:
+		return simd_detail::scalar::sum(data, size);
+	}
+}
+
+/* --- DynamicArray --- */
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator simd_find(const DynamicArray<T, Allocator, GrowthPolicy> &array, typename simd_detail::Identity<T>::type value) {
+	return array.cbegin() + static_cast<ptrdiff_t>(simd_find(array.data(), array.size(), value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline size_t simd_count(const DynamicArray<T, Allocator, GrowthPolicy> &array, typename simd_detail::Identity<T>::type value) {
+	return simd_count(array.data(), array.size(), value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename SetAllocator, typename SetGrowthPolicy>
+inline typename DynamicArray<T, Allocator, GrowthPolicy>::const_iterator simd_find_first_of(const DynamicArray<T, Allocator, GrowthPolicy> &array, const DynamicArray<T, SetAllocator, SetGrowthPolicy> &set) {
+	return array.cbegin() + static_cast<ptrdiff_t>(simd_find_first_of(array.data(), array.size(), set.data(), set.size()));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline T simd_min(const DynamicArray<T, Allocator, GrowthPolicy> &array) {
+	return simd_min(array.data(), array.size());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline T simd_max(const DynamicArray<T, Allocator, GrowthPolicy> &array) {
+	return simd_max(array.data(), array.size());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename simd_detail::SumType<T>::type simd_sum(const DynamicArray<T, Allocator, GrowthPolicy> &array) {
+	return simd_sum(array.data(), array.size());
+}
+
+#endif // !SIMD_ALGORITHMS_HEADER
@@ -0,0 +1,137 @@
+// The kernels of SimdAlgorithms.h, which are written once for all the instruction sets.
+// The file is included into a namespace, which defines Ops<T> for the instruction set,
+// between the pragmas, which compile its functions for that set. It has no include guard.
+//
+// Ops<T> provides:
+//   reg, lanes - the vector type and the number of elements in it;
+//   load, store, set1 - the unaligned load and store, and the broadcast;
+//   eq(a, b), bits(mask) - the bit mask of the equal lanes, and the number of its set bits;
+//   min, max - the lane-wise minimum and maximum;
+//   acc, zero, add(acc, reg), total(acc) - the accumulator of sum() with wider lanes.
+
+template <typename T>
+size_t find(const T *data, size_t size, T value) {
+	using V = Ops<T>;
+
+	const typename V::reg needle = V::set1(value);
+
+	size_t i = 0;
+	for (; i + V::lanes <= size; i += V::lanes) {
+		const uint64_t mask = V::eq(V::load(data + i), needle);
+		if (mask) {
+			return i + static_cast<size_t>(__builtin_ctzll(mask));
+		}
+	}
+
+	for (; i < size; ++i) {
+		if (data[i] == value) {
+			return i;
+		}
+	}
+
+	return size;
+}
+
+template <typename T>
+size_t count(const T *data, size_t size, T value) {
+	using V = Ops<T>;
+
+	const typename V::reg needle = V::set1(value);
+
+	size_t result = 0;
+	size_t i = 0;
+	for (; i + V::lanes <= size; i += V::lanes) {
+		result += V::bits(V::eq(V::load(data + i), needle));
+	}
+
+	for (; i < size; ++i) {
+		result += data[i] == value;
+	}
+
+	return result;
+}
+
+template <typename T>
+size_t find_first_of(const T *data, size_t size, const T *set, size_t setSize) {
+	using V = Ops<T>;
+
+	typename V::reg needles[MaxSetSize];
+	for (size_t k = 0; k < setSize; ++k) {
+		needles[k] = V::set1(set[k]);
+	}
+
+	size_t i = 0;
+	for (; i + V::lanes <= size; i += V::lanes) {
+		const typename V::reg block = V::load(data + i);
+
+		uint64_t mask = 0;
+		for (size_t k = 0; k < setSize; ++k) {
+			mask |= V::eq(block, needles[k]);
+		}
+
+		if (mask) {
+			return i + static_cast<size_t>(__builtin_ctzll(mask));
+		}
+	}
+
+	for (; i < size; ++i) {
+		for (size_t k = 0; k < setSize; ++k) {
+			if (data[i] == set[k]) {
+				return i;
+			}
+		}
+	}
+
+	return size;
+}
+
+// The array has at least one block. The last block may overlap the one before it,
+// which does not change the result.
+template <typename T>
+T minimum(const T *data, size_t size) {
+	using V = Ops<T>;
+
+	typename V::reg result = V::load(data);
+	for (size_t i = V::lanes; i < size; i += V::lanes) {
+		result = V::min(result, V::load(data + std::min(i, size - V::lanes)));
+	}
+
+	T lanes[V::lanes];
+	V::store(lanes, result);
+
+	return *std::min_element(lanes, lanes + V::lanes);
+}
+
+template <typename T>
+T maximum(const T *data, size_t size) {
+	using V = Ops<T>;
+
+	typename V::reg result = V::load(data);
+	for (size_t i = V::lanes; i < size; i += V::lanes) {
+		result = V::max(result, V::load(data + std::min(i, size - V::lanes)));
+	}
+
+	T lanes[V::lanes];
+	V::store(lanes, result);
+
+	return *std::max_element(lanes, lanes + V::lanes);
+}
+
+template <typename T>
+typename SumType<T>::type sum(const T *data, size_t size) {
+	using V = Ops<T>;
+
+	typename V::acc result = V::zero();
+
+	size_t i = 0;
+	for (; i + V::lanes <= size; i += V::lanes) {
+		result = V::add(result, V::load(data + i));
+	}
+
+	typename SumType<T>::type total = V::total(result);
+	for (; i < size; ++i) {
+		total += data[i];
+	}
+
+	return total;
+}
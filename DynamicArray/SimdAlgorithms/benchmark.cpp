@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+#include "SimdAlgorithms.h"
+
+// Nanoseconds per 1000 elements of the std algorithms over the DynamicArray iterators and
+// of the kernels of every instruction set, from arrays in L1 to arrays in memory.
+
+const char* levelName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::Sse2:
+		return "sse2";
+	case SimdLevel::Avx2:
+		return "avx2";
+	case SimdLevel::Avx512:
+		return "avx512";
+	default:
+		return "scalar";
+	}
+}
+
+// Keeps the results alive, so the work is not optimized away.
+static volatile double sink = 0;
+
+template <typename F>
+double measure(size_t size, F f) {
+	// Every measurement goes over about 32M elements.
+	const size_t repeats = std::max<size_t>(1, (size_t(1) << 25) / size);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < repeats; ++i) {
+		sink = sink + static_cast<double>(f());
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(repeats * size) * 1000;
+}
+
+template <typename T>
+void benchmarkType(const char *name, SimdLevel best) {
+	std::cout << name << ":\n" << std::setw(10) << "size" << std::setw(14) << "" << std::setw(10) << "find" << std::setw(10) << "count"
+		<< std::setw(10) << "first_of" << std::setw(10) << "min" << std::setw(10) << "sum" << '\n';
+
+	const T set[] = { T(101), T(102), T(103), T(104) };
+
+	for (size_t size : { size_t(16), size_t(256), size_t(4096), size_t(65536), size_t(1) << 20, size_t(1) << 24 }) {
+		// The needle is not there, so find goes over the whole array.
+		DynamicArray<T> array(size);
+		for (size_t i = 0; i < size; ++i) {
+			array.push_back(static_cast<T>((i * 2654435761u) % 97));
+		}
+
+		const auto row = [&](const char *label, double find, double count, double firstOf, double min, double sum) {
+			std::cout << std::fixed << std::setprecision(1) << std::setw(10) << size << std::setw(14) << label << std::setw(10) << find << std::setw(10) << count
+				<< std::setw(10) << firstOf << std::setw(10) << min << std::setw(10) << sum << '\n';
+		};
+
+		row("std",
+			measure(size, [&] { return std::find(array.begin(), array.end(), T(100)) - array.begin(); }),
+			measure(size, [&] { return std::count(array.begin(), array.end(), T(100)); }),
+			measure(size, [&] { return std::find_first_of(array.begin(), array.end(), set, set + 4) - array.begin(); }),
+			measure(size, [&] { return *std::min_element(array.begin(), array.end()); }),
+			measure(size, [&] { return std::accumulate(array.begin(), array.end(), typename simd_detail::SumType<T>::type(0)); }));
+
+		for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+			if (level > best) {
+				break;
+			}
+
+			simd_set_level(level);
+			row(levelName(level),
+				measure(size, [&] { return simd_find(array, T(100)) - array.cbegin(); }),
+				measure(size, [&] { return simd_count(array, T(100)); }),
+				measure(size, [&] { return simd_find_first_of(array.data(), array.size(), set, 4); }),
+				measure(size, [&] { return simd_min(array); }),
+				measure(size, [&] { return simd_sum(array); }));
+		}
+
+		simd_set_level(best);
+	}
+}
+
+int main() {
+	const SimdLevel best = simd_level();
+
+	benchmarkType<int32_t>("int32_t", best);
+	benchmarkType<float>("float", best);
+	benchmarkType<uint8_t>("uint8_t", best);
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+#include "SimdAlgorithms.h"
+
+template <typename T>
+DynamicArray<T> makeArray(size_t size) {
+	DynamicArray<T> array(size);
+	for (size_t i = 0; i < size; ++i) {
+		array.push_back(static_cast<T>((i * 2654435761u) % 97));
+	}
+
+	return array;
+}
+
+// Compares the kernels with the std algorithms at the sizes around the vector widths,
+// where the loops switch from the blocks to the tail.
+template <typename T>
+void testType() {
+	const size_t sizes[] = { 0, 1, 3, 4, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 4099 };
+
+	for (size_t size : sizes) {
+		const DynamicArray<T> array = makeArray<T>(size);
+
+		for (T value : { T(0), T(5), T(96), T(100) }) {
+			assert(simd_find(array, value) == std::find(array.begin(), array.end(), value));
+			assert(simd_count(array, value) == static_cast<size_t>(std::count(array.begin(), array.end(), value)));
+		}
+
+		// The last element is the only one, which is found.
+		if (size) {
+			DynamicArray<T> last(size);
+			for (size_t i = 0; i + 1 < size; ++i) {
+				last.push_back(T(1));
+			}
+			last.push_back(T(2));
+
+			assert(simd_find(last, T(2)) == last.cbegin() + static_cast<ptrdiff_t>(size - 1));
+			assert(simd_count(last, T(2)) == 1);
+		}
+
+		DynamicArray<T> set;
+		set.push_back(T(100));
+		set.push_back(T(42));
+		set.push_back(T(7));
+		assert(simd_find_first_of(array, set) == std::find_first_of(array.begin(), array.end(), set.begin(), set.end()));
+
+		// Too large for the vector kernels.
+		DynamicArray<T> large;
+		for (int i = 40; i < 60; ++i) {
+			large.push_back(static_cast<T>(i));
+		}
+		assert(simd_find_first_of(array, large) == std::find_first_of(array.begin(), array.end(), large.begin(), large.end()));
+		assert(simd_find_first_of(array, DynamicArray<T>()) == array.cend());
+
+		using Sum = typename simd_detail::SumType<T>::type;
+		assert(simd_sum(array) == std::accumulate(array.begin(), array.end(), Sum(0)));
+
+		if (size) {
+			assert(simd_min(array) == *std::min_element(array.begin(), array.end()));
+			assert(simd_max(array) == *std::max_element(array.begin(), array.end()));
+		}
+		else {
+			bool thrown = false;
+			try {
+				simd_min(array);
+			}
+			catch (const std::logic_error&) {
+				thrown = true;
+			}
+			assert(thrown);
+		}
+	}
+}
+
+void testExtremes() {
+	DynamicArray<int32_t> ints;
+	for (int i = 0; i < 100; ++i) {
+		ints.push_back(i % 2 ? INT32_MAX : INT32_MIN);
+	}
+
+	// The 64-bit lanes do not overflow.
+	assert(simd_sum(ints) == 50LL * INT32_MAX + 50LL * INT32_MIN);
+	assert(simd_min(ints) == INT32_MIN && simd_max(ints) == INT32_MAX);
+
+	DynamicArray<uint8_t> bytes;
+	for (int i = 0; i < 1000; ++i) {
+		bytes.push_back(255);
+	}
+	bytes[500] = 0;
+	assert(simd_sum(bytes) == 999u * 255u);
+	assert(simd_min(bytes) == 0 && simd_max(bytes) == 255);
+	assert(simd_find(bytes, 0) == bytes.cbegin() + 500);
+
+	DynamicArray<float> floats;
+	for (int i = 0; i < 100; ++i) {
+		floats.push_back(i - 50.5f);
+	}
+	assert(simd_min(floats) == -50.5f && simd_max(floats) == 48.5f);
+	assert(simd_find(floats, -0.5f) == floats.cbegin() + 50);
+	assert(simd_sum(floats) == -100.0);
+}
+
+template <typename T>
+void testAllLevels(SimdLevel best) {
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+		if (level <= best) {
+			assert(simd_set_level(level) == level);
+			testType<T>();
+		}
+	}
+
+	simd_set_level(best);
+}
+
+int main() {
+	const SimdLevel best = simd_level();
+	std::cout << "SIMD level: " << static_cast<int>(best) << '\n';
+
+	testAllLevels<int32_t>(best);
+	testAllLevels<float>(best);
+	testAllLevels<uint8_t>(best);
+
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+		simd_set_level(level);
+		testExtremes();
+	}
+
+	DynamicArray<int32_t> a = makeArray<int32_t>(20);
+	std::cout << simd_sum(a) << ' ' << simd_min(a) << ' ' << simd_max(a) << ' ' << simd_count(a, 5) << '\n';
+
+	return 0;
+}
@@ -0,0 +1,687 @@
+#pragma once
+#ifndef SMALL_DYNAMIC_ARRAY_CLASS_HEADER
+#define SMALL_DYNAMIC_ARRAY_CLASS_HEADER
+
+#include <new>
+#include <memory>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../DynamicArray/DynamicArray.h"
+
+// DynamicArray, which keeps up to N elements inside the object and goes to the heap
+// only when it grows past them. Moving an array with inline elements moves the elements
+// one by one, so it is O(N) instead of O(1). It has the element access and modifiers of
+// DynamicArray with std::allocator and plain pointer iterators, but no custom allocator,
+// growth policy or resize().
+template <typename T, size_t N>
+class SmallDynamicArray {
+	static_assert(N > 0, "The inline capacity must not be zero.");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+public:
+	SmallDynamicArray();
+	SmallDynamicArray(const SmallDynamicArray &r);
+	SmallDynamicArray(SmallDynamicArray &&r) noexcept(std::is_nothrow_move_constructible<T>::value);
+	SmallDynamicArray& operator=(const SmallDynamicArray &rhs);
+	SmallDynamicArray& operator=(SmallDynamicArray &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+	~SmallDynamicArray();
+
+public:
+	reference at(size_type pos);
+	const_reference at(size_type pos) const;
+
+	reference front();
+	const_reference front() const;
+
+	reference back();
+	const_reference back() const;
+
+	reference operator[](size_type pos);
+	const_reference operator[](size_type pos) const;
+
+	pointer data();
+	const_pointer data() const;
+
+	void pop_back();
+	void push_back(const_reference value);
+	void push_back(value_type &&value);
+
+	template <typename... Args>
+	reference emplace_back(Args&&... args);
+
+	void reserve(size_type newCapacity);
+
+	// Moves the elements back inside the object, if they fit.
+	void shrink_to_fit();
+
+	bool empty() const;
+	size_type size() const;
+	size_type capacity() const;
+
+	// True while the elements are stored inside the object.
+	bool is_inline() const;
+
+	iterator erase(const_iterator pos);
+	iterator erase(const_iterator first, const_iterator last);
+
+	// Removes the element by moving the last element into its place. O(1), the order is not kept.
+	iterator swap_erase(const_iterator pos);
+
+	// Removes all the elements satisfying pred in one pass and returns their count.
+	template <typename Predicate>
+	size_type erase_if(Predicate pred);
+
+	iterator insert(const_iterator pos, const_reference value);
+	iterator insert(const_iterator pos, value_type &&value);
+	iterator insert(const_iterator pos, size_type count, const_reference value);
+
+	// The range must not point into this array.
+	template <typename InputIt, typename std::enable_if<!std::is_integral<InputIt>::value, int>::type = 0>
+	iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+	// Destroys the elements and releases the heap storage, if there is any.
+	void clear();
+	void swap(SmallDynamicArray &other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+private:
+	template <typename... Args>
+	void reallocateEmplace(Args&&... args);
+
+	template <typename InputIt>
+	iterator insertRange(const_iterator pos, InputIt first, InputIt last, std::input_iterator_tag);
+	template <typename ForwardIt>
+	iterator insertRange(const_iterator pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+	// Opens a gap of count slots at index and fills it from first, growing the storage at most once.
+	template <typename ForwardIt>
+	void insertCount(size_type index, ForwardIt first, size_type count);
+
+	void reallocate(size_type newCapacity);
+	size_type calcSizeIncrease(size_type newCapacity) const;
+
+	// Takes the elements of other, which is left empty and inline.
+	void moveFrom(SmallDynamicArray &other);
+
+	value_type* inlineData();
+	const value_type* inlineData() const;
+
+	// The element operations are the ones of DynamicArray, with std::allocator.
+	static value_type* allocate(size_type count);
+	static void deallocate(value_type *ptr, size_type count);
+	static void destroy(value_type *first, value_type *last);
+	static void relocate(value_type *first, value_type *last, value_type *dest);
+
+	static constexpr bool isNothrowRelocatable = is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value;
+
+private:
+	value_type *m_data;
+	size_type m_size;
+	size_type m_capacity;
+	alignas(T) unsigned char m_buffer[N * sizeof(T)];
+};
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>::SmallDynamicArray()
+	: m_data(inlineData())
+	, m_size(0)
+	, m_capacity(N) {
+
+}
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>::SmallDynamicArray(const SmallDynamicArray<T, N> &r)
+	: SmallDynamicArray<T, N>() {
+	reserve(r.m_size);
+
+	try {
+		for (; m_size < r.m_size; ++m_size) {
+			new (m_data + m_size) value_type(r.m_data[m_size]);
+		}
+	}
+	catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>::SmallDynamicArray(SmallDynamicArray<T, N> &&r) noexcept(std::is_nothrow_move_constructible<T>::value)
+	: SmallDynamicArray<T, N>() {
+	moveFrom(r);
+}
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>& SmallDynamicArray<T, N>::operator=(const SmallDynamicArray<T, N> &rhs) {
+	if (this != &rhs) {
+		SmallDynamicArray<T, N> tmp(rhs);
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>& SmallDynamicArray<T, N>::operator=(SmallDynamicArray<T, N> &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+	if (this != &rhs) {
+		clear();
+		moveFrom(rhs);
+	}
+
+	return *this;
+}
+
+template <typename T, size_t N>
+inline SmallDynamicArray<T, N>::~SmallDynamicArray() {
+	clear();
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::reference SmallDynamicArray<T, N>::at(size_type pos) {
+	return const_cast<reference>(static_cast<const SmallDynamicArray<T, N>&>(*this).at(pos));
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_reference SmallDynamicArray<T, N>::at(size_type pos) const {
+	if (pos >= m_size) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return m_data[pos];
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::reference SmallDynamicArray<T, N>::front() {
+	return const_cast<reference>(static_cast<const SmallDynamicArray<T, N>&>(*this).front());
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_reference SmallDynamicArray<T, N>::front() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return m_data[0];
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::reference SmallDynamicArray<T, N>::back() {
+	return const_cast<reference>(static_cast<const SmallDynamicArray<T, N>&>(*this).back());
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_reference SmallDynamicArray<T, N>::back() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return m_data[m_size - 1];
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::reference SmallDynamicArray<T, N>::operator[](size_type pos) {
+	return m_data[pos];
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_reference SmallDynamicArray<T, N>::operator[](size_type pos) const {
+	return m_data[pos];
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::pointer SmallDynamicArray<T, N>::data() {
+	return m_data;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_pointer SmallDynamicArray<T, N>::data() const {
+	return m_data;
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::pop_back() {
+	if (!empty()) {
+		--m_size;
+		m_data[m_size].~value_type();
+	}
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::push_back(const_reference value) {
+	emplace_back(value);
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::push_back(value_type &&value) {
+	emplace_back(std::move(value));
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+inline typename SmallDynamicArray<T, N>::reference SmallDynamicArray<T, N>::emplace_back(Args&&... args) {
+	if (m_size >= m_capacity) {
+		// The arguments might refer to an element of the array, so they are used
+		// before the old storage is released.
+		reallocateEmplace(std::forward<Args>(args)...);
+	}
+	else {
+		new (m_data + m_size) value_type(std::forward<Args>(args)...);
+	}
+
+	++m_size;
+	return m_data[m_size - 1];
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::reserve(size_type newCapacity) {
+	if (newCapacity > m_capacity) {
+		reallocate(calcSizeIncrease(newCapacity));
+	}
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::shrink_to_fit() {
+	if (!is_inline()) {
+		reallocate(m_size);
+	}
+}
+
+template <typename T, size_t N>
+inline bool SmallDynamicArray<T, N>::empty() const {
+	return !size();
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::size_type SmallDynamicArray<T, N>::size() const {
+	return m_size;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::size_type SmallDynamicArray<T, N>::capacity() const {
+	return m_capacity;
+}
+
+template <typename T, size_t N>
+inline bool SmallDynamicArray<T, N>::is_inline() const {
+	return m_data == inlineData();
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::erase(const_iterator pos) {
+	if (pos >= end()) {
+		return end();
+	}
+
+	return erase(pos, pos + 1);
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::erase(const_iterator first, const_iterator last) {
+	const size_type from = first - m_data;
+	const size_type to = last - m_data;
+
+	if (from < to) {
+		std::allocator<value_type> allocator;
+		dynamic_array_detail::eraseRange(allocator, m_data, m_size, from, to);
+	}
+
+	return m_data + from;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::swap_erase(const_iterator pos) {
+	const size_type i = pos - m_data;
+	if (i >= m_size) {
+		return end();
+	}
+
+	const size_type last = m_size - 1;
+	if (i != last) {
+		if (is_trivially_relocatable<T>::value) {
+			m_data[i].~value_type();
+			std::memcpy(static_cast<void*>(m_data + i), static_cast<const void*>(m_data + last), sizeof(value_type));
+			--m_size;
+
+			return m_data + i;
+		}
+
+		m_data[i] = std::move(m_data[last]);
+	}
+
+	pop_back();
+	return m_data + i;
+}
+
+template <typename T, size_t N>
+template <typename Predicate>
+inline typename SmallDynamicArray<T, N>::size_type SmallDynamicArray<T, N>::erase_if(Predicate pred) {
+	std::allocator<value_type> allocator;
+	return dynamic_array_detail::eraseIf(allocator, m_data, m_size, pred);
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insert(const_iterator pos, const_reference value) {
+	return insert(pos, value_type(value));
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insert(const_iterator pos, value_type &&value) {
+	const size_type index = pos - m_data;
+
+	// The value might be an element of the array, which is about to move.
+	value_type tmp(std::move(value));
+	insertCount(index, std::make_move_iterator(&tmp), 1);
+
+	return m_data + index;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insert(const_iterator pos, size_type count, const_reference value) {
+	const size_type index = pos - m_data;
+	if (!count) {
+		return m_data + index;
+	}
+
+	const value_type tmp(value);
+	insertCount(index, dynamic_array_detail::RepeatIterator<T>(tmp), count);
+
+	return m_data + index;
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename std::enable_if<!std::is_integral<InputIt>::value, int>::type>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insert(const_iterator pos, InputIt first, InputIt last) {
+	return insertRange(pos, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::clear() {
+	destroy(m_data, m_data + m_size);
+
+	if (!is_inline()) {
+		deallocate(m_data, m_capacity);
+		m_data = inlineData();
+		m_capacity = N;
+	}
+
+	m_size = 0;
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::swap(SmallDynamicArray<T, N> &other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+	if (this == &other) {
+		return;
+	}
+
+	if (!is_inline() && !other.is_inline()) {
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		std::swap(m_capacity, other.m_capacity);
+		return;
+	}
+
+	// At least one side is inline, its elements have to move.
+	SmallDynamicArray<T, N> tmp(std::move(other));
+	other.moveFrom(*this);
+	moveFrom(tmp);
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+inline void SmallDynamicArray<T, N>::reallocateEmplace(Args&&... args) {
+	const size_type newCapacity = calcSizeIncrease(m_size + 1);
+	value_type *tmp = allocate(newCapacity);
+
+	try {
+		new (tmp + m_size) value_type(std::forward<Args>(args)...);
+	}
+	catch (...) {
+		deallocate(tmp, newCapacity);
+		throw;
+	}
+
+	try {
+		relocate(m_data, m_data + m_size, tmp);
+	}
+	catch (...) {
+		tmp[m_size].~value_type();
+		deallocate(tmp, newCapacity);
+		throw;
+	}
+
+	if (!is_inline()) {
+		deallocate(m_data, m_capacity);
+	}
+
+	m_data = tmp;
+	m_capacity = newCapacity;
+}
+
+template <typename T, size_t N>
+template <typename InputIt>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insertRange(const_iterator pos, InputIt first, InputIt last, std::input_iterator_tag) {
+	// The length of a single pass range is unknown, it is collected first, so the array grows only once.
+	SmallDynamicArray<T, N> tmp;
+	for (; first != last; ++first) {
+		tmp.emplace_back(*first);
+	}
+
+	const size_type index = pos - m_data;
+	insertCount(index, std::make_move_iterator(tmp.m_data), tmp.m_size);
+
+	return m_data + index;
+}
+
+template <typename T, size_t N>
+template <typename ForwardIt>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::insertRange(const_iterator pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+	const size_type index = pos - m_data;
+	insertCount(index, first, static_cast<size_type>(std::distance(first, last)));
+
+	return m_data + index;
+}
+
+template <typename T, size_t N>
+template <typename ForwardIt>
+inline void SmallDynamicArray<T, N>::insertCount(size_type index, ForwardIt first, size_type count) {
+	if (!count) {
+		return;
+	}
+
+	std::allocator<value_type> allocator;
+
+	if (m_size + count > m_capacity) {
+		const size_type newCapacity = calcSizeIncrease(m_size + count);
+
+		if (isNothrowRelocatable) {
+			// The new elements go straight to the heap, the old ones are relocated around them.
+			value_type *tmp = allocate(newCapacity);
+
+			try {
+				dynamic_array_detail::constructRange(allocator, tmp + index, first, count);
+			}
+			catch (...) {
+				deallocate(tmp, newCapacity);
+				throw;
+			}
+
+			relocate(m_data, m_data + index, tmp);
+			relocate(m_data + index, m_data + m_size, tmp + index + count);
+
+			if (!is_inline()) {
+				deallocate(m_data, m_capacity);
+			}
+
+			m_data = tmp;
+			m_size += count;
+			m_capacity = newCapacity;
+			return;
+		}
+
+		reallocate(newCapacity);
+	}
+
+	dynamic_array_detail::insertInPlace(allocator, m_data, m_size, index, first, count);
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::reallocate(size_type newCapacity) {
+	if (newCapacity < m_size) {
+		newCapacity = m_size;
+	}
+
+	// The inline buffer is used whenever the elements fit.
+	const bool toInline = newCapacity <= N;
+	if (toInline) {
+		if (is_inline()) {
+			return;
+		}
+
+		newCapacity = N;
+	}
+	else if (newCapacity == m_capacity) {
+		return;
+	}
+
+	value_type *tmp = toInline ? inlineData() : allocate(newCapacity);
+
+	try {
+		relocate(m_data, m_data + m_size, tmp);
+	}
+	catch (...) {
+		if (!toInline) {
+			deallocate(tmp, newCapacity);
+		}
+
+		throw;
+	}
+
+	if (!is_inline()) {
+		deallocate(m_data, m_capacity);
+	}
+
+	m_data = tmp;
+	m_capacity = newCapacity;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::size_type SmallDynamicArray<T, N>::calcSizeIncrease(size_type newCapacity) const {
+	if (newCapacity < m_capacity) {
+		return m_capacity;
+	}
+
+	size_type resultCapacity = m_capacity * 2;
+	return resultCapacity < newCapacity ? newCapacity : resultCapacity;
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::moveFrom(SmallDynamicArray<T, N> &other) {
+	if (!other.is_inline()) {
+		// The heap storage changes hands, the elements stay where they are.
+		m_data = other.m_data;
+		m_size = other.m_size;
+		m_capacity = other.m_capacity;
+
+		other.m_data = other.inlineData();
+		other.m_size = 0;
+		other.m_capacity = N;
+		return;
+	}
+
+	relocate(other.m_data, other.m_data + other.m_size, m_data);
+	m_size = other.m_size;
+	other.m_size = 0;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::value_type* SmallDynamicArray<T, N>::inlineData() {
+	return reinterpret_cast<value_type*>(m_buffer);
+}
+
+template <typename T, size_t N>
+inline const typename SmallDynamicArray<T, N>::value_type* SmallDynamicArray<T, N>::inlineData() const {
+	return reinterpret_cast<const value_type*>(m_buffer);
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::value_type* SmallDynamicArray<T, N>::allocate(size_type count) {
+	return std::allocator<value_type>().allocate(count);
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::deallocate(value_type *ptr, size_type count) {
+	std::allocator<value_type>().deallocate(ptr, count);
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::destroy(value_type *first, value_type *last) {
+	std::allocator<value_type> allocator;
+	dynamic_array_detail::destroy(allocator, first, last);
+}
+
+template <typename T, size_t N>
+inline void SmallDynamicArray<T, N>::relocate(value_type *first, value_type *last, value_type *dest) {
+	std::allocator<value_type> allocator;
+	dynamic_array_detail::relocate(allocator, first, last, dest);
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::begin() {
+	return m_data;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::iterator SmallDynamicArray<T, N>::end() {
+	return m_data + m_size;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_iterator SmallDynamicArray<T, N>::begin() const {
+	return m_data;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_iterator SmallDynamicArray<T, N>::end() const {
+	return m_data + m_size;
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_iterator SmallDynamicArray<T, N>::cbegin() const {
+	return begin();
+}
+
+template <typename T, size_t N>
+inline typename SmallDynamicArray<T, N>::const_iterator SmallDynamicArray<T, N>::cend() const {
+	return end();
+}
+
+/* std::swap */
+template <typename T, size_t N>
+inline void swap(SmallDynamicArray<T, N> &lhs, SmallDynamicArray<T, N> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+	lhs.swap(rhs);
+}
+
+#endif // !SMALL_DYNAMIC_ARRAY_CLASS_HEADER
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include "SmallDynamicArray.h"
+
+// Every heap allocation of the process is counted.
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+	++allocations;
+
+	if (void *ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+// Many short lived arrays of 1-8 tags, like the per-request tags.
+template <typename Array>
+size_t buildArrays(int arrays) {
+	size_t total = 0;
+
+	for (int i = 0; i < arrays; ++i) {
+		Array tags;
+
+		const int count = 1 + i % 8;
+		for (int j = 0; j < count; ++j) {
+			tags.push_back(i + j);
+		}
+
+		total += tags.size();
+	}
+
+	return total;
+}
+
+template <typename F>
+void measure(const char *name, F f) {
+	const size_t before = allocations;
+
+	const auto start = std::chrono::steady_clock::now();
+	const size_t total = f();
+	const auto end = std::chrono::steady_clock::now();
+
+	std::cout << name << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+		<< allocations - before << " allocations (" << total << " elements)\n";
+}
+
+int main(int argc, char **argv) {
+	const int arrays = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+	measure("DynamicArray<int>:         ", [=]() { return buildArrays<DynamicArray<int>>(arrays); });
+	measure("SmallDynamicArray<int, 4>: ", [=]() { return buildArrays<SmallDynamicArray<int, 4>>(arrays); });
+	measure("SmallDynamicArray<int, 8>: ", [=]() { return buildArrays<SmallDynamicArray<int, 8>>(arrays); });
+
+	return 0;
+}
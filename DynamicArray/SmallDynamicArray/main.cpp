@@ -0,0 +1,185 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <iterator>
+#include <list>
+
+#include "SmallDynamicArray.h"
+
+// Counts the live objects.
+struct Tracked {
+	static int alive;
+
+	int value;
+
+	Tracked(int value = 0) : value(value) { ++alive; }
+	Tracked(const Tracked &r) : value(r.value) { ++alive; }
+	Tracked(Tracked &&r) noexcept : value(r.value) { ++alive; }
+	Tracked& operator=(const Tracked &rhs) { value = rhs.value; return *this; }
+	Tracked& operator=(Tracked &&rhs) noexcept { value = rhs.value; return *this; }
+	~Tracked() { --alive; }
+};
+
+int Tracked::alive = 0;
+
+void testInlineAndHeap() {
+	SmallDynamicArray<int, 4> a;
+	assert(a.is_inline() && a.capacity() == 4);
+
+	for (int i = 0; i < 4; ++i) {
+		a.push_back(i);
+	}
+
+	assert(a.is_inline());
+
+	// The argument refers to an inline element, which moves to the heap.
+	a.push_back(a[0]);
+	assert(!a.is_inline() && a.capacity() == 8);
+	assert(a.back() == 0 && a.size() == 5);
+
+	a.insert(a.begin(), -1);
+	a.erase(a.begin() + 1, a.begin() + 3);
+	assert(a.size() == 4 && a.front() == -1 && a[1] == 2);
+
+	a.shrink_to_fit();
+	assert(a.is_inline() && a.capacity() == 4);
+	assert(a[0] == -1 && a[1] == 2 && a[2] == 3 && a[3] == 0);
+
+	a.clear();
+	assert(a.empty() && a.is_inline());
+}
+
+void testMovesAndSwaps() {
+	{
+		SmallDynamicArray<std::string, 2> small;
+		small.push_back(std::string(40, 'a'));
+
+		SmallDynamicArray<std::string, 2> large;
+		for (int i = 0; i < 10; ++i) {
+			large.push_back(std::string(40, char('b' + i)));
+		}
+
+		const std::string *heap = large.data();
+
+		// An inline array moves its elements, a heap array hands over its storage.
+		SmallDynamicArray<std::string, 2> movedSmall(std::move(small));
+		assert(movedSmall.is_inline() && movedSmall.size() == 1 && small.empty());
+
+		SmallDynamicArray<std::string, 2> movedLarge(std::move(large));
+		assert(movedLarge.data() == heap && large.empty() && large.is_inline());
+
+		movedSmall.swap(movedLarge);
+		assert(movedSmall.data() == heap && movedSmall.size() == 10);
+		assert(movedLarge.is_inline() && movedLarge.size() == 1 && movedLarge[0] == std::string(40, 'a'));
+
+		swap(movedSmall, movedLarge);
+		assert(movedSmall.is_inline() && movedLarge.size() == 10);
+
+		SmallDynamicArray<std::string, 2> other;
+		other.push_back("x");
+		other.push_back("y");
+		other.swap(movedSmall);
+		assert(other.size() == 1 && movedSmall.size() == 2 && movedSmall[1] == "y");
+
+		movedSmall = movedLarge;
+		assert(movedSmall.size() == 10 && movedSmall[9] == std::string(40, 'k'));
+
+		movedLarge = std::move(other);
+		assert(movedLarge.is_inline() && movedLarge.size() == 1 && other.empty());
+	}
+
+	{
+		SmallDynamicArray<Tracked, 3> a;
+		for (int i = 0; i < 3; ++i) {
+			a.emplace_back(i);
+		}
+
+		SmallDynamicArray<Tracked, 3> b(a);
+		b.emplace_back(3);
+		b.insert(b.begin() + 1, Tracked(10));
+		assert(b[1].value == 10 && b[4].value == 3);
+
+		a.swap(b);
+		assert(a.size() == 5 && b.size() == 3);
+		assert(Tracked::alive == 8);
+
+		a = std::move(b);
+		assert(Tracked::alive == 3);
+	}
+
+	assert(Tracked::alive == 0);
+}
+
+void testRanges() {
+	SmallDynamicArray<std::string, 4> a;
+	a.push_back(std::string(40, 'a'));
+	a.push_back(std::string(40, 'b'));
+
+	// Erasing the end is a no-op, like in DynamicArray.
+	assert(a.erase(a.end()) == a.end() && a.size() == 2);
+
+	// Fills with an inline element, while the elements move to the heap.
+	SmallDynamicArray<std::string, 4>::iterator it = a.insert(a.begin() + 1, 3, a[0]);
+	assert(!a.is_inline() && it == a.begin() + 1 && a.size() == 5);
+	assert(a[3] == std::string(40, 'a') && a[4] == std::string(40, 'b'));
+
+	std::list<std::string> list = { "x", "y" };
+	a.insert(a.end(), list.begin(), list.end());
+	assert(a.size() == 7 && a[5] == "x" && a[6] == "y");
+
+	assert(a.erase_if([](const std::string &s) { return s.size() == 40 && s[0] == 'a'; }) == 4);
+	assert(a.size() == 3 && a[0] == std::string(40, 'b'));
+
+	it = a.swap_erase(a.begin());
+	assert(*it == "y" && a.size() == 2 && a[1] == "x");
+	assert(a.swap_erase(a.end()) == a.end());
+
+	a.shrink_to_fit();
+	assert(a.is_inline());
+
+	// A single pass range.
+	SmallDynamicArray<int, 4> numbers;
+	numbers.push_back(1);
+	numbers.push_back(2);
+
+	std::istringstream in("3 4 5 6 7");
+	numbers.insert(numbers.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+	assert(numbers.size() == 7 && numbers[1] == 3 && numbers[5] == 7 && numbers[6] == 2);
+
+	numbers.insert(numbers.end(), 2, 0);
+	assert(numbers.erase_if([](int n) { return n % 2 == 0; }) == 5);
+	assert(numbers.size() == 4 && numbers[0] == 1 && numbers[3] == 7);
+
+	{
+		SmallDynamicArray<Tracked, 2> tracked;
+		tracked.insert(tracked.end(), 10, Tracked(7));
+		assert(Tracked::alive == 10);
+
+		tracked.erase(tracked.end());
+		tracked.swap_erase(tracked.begin());
+		assert(Tracked::alive == 9);
+	}
+
+	assert(Tracked::alive == 0);
+}
+
+int main() {
+	SmallDynamicArray<int, 8> a;
+	for (int i = 0; i < 10; ++i) {
+		a.insert(a.begin(), i);
+	}
+
+	std::cout << a.at(5) << "\n\n";
+
+	for (int value : a) {
+		std::cout << value << '\n';
+	}
+
+	testInlineAndHeap();
+	testMovesAndSwaps();
+	testRanges();
+
+	return 0;
+}
@@ -0,0 +1,556 @@
+#pragma once
+#ifndef SOA_ARRAY_HEADER
+#define SOA_ARRAY_HEADER
+
+#include <tuple>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../DynamicArray/DynamicArray.h"
+
+namespace soa_detail {
+
+// Evaluates a pack expansion in order: (void)Expand{ 0, (expression, 0)... };
+using Expand = int[];
+
+} // namespace soa_detail
+
+// A contiguous run of the values of one field.
+template <typename T>
+class ColumnSpan {
+public:
+	using value_type = typename std::remove_const<T>::type;
+	using size_type = size_t;
+	using iterator = T*;
+
+public:
+	ColumnSpan(T *data, size_type size)
+		: m_data(data)
+		, m_size(size) {
+
+	}
+
+	T* data() const { return m_data; }
+	size_type size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	iterator begin() const { return m_data; }
+	iterator end() const { return m_data + m_size; }
+
+	T& operator[](size_type pos) const { return m_data[pos]; }
+
+private:
+	T *m_data;
+	size_type m_size;
+};
+
+// An array of records, which keeps each field in a DynamicArray of its own, so a scan over
+// a few fields reads only their columns instead of whole records. The records go in and
+// out as std::tuple<Fields...>, a row is accessed through a proxy, and column<I>() gives
+// the I-th field of all the rows as a contiguous span. The columns always grow together
+// to the same capacity, and an append, which throws, leaves all of them unchanged.
+template <typename... Fields>
+class SoAArray {
+	static_assert(sizeof...(Fields) > 0, "A record needs at least one field.");
+
+	using Indices = std::index_sequence_for<Fields...>;
+
+public:
+	using value_type = std::tuple<Fields...>;
+	using size_type = size_t;
+
+	template <size_t I>
+	using field_type = typename std::tuple_element<I, value_type>::type;
+
+	template <typename ArrayType>
+	class basic_reference;
+
+	using reference = basic_reference<SoAArray>;
+	using const_reference = basic_reference<const SoAArray>;
+
+	template <typename ArrayType>
+	class basic_iterator;
+
+	using iterator = basic_iterator<SoAArray>;
+	using const_iterator = basic_iterator<const SoAArray>;
+
+public:
+	explicit SoAArray(size_type capacity = 0);
+
+public:
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+	reference at(size_type pos);
+	const_reference at(size_type pos) const;
+
+	reference front();
+	const_reference front() const;
+
+	reference back();
+	const_reference back() const;
+
+	reference operator[](size_type pos);
+	const_reference operator[](size_type pos) const;
+
+	// The I-th field of all the rows. The span is invalidated by growth, like the pointers.
+	template <size_t I>
+	ColumnSpan<field_type<I>> column();
+
+	template <size_t I>
+	ColumnSpan<const field_type<I>> column() const;
+
+	void pop_back();
+	void push_back(const value_type &record);
+	void push_back(value_type &&record);
+
+	// Takes one constructor argument per field.
+	template <typename... Args>
+	reference emplace_back(Args&&... args);
+
+	// Appends value-initialized records or drops the last ones.
+	void resize(size_type count);
+
+	void reserve(size_type newCapacity);
+	void shrink_to_fit();
+
+	bool empty() const;
+	size_type size() const;
+	size_type capacity() const;
+
+	void clear();
+	void swap(SoAArray &other);
+
+private:
+	template <typename Tuple, size_t... I>
+	void emplaceFields(Tuple &&args, std::index_sequence<I...>);
+
+	template <typename Tuple, size_t... I>
+	void appendFields(Tuple &&args, std::index_sequence<I...>);
+
+	template <size_t... I>
+	void popFields(size_type count, std::index_sequence<I...>);
+
+	template <size_t... I>
+	void reserveFields(size_type newCapacity, std::index_sequence<I...>);
+
+	template <size_t... I>
+	void shrinkFields(std::index_sequence<I...>);
+
+	template <size_t... I>
+	void clearFields(std::index_sequence<I...>);
+
+	template <size_t... I>
+	size_type minCapacity(std::index_sequence<I...>) const;
+
+private:
+	std::tuple<DynamicArray<Fields>...> m_columns;
+};
+
+/* --- ROW REFERENCE --- */
+
+// A proxy of a row. Assigning a record or another row assigns the fields.
+template <typename... Fields>
+template <typename ArrayType>
+class SoAArray<Fields...>::basic_reference {
+	friend class SoAArray<Fields...>;
+
+public:
+	template <size_t I>
+	auto get() const -> decltype(std::get<I>(std::declval<ArrayType&>().m_columns)[0]) {
+		return std::get<I>(m_array->m_columns)[m_pos];
+	}
+
+	operator value_type() const {
+		return toRecord(Indices());
+	}
+
+	const basic_reference& operator=(const value_type &record) const {
+		assign(record, Indices());
+		return *this;
+	}
+
+	const basic_reference& operator=(const basic_reference &r) const {
+		return *this = static_cast<value_type>(r);
+	}
+
+	// The row converts to the const row.
+	template <typename OtherArray, typename = typename std::enable_if<std::is_convertible<OtherArray*, ArrayType*>::value>::type>
+	basic_reference(const basic_reference<OtherArray> &r)
+		: m_array(r.m_array)
+		, m_pos(r.m_pos) {
+
+	}
+
+	basic_reference(const basic_reference&) = default;
+
+private:
+	template <typename OtherArray>
+	friend class basic_reference;
+
+	basic_reference(ArrayType *array, size_t pos)
+		: m_array(array)
+		, m_pos(pos) {
+
+	}
+
+	template <size_t... I>
+	value_type toRecord(std::index_sequence<I...>) const {
+		return value_type(get<I>()...);
+	}
+
+	template <size_t... I>
+	void assign(const value_type &record, std::index_sequence<I...>) const {
+		(void)soa_detail::Expand{ 0, (get<I>() = std::get<I>(record), 0)... };
+	}
+
+private:
+	ArrayType *m_array;
+	size_t m_pos;
+};
+
+/* --- ITERATOR --- */
+
+// Dereferencing gives a row proxy by value, like std::vector<bool>.
+template <typename... Fields>
+template <typename ArrayType>
+class SoAArray<Fields...>::basic_iterator {
+	friend class SoAArray<Fields...>;
+
+	template <typename OtherArray>
+	friend class basic_iterator;
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = typename SoAArray<Fields...>::value_type;
+	using difference_type = ptrdiff_t;
+	using reference = basic_reference<ArrayType>;
+	using pointer = void;
+
+public:
+	basic_iterator()
+		: m_array(nullptr)
+		, m_pos(0) {
+
+	}
+
+	// The iterator converts to the const_iterator.
+	template <typename OtherArray, typename = typename std::enable_if<std::is_convertible<OtherArray*, ArrayType*>::value>::type>
+	basic_iterator(const basic_iterator<OtherArray> &r)
+		: m_array(r.m_array)
+		, m_pos(r.m_pos) {
+
+	}
+
+	reference operator*() const { return reference(m_array, m_pos); }
+	reference operator[](difference_type n) const { return reference(m_array, m_pos + static_cast<size_t>(n)); }
+
+	basic_iterator& operator++() { ++m_pos; return *this; }
+	basic_iterator operator++(int) { basic_iterator result(*this); ++m_pos; return result; }
+	basic_iterator& operator--() { --m_pos; return *this; }
+	basic_iterator operator--(int) { basic_iterator result(*this); --m_pos; return result; }
+
+	basic_iterator& operator+=(difference_type n) { m_pos += static_cast<size_t>(n); return *this; }
+	basic_iterator& operator-=(difference_type n) { m_pos -= static_cast<size_t>(n); return *this; }
+
+	basic_iterator operator+(difference_type n) const { basic_iterator result(*this); return result += n; }
+	basic_iterator operator-(difference_type n) const { basic_iterator result(*this); return result -= n; }
+	friend basic_iterator operator+(difference_type n, const basic_iterator &it) { return it + n; }
+
+	template <typename OtherArray>
+	difference_type operator-(const basic_iterator<OtherArray> &r) const { return static_cast<difference_type>(m_pos - r.m_pos); }
+
+	template <typename OtherArray>
+	bool operator==(const basic_iterator<OtherArray> &r) const { return m_pos == r.m_pos; }
+
+	template <typename OtherArray>
+	bool operator!=(const basic_iterator<OtherArray> &r) const { return m_pos != r.m_pos; }
+
+	template <typename OtherArray>
+	bool operator<(const basic_iterator<OtherArray> &r) const { return m_pos < r.m_pos; }
+
+	template <typename OtherArray>
+	bool operator>(const basic_iterator<OtherArray> &r) const { return m_pos > r.m_pos; }
+
+	template <typename OtherArray>
+	bool operator<=(const basic_iterator<OtherArray> &r) const { return m_pos <= r.m_pos; }
+
+	template <typename OtherArray>
+	bool operator>=(const basic_iterator<OtherArray> &r) const { return m_pos >= r.m_pos; }
+
+private:
+	basic_iterator(ArrayType *array, size_t pos)
+		: m_array(array)
+		, m_pos(pos) {
+
+	}
+
+private:
+	ArrayType *m_array;
+	size_t m_pos;
+};
+
+/* --- SOA ARRAY --- */
+
+template <typename... Fields>
+inline SoAArray<Fields...>::SoAArray(size_type capacity)
+	: m_columns() {
+	reserve(capacity);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::iterator SoAArray<Fields...>::begin() {
+	return iterator(this, 0);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::iterator SoAArray<Fields...>::end() {
+	return iterator(this, size());
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_iterator SoAArray<Fields...>::begin() const {
+	return const_iterator(this, 0);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_iterator SoAArray<Fields...>::end() const {
+	return const_iterator(this, size());
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_iterator SoAArray<Fields...>::cbegin() const {
+	return begin();
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_iterator SoAArray<Fields...>::cend() const {
+	return end();
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::reference SoAArray<Fields...>::at(size_type pos) {
+	if (pos >= size()) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return reference(this, pos);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::at(size_type pos) const {
+	if (pos >= size()) {
+		throw std::out_of_range("Invalid position!");
+	}
+
+	return const_reference(this, pos);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::reference SoAArray<Fields...>::front() {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return reference(this, 0);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::front() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return const_reference(this, 0);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::reference SoAArray<Fields...>::back() {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return reference(this, size() - 1);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::back() const {
+	if (empty()) {
+		throw std::logic_error("Empty array!");
+	}
+
+	return const_reference(this, size() - 1);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::reference SoAArray<Fields...>::operator[](size_type pos) {
+	return reference(this, pos);
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::const_reference SoAArray<Fields...>::operator[](size_type pos) const {
+	return const_reference(this, pos);
+}
+
+template <typename... Fields>
+template <size_t I>
+inline ColumnSpan<typename SoAArray<Fields...>::template field_type<I>> SoAArray<Fields...>::column() {
+	DynamicArray<field_type<I>> &values = std::get<I>(m_columns);
+	return ColumnSpan<field_type<I>>(values.data(), values.size());
+}
+
+template <typename... Fields>
+template <size_t I>
+inline ColumnSpan<const typename SoAArray<Fields...>::template field_type<I>> SoAArray<Fields...>::column() const {
+	const DynamicArray<field_type<I>> &values = std::get<I>(m_columns);
+	return ColumnSpan<const field_type<I>>(values.data(), values.size());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::pop_back() {
+	popFields(sizeof...(Fields), Indices());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::push_back(const value_type &record) {
+	emplaceFields(record, Indices());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::push_back(value_type &&record) {
+	emplaceFields(std::move(record), Indices());
+}
+
+template <typename... Fields>
+template <typename... Args>
+inline typename SoAArray<Fields...>::reference SoAArray<Fields...>::emplace_back(Args&&... args) {
+	static_assert(sizeof...(Args) == sizeof...(Fields), "Pass one argument per field.");
+
+	emplaceFields(std::forward_as_tuple(std::forward<Args>(args)...), Indices());
+	return reference(this, size() - 1);
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::resize(size_type count) {
+	reserve(count);
+	while (size() < count) {
+		emplaceFields(value_type(), Indices());
+	}
+	while (size() > count) {
+		pop_back();
+	}
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::reserve(size_type newCapacity) {
+	reserveFields(newCapacity, Indices());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::shrink_to_fit() {
+	shrinkFields(Indices());
+}
+
+template <typename... Fields>
+inline bool SoAArray<Fields...>::empty() const {
+	return size() == 0;
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::size_type SoAArray<Fields...>::size() const {
+	return std::get<0>(m_columns).size();
+}
+
+template <typename... Fields>
+inline typename SoAArray<Fields...>::size_type SoAArray<Fields...>::capacity() const {
+	return minCapacity(Indices());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::clear() {
+	clearFields(Indices());
+}
+
+template <typename... Fields>
+inline void SoAArray<Fields...>::swap(SoAArray &other) {
+	m_columns.swap(other.m_columns);
+}
+
+template <typename... Fields>
+template <typename Tuple, size_t... I>
+inline void SoAArray<Fields...>::emplaceFields(Tuple &&args, std::index_sequence<I...>) {
+	if (size() < capacity()) {
+		appendFields(std::forward<Tuple>(args), Indices());
+		return;
+	}
+
+	// The arguments might refer to the rows, so the record is built before the columns move.
+	value_type record(std::get<I>(std::forward<Tuple>(args))...);
+
+	// All the columns grow at once, so the appends below do not reallocate one by one.
+	reserve(capacity() ? capacity() * 2 : 8);
+	appendFields(std::move(record), Indices());
+}
+
+template <typename... Fields>
+template <typename Tuple, size_t... I>
+inline void SoAArray<Fields...>::appendFields(Tuple &&args, std::index_sequence<I...>) {
+	size_type appended = 0;
+	try {
+		(void)soa_detail::Expand{ 0, (std::get<I>(m_columns).emplace_back(std::get<I>(std::forward<Tuple>(args))), ++appended, 0)... };
+	}
+	catch (...) {
+		popFields(appended, Indices());
+		throw;
+	}
+}
+
+template <typename... Fields>
+template <size_t... I>
+inline void SoAArray<Fields...>::popFields(size_type count, std::index_sequence<I...>) {
+	(void)soa_detail::Expand{ 0, (I < count ? (std::get<I>(m_columns).pop_back(), 0) : 0)... };
+}
+
+template <typename... Fields>
+template <size_t... I>
+inline void SoAArray<Fields...>::reserveFields(size_type newCapacity, std::index_sequence<I...>) {
+	(void)soa_detail::Expand{ 0, (newCapacity > std::get<I>(m_columns).capacity() ? (std::get<I>(m_columns).reserve(newCapacity), 0) : 0)... };
+}
+
+template <typename... Fields>
+template <size_t... I>
+inline void SoAArray<Fields...>::shrinkFields(std::index_sequence<I...>) {
+	(void)soa_detail::Expand{ 0, (std::get<I>(m_columns).shrink_to_fit(), 0)... };
+}
+
+template <typename... Fields>
+template <size_t... I>
+inline void SoAArray<Fields...>::clearFields(std::index_sequence<I...>) {
+	(void)soa_detail::Expand{ 0, (std::get<I>(m_columns).clear(), 0)... };
+}
+
+template <typename... Fields>
+template <size_t... I>
+inline typename SoAArray<Fields...>::size_type SoAArray<Fields...>::minCapacity(std::index_sequence<I...>) const {
+	size_type result = std::get<0>(m_columns).capacity();
+	(void)soa_detail::Expand{ 0, (result = std::min(result, std::get<I>(m_columns).capacity()), 0)... };
+
+	return result;
+}
+
+template <typename... Fields>
+inline void swap(SoAArray<Fields...> &lhs, SoAArray<Fields...> &rhs) {
+	lhs.swap(rhs);
+}
+
+#endif // !SOA_ARRAY_HEADER
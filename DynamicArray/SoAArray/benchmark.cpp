@@ -0,0 +1,110 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+
+#include "../DynamicArray/DynamicArray.h"
+#include "SoAArray.h"
+
+// Scans of 10M 40-byte records in milliseconds: DynamicArray<Record> against SoAArray
+// with the same fields, summing one field and the product of two fields.
+
+const size_t Count = 10 * 1000 * 1000;
+const int Repeats = 10;
+
+struct Record {
+	uint64_t id;
+	double price;
+	double quantity;
+	uint32_t category;
+	uint32_t flags;
+	uint64_t timestamp;
+};
+
+using Records = SoAArray<uint64_t, double, double, uint32_t, uint32_t, uint64_t>;
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+void measure(const char *name, F f) {
+	double result = 0;
+
+	const auto start = Clock::now();
+	for (int i = 0; i < Repeats; ++i) {
+		result += f();
+	}
+	const auto end = Clock::now();
+
+	std::cout << "  " << name << ": " << std::chrono::duration<double, std::milli>(end - start).count() / Repeats << " ms (" << result << ")\n";
+}
+
+int main() {
+	static_assert(sizeof(Record) == 40, "The record should be 40 bytes.");
+
+	DynamicArray<Record> rows;
+	Records columns;
+	for (size_t i = 0; i < Count; ++i) {
+		const Record record = { i, static_cast<double>(i % 100), static_cast<double>(i % 7), static_cast<uint32_t>(i % 13), 0, i };
+
+		rows.push_back(record);
+		columns.emplace_back(record.id, record.price, record.quantity, record.category, record.flags, record.timestamp);
+	}
+
+	std::cout << "Sum of the prices:\n";
+	measure("DynamicArray<Record>", [&] {
+		double sum = 0;
+		for (const Record &record : rows) {
+			sum += record.price;
+		}
+
+		return sum;
+	});
+	measure("SoAArray", [&] {
+		double sum = 0;
+		for (double price : columns.column<1>()) {
+			sum += price;
+		}
+
+		return sum;
+	});
+
+	std::cout << "Sum of the category IDs:\n";
+	measure("DynamicArray<Record>", [&] {
+		uint64_t sum = 0;
+		for (const Record &record : rows) {
+			sum += record.category;
+		}
+
+		return static_cast<double>(sum);
+	});
+	measure("SoAArray", [&] {
+		uint64_t sum = 0;
+		for (uint32_t category : columns.column<3>()) {
+			sum += category;
+		}
+
+		return static_cast<double>(sum);
+	});
+
+	std::cout << "Sum of price * quantity:\n";
+	measure("DynamicArray<Record>", [&] {
+		double sum = 0;
+		for (const Record &record : rows) {
+			sum += record.price * record.quantity;
+		}
+
+		return sum;
+	});
+	measure("SoAArray", [&] {
+		const ColumnSpan<const double> prices = static_cast<const Records&>(columns).column<1>();
+		const ColumnSpan<const double> quantities = static_cast<const Records&>(columns).column<2>();
+
+		double sum = 0;
+		for (size_t i = 0; i < prices.size(); ++i) {
+			sum += prices[i] * quantities[i];
+		}
+
+		return sum;
+	});
+
+	return 0;
+}
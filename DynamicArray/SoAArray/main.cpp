@@ -0,0 +1,165 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <numeric>
+#include <stdexcept>
+
+#include "SoAArray.h"
+
+using Records = SoAArray<int, double, std::string>;
+
+void testRows() {
+	Records records;
+	assert(records.empty() && records.begin() == records.end());
+
+	records.push_back(std::make_tuple(1, 1.5, std::string("one")));
+	records.emplace_back(2, 2.5, "two");
+	Records::value_type three(3, 3.5, "three");
+	records.push_back(std::move(three));
+
+	assert(records.size() == 3 && records.capacity() >= 3);
+	assert(records[1].get<0>() == 2 && records[1].get<1>() == 2.5 && records[1].get<2>() == "two");
+	assert(records.front().get<2>() == "one" && records.back().get<0>() == 3);
+
+	// The proxies write through to the columns.
+	records[0].get<1>() = 10.0;
+	records[2] = std::make_tuple(30, 30.5, std::string("thirty"));
+	records[1] = records[2];
+	assert(records.column<1>()[0] == 10.0 && records.column<0>()[2] == 30 && records.at(1).get<2>() == "thirty");
+
+	const Records::value_type record = records.at(0);
+	assert(std::get<0>(record) == 1 && std::get<1>(record) == 10.0 && std::get<2>(record) == "one");
+
+	int sum = 0;
+	for (auto row : records) {
+		sum += row.get<0>();
+	}
+	assert(sum == 61);
+
+	const Records &constant = records;
+	Records::const_iterator it = records.begin();
+	assert(it == constant.begin() && constant.end() - it == 3 && (*(it + 2)).get<2>() == "thirty" && it[1].get<0>() == 30);
+
+	Records::const_reference row = records[0];
+	assert(row.get<2>() == "one" && constant.column<2>().size() == 3);
+
+	bool thrown = false;
+	try {
+		records.at(3);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+// The columns are contiguous and grow together.
+void testColumns() {
+	SoAArray<float, long long, char> records;
+
+	for (int i = 0; i < 1000; ++i) {
+		records.emplace_back(static_cast<float>(i), i * 1000LL, static_cast<char>('a' + i % 26));
+
+		assert(records.column<0>().size() == records.size() && records.column<2>().size() == records.size());
+		assert(records.capacity() >= records.size());
+	}
+
+	ColumnSpan<long long> big = records.column<1>();
+	assert(std::accumulate(big.begin(), big.end(), 0LL) == 999LL * 1000 / 2 * 1000);
+	assert(big.data() + 999 == &records[999].get<1>());
+
+	for (float &value : records.column<0>()) {
+		value *= 2;
+	}
+	assert(records[10].get<0>() == 20.0f);
+
+	records.resize(10);
+	records.shrink_to_fit();
+	assert(records.size() == 10 && records.capacity() == 10 && records[9].get<2>() == 'j');
+
+	records.resize(12);
+	assert(records.size() == 12 && records[11].get<0>() == 0.0f && records[11].get<1>() == 0);
+
+	records.pop_back();
+	assert(records.size() == 11);
+
+	records.reserve(100);
+	assert(records.capacity() >= 100);
+
+	SoAArray<float, long long, char> copy(records);
+	records.clear();
+	assert(records.empty() && copy.size() == 11 && copy[5].get<1>() == 5000);
+
+	swap(records, copy);
+	assert(records.size() == 11 && copy.empty());
+}
+
+struct Throwing {
+	Throwing() = default;
+
+	Throwing(const Throwing &r)
+		: value(r.value) {
+		if (value < 0) {
+			throw std::runtime_error("Negative!");
+		}
+	}
+
+	int value = 0;
+};
+
+// A field, which throws, leaves all the columns as they were.
+void testThrowingField() {
+	SoAArray<std::string, Throwing> records;
+
+	Throwing good;
+	good.value = 1;
+	records.push_back(std::make_tuple(std::string("good"), good));
+
+	Throwing bad;
+	bad.value = -1;
+
+	bool thrown = false;
+	try {
+		records.emplace_back("bad", bad);
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+
+	assert(thrown && records.size() == 1 && records.column<0>().size() == 1 && records.column<1>().size() == 1);
+	assert(records[0].get<0>() == "good");
+}
+
+// Appending copies of its own rows, also when the columns have to grow.
+void testSelfReference() {
+	SoAArray<std::string, int> records;
+	records.emplace_back(std::string(100, 'x'), 1);
+
+	for (int i = 0; i < 100; ++i) {
+		records.emplace_back(records[0].get<0>(), records[0].get<1>());
+	}
+	for (int i = 0; i < 100; ++i) {
+		records.push_back(records[0]);
+	}
+
+	assert(records.size() == 201);
+	for (auto row : records) {
+		assert(row.get<0>() == std::string(100, 'x') && row.get<1>() == 1);
+	}
+}
+
+int main() {
+	SoAArray<int, std::string> array;
+	array.emplace_back(1, "one");
+	array.emplace_back(2, "two");
+	for (auto row : array) {
+		std::cout << row.get<0>() << ' ' << row.get<1>() << '\n';
+	}
+
+	testRows();
+	testColumns();
+	testThrowingField();
+	testSelfReference();
+
+	return 0;
+}
@@ -0,0 +1,300 @@
+#pragma once
+#ifndef FLAT_MAP_HEADER
+#define FLAT_MAP_HEADER
+
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+
+#include "SortedSearch.h"
+
+// A map, which keeps its pairs sorted by key in one DynamicArray: no node allocations, and
+// a lookup reads a few cache lines instead of chasing the pointers of a tree. Inserting and
+// erasing move the elements after the position, so it is for the read-mostly tables; build
+// large tables with the range constructor or the range insert, which sort once.
+// EytzingerLayout keeps the pairs in the BFS order of the search tree instead, which makes
+// the lookups in large tables faster, and every insert and erase O(n), see SortedSearch.h.
+// The keys must not be modified through the iterators.
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Layout = SortedLayout>
+class FlatMap {
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<Key, Value>;
+	using size_type = size_t;
+	using key_compare = Compare;
+	using iterator = typename sorted_search::Storage<Layout, value_type>::iterator;
+	using const_iterator = typename sorted_search::Storage<Layout, value_type>::const_iterator;
+
+public:
+	explicit FlatMap(const Compare &compare = Compare());
+
+	template <typename InputIt>
+	FlatMap(InputIt first, InputIt last, const Compare &compare = Compare());
+
+	FlatMap(std::initializer_list<value_type> values, const Compare &compare = Compare());
+
+public:
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	bool empty() const;
+	size_type size() const;
+
+	void reserve(size_type newCapacity);
+	void clear();
+
+	iterator find(const Key &key);
+	const_iterator find(const Key &key) const;
+
+	bool contains(const Key &key) const;
+	size_type count(const Key &key) const;
+
+	iterator lower_bound(const Key &key);
+	const_iterator lower_bound(const Key &key) const;
+
+	iterator upper_bound(const Key &key);
+	const_iterator upper_bound(const Key &key) const;
+
+	// Throws std::out_of_range if there is no such key.
+	Value& at(const Key &key);
+	const Value& at(const Key &key) const;
+
+	Value& operator[](const Key &key);
+
+	// Keeps the existing value of the key, like std::map.
+	std::pair<iterator, bool> insert(const value_type &value);
+	std::pair<iterator, bool> insert(value_type &&value);
+
+	// Appends the range, then sorts and merges it in O((n + m) log m).
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last);
+
+	size_type erase(const Key &key);
+	iterator erase(iterator pos);
+
+	key_compare key_comp() const;
+
+private:
+	size_type lowerBoundIndex(const Key &key) const;
+
+	template <typename V>
+	std::pair<iterator, bool> insertValue(V &&value);
+
+private:
+	sorted_search::Storage<Layout, value_type> m_data;
+	Compare m_compare;
+};
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline FlatMap<Key, Value, Compare, Layout>::FlatMap(const Compare &compare)
+	: m_data()
+	, m_compare(compare) {
+
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+template <typename InputIt>
+inline FlatMap<Key, Value, Compare, Layout>::FlatMap(InputIt first, InputIt last, const Compare &compare)
+	: m_data()
+	, m_compare(compare) {
+	DynamicArray<value_type> sorted;
+	for (; first != last; ++first) {
+		sorted.push_back(*first);
+	}
+
+	sorted_search::sortUnique(sorted, [this](const value_type &l, const value_type &r) { return m_compare(l.first, r.first); });
+	m_data.assign(std::move(sorted));
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline FlatMap<Key, Value, Compare, Layout>::FlatMap(std::initializer_list<value_type> values, const Compare &compare)
+	: FlatMap(values.begin(), values.end(), compare) {
+
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::begin() {
+	return m_data.begin();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::end() {
+	return m_data.end();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::const_iterator FlatMap<Key, Value, Compare, Layout>::begin() const {
+	return m_data.begin();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::const_iterator FlatMap<Key, Value, Compare, Layout>::end() const {
+	return m_data.end();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline bool FlatMap<Key, Value, Compare, Layout>::empty() const {
+	return m_data.empty();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::size_type FlatMap<Key, Value, Compare, Layout>::size() const {
+	return m_data.size();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline void FlatMap<Key, Value, Compare, Layout>::reserve(size_type newCapacity) {
+	m_data.reserve(newCapacity);
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline void FlatMap<Key, Value, Compare, Layout>::clear() {
+	m_data.clear();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::find(const Key &key) {
+	const iterator it = lower_bound(key);
+	return it != end() && !m_compare(key, it->first) ? it : end();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::const_iterator FlatMap<Key, Value, Compare, Layout>::find(const Key &key) const {
+	const const_iterator it = lower_bound(key);
+	return it != end() && !m_compare(key, it->first) ? it : end();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline bool FlatMap<Key, Value, Compare, Layout>::contains(const Key &key) const {
+	return find(key) != end();
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::size_type FlatMap<Key, Value, Compare, Layout>::count(const Key &key) const {
+	return contains(key) ? 1 : 0;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::lower_bound(const Key &key) {
+	return m_data.findPartition([&](const value_type &value) { return m_compare(value.first, key); });
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::const_iterator FlatMap<Key, Value, Compare, Layout>::lower_bound(const Key &key) const {
+	return m_data.findPartition([&](const value_type &value) { return m_compare(value.first, key); });
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::upper_bound(const Key &key) {
+	return m_data.findPartition([&](const value_type &value) { return !m_compare(key, value.first); });
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::const_iterator FlatMap<Key, Value, Compare, Layout>::upper_bound(const Key &key) const {
+	return m_data.findPartition([&](const value_type &value) { return !m_compare(key, value.first); });
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline Value& FlatMap<Key, Value, Compare, Layout>::at(const Key &key) {
+	const iterator it = find(key);
+	if (it == end()) {
+		throw std::out_of_range("Invalid key!");
+	}
+
+	return it->second;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline const Value& FlatMap<Key, Value, Compare, Layout>::at(const Key &key) const {
+	const const_iterator it = find(key);
+	if (it == end()) {
+		throw std::out_of_range("Invalid key!");
+	}
+
+	return it->second;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline Value& FlatMap<Key, Value, Compare, Layout>::operator[](const Key &key) {
+	const iterator it = find(key);
+	if (it != end()) {
+		return it->second;
+	}
+
+	return insertValue(value_type(key, Value())).first->second;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline std::pair<typename FlatMap<Key, Value, Compare, Layout>::iterator, bool> FlatMap<Key, Value, Compare, Layout>::insert(const value_type &value) {
+	return insertValue(value);
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline std::pair<typename FlatMap<Key, Value, Compare, Layout>::iterator, bool> FlatMap<Key, Value, Compare, Layout>::insert(value_type &&value) {
+	return insertValue(std::move(value));
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+template <typename InputIt>
+inline void FlatMap<Key, Value, Compare, Layout>::insert(InputIt first, InputIt last) {
+	m_data.update([&](DynamicArray<value_type> &sorted) {
+		const size_type oldSize = sorted.size();
+		for (; first != last; ++first) {
+			sorted.push_back(*first);
+		}
+
+		sorted_search::mergeUnique(sorted, oldSize, [this](const value_type &l, const value_type &r) { return m_compare(l.first, r.first); });
+	});
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::size_type FlatMap<Key, Value, Compare, Layout>::erase(const Key &key) {
+	const iterator it = find(key);
+	if (it == end()) {
+		return 0;
+	}
+
+	erase(it);
+	return 1;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::iterator FlatMap<Key, Value, Compare, Layout>::erase(iterator pos) {
+	const ptrdiff_t index = pos - begin();
+
+	m_data.update([index](DynamicArray<value_type> &sorted) { sorted.erase(sorted.begin() + index); });
+
+	return begin() + index;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::key_compare FlatMap<Key, Value, Compare, Layout>::key_comp() const {
+	return m_compare;
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+inline typename FlatMap<Key, Value, Compare, Layout>::size_type FlatMap<Key, Value, Compare, Layout>::lowerBoundIndex(const Key &key) const {
+	return m_data.partitionPoint([&](const value_type &value) { return m_compare(value.first, key); });
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout>
+template <typename V>
+inline std::pair<typename FlatMap<Key, Value, Compare, Layout>::iterator, bool> FlatMap<Key, Value, Compare, Layout>::insertValue(V &&value) {
+	const size_type index = lowerBoundIndex(value.first);
+	if (index != size() && !m_compare(value.first, m_data[index].first)) {
+		return std::make_pair(begin() + static_cast<ptrdiff_t>(index), false);
+	}
+
+	m_data.update([&](DynamicArray<value_type> &sorted) {
+		sorted.insert(sorted.begin() + static_cast<ptrdiff_t>(index), std::forward<V>(value));
+	});
+
+	return std::make_pair(begin() + static_cast<ptrdiff_t>(index), true);
+}
+
+#endif // !FLAT_MAP_HEADER
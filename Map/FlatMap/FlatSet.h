@@ -0,0 +1,222 @@
+#pragma once
+#ifndef FLAT_SET_HEADER
+#define FLAT_SET_HEADER
+
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+#include "SortedSearch.h"
+
+// A set, which keeps its keys sorted in one DynamicArray, see FlatMap.
+// The keys cannot be modified, so both iterators are constant.
+template <typename Key, typename Compare = std::less<Key>, typename Layout = SortedLayout>
+class FlatSet {
+public:
+	using key_type = Key;
+	using value_type = Key;
+	using size_type = size_t;
+	using key_compare = Compare;
+	using iterator = typename sorted_search::Storage<Layout, Key>::const_iterator;
+	using const_iterator = typename sorted_search::Storage<Layout, Key>::const_iterator;
+
+public:
+	explicit FlatSet(const Compare &compare = Compare());
+
+	template <typename InputIt>
+	FlatSet(InputIt first, InputIt last, const Compare &compare = Compare());
+
+	FlatSet(std::initializer_list<Key> keys, const Compare &compare = Compare());
+
+public:
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	bool empty() const;
+	size_type size() const;
+
+	void reserve(size_type newCapacity);
+	void clear();
+
+	const_iterator find(const Key &key) const;
+	bool contains(const Key &key) const;
+	size_type count(const Key &key) const;
+
+	const_iterator lower_bound(const Key &key) const;
+	const_iterator upper_bound(const Key &key) const;
+
+	std::pair<const_iterator, bool> insert(const Key &key);
+	std::pair<const_iterator, bool> insert(Key &&key);
+
+	// Appends the range, then sorts and merges it in O((n + m) log m).
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last);
+
+	size_type erase(const Key &key);
+	const_iterator erase(const_iterator pos);
+
+	key_compare key_comp() const;
+
+private:
+	size_type lowerBoundIndex(const Key &key) const;
+
+	template <typename K>
+	std::pair<const_iterator, bool> insertKey(K &&key);
+
+private:
+	sorted_search::Storage<Layout, Key> m_data;
+	Compare m_compare;
+};
+
+template <typename Key, typename Compare, typename Layout>
+inline FlatSet<Key, Compare, Layout>::FlatSet(const Compare &compare)
+	: m_data()
+	, m_compare(compare) {
+
+}
+
+template <typename Key, typename Compare, typename Layout>
+template <typename InputIt>
+inline FlatSet<Key, Compare, Layout>::FlatSet(InputIt first, InputIt last, const Compare &compare)
+	: m_data()
+	, m_compare(compare) {
+	DynamicArray<Key> sorted;
+	for (; first != last; ++first) {
+		sorted.push_back(*first);
+	}
+
+	sorted_search::sortUnique(sorted, m_compare);
+	m_data.assign(std::move(sorted));
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline FlatSet<Key, Compare, Layout>::FlatSet(std::initializer_list<Key> keys, const Compare &compare)
+	: FlatSet(keys.begin(), keys.end(), compare) {
+
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::begin() const {
+	return m_data.begin();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::end() const {
+	return m_data.end();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline bool FlatSet<Key, Compare, Layout>::empty() const {
+	return m_data.empty();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::size_type FlatSet<Key, Compare, Layout>::size() const {
+	return m_data.size();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline void FlatSet<Key, Compare, Layout>::reserve(size_type newCapacity) {
+	m_data.reserve(newCapacity);
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline void FlatSet<Key, Compare, Layout>::clear() {
+	m_data.clear();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::find(const Key &key) const {
+	const const_iterator it = lower_bound(key);
+	return it != end() && !m_compare(key, *it) ? it : end();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline bool FlatSet<Key, Compare, Layout>::contains(const Key &key) const {
+	return find(key) != end();
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::size_type FlatSet<Key, Compare, Layout>::count(const Key &key) const {
+	return contains(key) ? 1 : 0;
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::lower_bound(const Key &key) const {
+	return m_data.findPartition([&](const Key &k) { return m_compare(k, key); });
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::upper_bound(const Key &key) const {
+	return m_data.findPartition([&](const Key &k) { return !m_compare(key, k); });
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline std::pair<typename FlatSet<Key, Compare, Layout>::const_iterator, bool> FlatSet<Key, Compare, Layout>::insert(const Key &key) {
+	return insertKey(key);
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline std::pair<typename FlatSet<Key, Compare, Layout>::const_iterator, bool> FlatSet<Key, Compare, Layout>::insert(Key &&key) {
+	return insertKey(std::move(key));
+}
+
+template <typename Key, typename Compare, typename Layout>
+template <typename InputIt>
+inline void FlatSet<Key, Compare, Layout>::insert(InputIt first, InputIt last) {
+	m_data.update([&](DynamicArray<Key> &sorted) {
+		const size_type oldSize = sorted.size();
+		for (; first != last; ++first) {
+			sorted.push_back(*first);
+		}
+
+		sorted_search::mergeUnique(sorted, oldSize, m_compare);
+	});
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::size_type FlatSet<Key, Compare, Layout>::erase(const Key &key) {
+	const const_iterator it = find(key);
+	if (it == end()) {
+		return 0;
+	}
+
+	erase(it);
+	return 1;
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::const_iterator FlatSet<Key, Compare, Layout>::erase(const_iterator pos) {
+	const ptrdiff_t index = pos - begin();
+
+	m_data.update([index](DynamicArray<Key> &sorted) { sorted.erase(sorted.begin() + index); });
+
+	return begin() + index;
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::key_compare FlatSet<Key, Compare, Layout>::key_comp() const {
+	return m_compare;
+}
+
+template <typename Key, typename Compare, typename Layout>
+inline typename FlatSet<Key, Compare, Layout>::size_type FlatSet<Key, Compare, Layout>::lowerBoundIndex(const Key &key) const {
+	return m_data.partitionPoint([&](const Key &k) { return m_compare(k, key); });
+}
+
+template <typename Key, typename Compare, typename Layout>
+template <typename K>
+inline std::pair<typename FlatSet<Key, Compare, Layout>::const_iterator, bool> FlatSet<Key, Compare, Layout>::insertKey(K &&key) {
+	const size_type index = lowerBoundIndex(key);
+	if (index != size() && !m_compare(key, m_data[index])) {
+		return std::make_pair(begin() + static_cast<ptrdiff_t>(index), false);
+	}
+
+	m_data.update([&](DynamicArray<Key> &sorted) {
+		sorted.insert(sorted.begin() + static_cast<ptrdiff_t>(index), std::forward<K>(key));
+	});
+
+	return std::make_pair(begin() + static_cast<ptrdiff_t>(index), true);
+}
+
+#endif // !FLAT_SET_HEADER
@@ -0,0 +1,563 @@
+#pragma once
+#ifndef SORTED_SEARCH_HEADER
+#define SORTED_SEARCH_HEADER
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "../../DynamicArray/DynamicArray/DynamicArray.h"
+
+// The searches and the search layouts of FlatMap and FlatSet.
+//
+// The searches are partition points: pred(key) is true for the keys before the result and
+// false from it on, so lower_bound is pred = key < x and upper_bound is pred = !(x < key).
+
+// Binary search over the sorted array. Fine for the tables, which fit in the cache.
+struct SortedLayout {};
+
+// The rows in the BFS order of the implicit search tree (Eytzinger layout), aligned to the
+// cache lines. The first levels of the tree share a few cache lines, and the descendants of
+// a node a few levels down share one, so it is prefetched while the comparisons go on.
+// It pays off for large tables, which are built once: insert and erase rebuild it in O(n),
+// and the iterators map every position to its row.
+struct EytzingerLayout {};
+
+namespace sorted_search {
+
+inline void prefetch(const void *ptr) {
+#if defined(__GNUC__)
+	__builtin_prefetch(ptr);
+#else
+	(void)ptr;
+#endif
+}
+
+// Arrays of at least this many bytes prefetch both possible next probes.
+const size_t PrefetchBytes = 64 * 1024;
+
+// The branchless binary search: the range only shrinks from the top, and the base moves by
+// a conditional move instead of a mispredicted branch. The loop runs log2(size) times.
+template <typename T, typename Pred>
+size_t partitionPoint(const T *data, size_t size, Pred pred) {
+	if (!size) {
+		return 0;
+	}
+
+	const bool prefetching = size * sizeof(T) >= PrefetchBytes;
+
+	const T *base = data;
+	while (size > 1) {
+		const size_t half = size / 2;
+
+		if (prefetching) {
+			prefetch(base + half / 2);
+			prefetch(base + half + half / 2);
+		}
+
+		base = pred(base[half]) ? base + half : base;
+		size -= half;
+	}
+
+	return static_cast<size_t>(base - data) + (pred(*base) ? 1 : 0);
+}
+
+// Sorts the elements by their keys and keeps the first one of the equal keys.
+template <typename T, typename Less>
+void sortUnique(DynamicArray<T> &data, Less less) {
+	std::stable_sort(data.begin(), data.end(), less);
+
+	const auto equal = [&less](const T &l, const T &r) { return !less(l, r) && !less(r, l); };
+	data.erase(std::unique(data.begin(), data.end(), equal), data.end());
+}
+
+// Merges the elements from oldSize on into the sorted elements before them, keeping the
+// first one of the equal keys, so the old elements win like in std::map::insert.
+template <typename T, typename Less>
+void mergeUnique(DynamicArray<T> &data, size_t oldSize, Less less) {
+	const auto middle = data.begin() + static_cast<ptrdiff_t>(oldSize);
+
+	std::stable_sort(middle, data.end(), less);
+	std::inplace_merge(data.begin(), middle, data.end(), less);
+
+	const auto equal = [&less](const T &l, const T &r) { return !less(l, r) && !less(r, l); };
+	data.erase(std::unique(data.begin(), data.end(), equal), data.end());
+}
+
+// The cache line, which the Eytzinger rows are aligned to.
+const size_t LineBytes = 64;
+
+// Aligns the blocks to the cache lines, which operator new does not do before C++17.
+// The block is a line longer, and the byte before the aligned start keeps the distance
+// back to the start of the block.
+template <typename T>
+class LineAllocator {
+	static_assert(alignof(T) <= LineBytes, "The elements must not be aligned more than a line.");
+
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template <typename U>
+	struct rebind {
+		using other = LineAllocator<U>;
+	};
+
+public:
+	LineAllocator() = default;
+
+	template <typename U>
+	LineAllocator(const LineAllocator<U>&) {}
+
+public:
+	T* allocate(size_t count);
+	void deallocate(T *ptr, size_t count);
+
+	bool operator==(const LineAllocator&) const { return true; }
+	bool operator!=(const LineAllocator&) const { return false; }
+};
+
+template <typename T>
+inline T* LineAllocator<T>::allocate(size_t count) {
+	if (count > (std::numeric_limits<size_t>::max() - LineBytes) / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+
+	unsigned char *block = static_cast<unsigned char*>(::operator new(count * sizeof(T) + LineBytes));
+	unsigned char *aligned = block + (LineBytes - reinterpret_cast<uintptr_t>(block) % LineBytes);
+	aligned[-1] = static_cast<unsigned char>(aligned - block);
+
+	return reinterpret_cast<T*>(aligned);
+}
+
+template <typename T>
+inline void LineAllocator<T>::deallocate(T *ptr, size_t count) {
+	(void)count;
+
+	unsigned char *aligned = reinterpret_cast<unsigned char*>(ptr);
+	::operator delete(aligned - aligned[-1]);
+}
+
+inline size_t bitWidth(size_t value) {
+#if defined(__GNUC__)
+	return value ? 64 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(value))) : 0;
+#else
+	size_t result = 0;
+	for (; value; value >>= 1) {
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+// The value must not be zero.
+inline size_t countTrailingZeros(size_t value) {
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(value)));
+#else
+	size_t result = 0;
+	for (; !(value & 1); value >>= 1) {
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+// The nodes of the Eytzinger layout are numbered from 1 in the BFS order, the children of
+// node k are 2k and 2k + 1, and the tree is complete up to its last level, which is filled
+// from the left. The rank is the sorted position of a node, both map to each other in O(1).
+inline size_t eytzingerRank(size_t node, size_t size) {
+	const size_t levels = bitWidth(size);
+	const size_t depth = bitWidth(node) - 1;
+
+	// The in-order position in the perfect tree of the same height, where the last level
+	// takes the even positions.
+	const size_t perfect = ((2 * (node - (size_t(1) << depth)) + 1) << (levels - 1 - depth)) - 1;
+
+	// Less the missing leaves before it: the last level has only its first present leaves.
+	const size_t present = size - (size_t(1) << (levels - 1)) + 1;
+	const size_t leavesBefore = (perfect + 1) / 2;
+
+	return leavesBefore > present ? perfect - (leavesBefore - present) : perfect;
+}
+
+inline size_t eytzingerNode(size_t rank, size_t size) {
+	const size_t levels = bitWidth(size);
+	const size_t present = size - (size_t(1) << (levels - 1)) + 1;
+
+	// The in-order position in the perfect tree: after the present leaves, only the odd
+	// positions are there.
+	const size_t perfect = rank < 2 * present ? rank : 2 * rank - 2 * present + 1;
+
+	// The trailing zeros of perfect + 1 are the height of the node, the bits above them
+	// are its index in its level.
+	const size_t height = countTrailingZeros(perfect + 1);
+	return (size_t(1) << (levels - 1 - height)) + ((perfect + 1) >> (height + 1));
+}
+
+// Walks the Eytzinger rows in the sorted order, the ranks are mapped to the nodes on the fly.
+// A search knows its node, so the iterator keeps it until it moves, node 0 is not known.
+template <typename T>
+class EytzingerIterator {
+	template <typename>
+	friend class EytzingerIterator;
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = typename std::remove_const<T>::type;
+	using difference_type = ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+public:
+	EytzingerIterator() : m_rows(nullptr), m_size(0), m_rank(0), m_node(0) {}
+	EytzingerIterator(T *rows, size_t size, size_t rank, size_t node = 0) : m_rows(rows), m_size(size), m_rank(rank), m_node(node) {}
+
+	// The iterator converts to the constant one.
+	template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value>::type>
+	EytzingerIterator(const EytzingerIterator<U> &other) : m_rows(other.m_rows), m_size(other.m_size), m_rank(other.m_rank), m_node(other.m_node) {}
+
+public:
+	reference operator*() const { return m_rows[m_node ? m_node : eytzingerNode(m_rank, m_size)]; }
+	pointer operator->() const { return &**this; }
+	reference operator[](difference_type n) const { return *(*this + n); }
+
+	EytzingerIterator& operator++() { return *this += 1; }
+	EytzingerIterator operator++(int) { EytzingerIterator result(*this); ++*this; return result; }
+	EytzingerIterator& operator--() { return *this -= 1; }
+	EytzingerIterator operator--(int) { EytzingerIterator result(*this); --*this; return result; }
+
+	EytzingerIterator& operator+=(difference_type n) {
+		m_rank = static_cast<size_t>(static_cast<difference_type>(m_rank) + n);
+		m_node = 0;
+		return *this;
+	}
+
+	EytzingerIterator& operator-=(difference_type n) { return *this += -n; }
+
+	friend EytzingerIterator operator+(EytzingerIterator it, difference_type n) { return it += n; }
+	friend EytzingerIterator operator+(difference_type n, EytzingerIterator it) { return it += n; }
+	friend EytzingerIterator operator-(EytzingerIterator it, difference_type n) { return it -= n; }
+
+	friend difference_type operator-(const EytzingerIterator &l, const EytzingerIterator &r) {
+		return static_cast<difference_type>(l.m_rank) - static_cast<difference_type>(r.m_rank);
+	}
+
+	friend bool operator==(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank == r.m_rank; }
+	friend bool operator!=(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank != r.m_rank; }
+	friend bool operator<(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank < r.m_rank; }
+	friend bool operator>(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank > r.m_rank; }
+	friend bool operator<=(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank <= r.m_rank; }
+	friend bool operator>=(const EytzingerIterator &l, const EytzingerIterator &r) { return l.m_rank >= r.m_rank; }
+
+private:
+	T *m_rows;
+	size_t m_size;
+	size_t m_rank;
+	size_t m_node;
+};
+
+// The rows of FlatMap and FlatSet in the order of the layout. The iterators and operator[]
+// go in the sorted order, and update() passes the rows to a change as a sorted DynamicArray.
+template <typename Layout, typename T>
+class Storage;
+
+template <typename T>
+class Storage<SortedLayout, T> {
+public:
+	using iterator = typename DynamicArray<T>::iterator;
+	using const_iterator = typename DynamicArray<T>::const_iterator;
+
+public:
+	iterator begin() { return m_rows.begin(); }
+	iterator end() { return m_rows.end(); }
+
+	const_iterator begin() const { return m_rows.begin(); }
+	const_iterator end() const { return m_rows.end(); }
+
+	bool empty() const { return m_rows.empty(); }
+	size_t size() const { return m_rows.size(); }
+
+	void reserve(size_t newCapacity) { m_rows.reserve(newCapacity); }
+	void clear() { m_rows.clear(); }
+
+	T& operator[](size_t rank) { return m_rows[rank]; }
+	const T& operator[](size_t rank) const { return m_rows[rank]; }
+
+	template <typename Pred>
+	size_t partitionPoint(Pred pred) const {
+		return sorted_search::partitionPoint(m_rows.data(), m_rows.size(), pred);
+	}
+
+	template <typename Pred>
+	iterator findPartition(Pred pred) { return begin() + static_cast<ptrdiff_t>(partitionPoint(pred)); }
+
+	template <typename Pred>
+	const_iterator findPartition(Pred pred) const { return begin() + static_cast<ptrdiff_t>(partitionPoint(pred)); }
+
+	void assign(DynamicArray<T> &&sorted) { m_rows = std::move(sorted); }
+
+	template <typename Update>
+	void update(Update update) { update(m_rows); }
+
+private:
+	DynamicArray<T> m_rows;
+};
+
+// The rows themselves are in the BFS order, from index 1 of a block aligned to the cache
+// lines, so a lookup touches only the rows on its path, and the descendants of node k four
+// levels down (for 8-byte rows) are the line at k * LineRows, prefetched while the comparisons
+// go on. Index 0 is left unconstructed. update() rebuilds the rows in O(n).
+template <typename T>
+class Storage<EytzingerLayout, T> {
+public:
+	using iterator = EytzingerIterator<T>;
+	using const_iterator = EytzingerIterator<const T>;
+
+public:
+	Storage();
+	Storage(const Storage &r);
+	Storage(Storage &&r) noexcept;
+	Storage& operator=(const Storage &rhs);
+	Storage& operator=(Storage &&rhs) noexcept;
+	~Storage();
+
+public:
+	iterator begin() { return iterator(rows(), m_size, 0); }
+	iterator end() { return iterator(rows(), m_size, m_size); }
+
+	const_iterator begin() const { return const_iterator(rows(), m_size, 0); }
+	const_iterator end() const { return const_iterator(rows(), m_size, m_size); }
+
+	bool empty() const { return m_size == 0; }
+	size_t size() const { return m_size; }
+
+	// The rows are rebuilt in a block of their exact size, so there is nothing to reserve.
+	void reserve(size_t newCapacity) { (void)newCapacity; }
+	void clear();
+
+	T& operator[](size_t rank) { return rows()[eytzingerNode(rank, m_size)]; }
+	const T& operator[](size_t rank) const { return rows()[eytzingerNode(rank, m_size)]; }
+
+	template <typename Pred>
+	size_t partitionPoint(Pred pred) const;
+
+	// The same as begin() + partitionPoint(pred), but the iterator keeps the node it found.
+	template <typename Pred>
+	iterator findPartition(Pred pred);
+
+	template <typename Pred>
+	const_iterator findPartition(Pred pred) const;
+
+	void assign(DynamicArray<T> &&sorted);
+
+	// If the change throws, the rows are rebuilt from what it left in the array.
+	template <typename Update>
+	void update(Update update);
+
+	void swap(Storage &other);
+
+private:
+	struct Slot {
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	static_assert(sizeof(Slot) == sizeof(T), "The rows must be indexed like an array of T.");
+
+	using SlotArray = DynamicArray<Slot, LineAllocator<Slot>>;
+
+	// The number of the rows in a cache line, the descendants of a node this many levels down.
+	static const size_t LineRows = sizeof(T) < LineBytes ? LineBytes / sizeof(T) : 1;
+
+	// Returns the node, where pred turns false, or 0 if it is true for every row.
+	template <typename Pred>
+	size_t findNode(Pred pred) const;
+
+	T* rows() { return reinterpret_cast<T*>(m_slots.data()); }
+	const T* rows() const { return reinterpret_cast<const T*>(m_slots.data()); }
+
+	// Constructs node k from row(k), then replaces the rows.
+	template <typename Row>
+	void build(size_t size, Row row);
+
+	static void destroy(T *rows, size_t size);
+
+private:
+	SlotArray m_slots;
+	size_t m_size;
+};
+
+template <typename T>
+const size_t Storage<EytzingerLayout, T>::LineRows;
+
+template <typename T>
+inline Storage<EytzingerLayout, T>::Storage()
+	: m_slots()
+	, m_size(0) {
+
+}
+
+template <typename T>
+inline Storage<EytzingerLayout, T>::Storage(const Storage &r)
+	: Storage() {
+	const T *source = r.rows();
+	build(r.m_size, [source](size_t node) -> const T& { return source[node]; });
+}
+
+template <typename T>
+inline Storage<EytzingerLayout, T>::Storage(Storage &&r) noexcept
+	: m_slots(std::move(r.m_slots))
+	, m_size(r.m_size) {
+	r.m_size = 0;
+}
+
+template <typename T>
+inline Storage<EytzingerLayout, T>& Storage<EytzingerLayout, T>::operator=(const Storage &rhs) {
+	if (this != &rhs) {
+		Storage copy(rhs);
+		swap(copy);
+	}
+
+	return *this;
+}
+
+template <typename T>
+inline Storage<EytzingerLayout, T>& Storage<EytzingerLayout, T>::operator=(Storage &&rhs) noexcept {
+	if (this != &rhs) {
+		clear();
+		m_slots = std::move(rhs.m_slots);
+		m_size = rhs.m_size;
+		rhs.m_size = 0;
+	}
+
+	return *this;
+}
+
+template <typename T>
+inline Storage<EytzingerLayout, T>::~Storage() {
+	clear();
+}
+
+template <typename T>
+inline void Storage<EytzingerLayout, T>::clear() {
+	destroy(rows(), m_size);
+	m_size = 0;
+	SlotArray().swap(m_slots);
+}
+
+template <typename T>
+template <typename Pred>
+inline size_t Storage<EytzingerLayout, T>::partitionPoint(Pred pred) const {
+	const size_t node = findNode(pred);
+
+	// The position is computed, as a table of them would cost another cache miss.
+	return node ? eytzingerRank(node, m_size) : m_size;
+}
+
+template <typename T>
+template <typename Pred>
+inline typename Storage<EytzingerLayout, T>::iterator Storage<EytzingerLayout, T>::findPartition(Pred pred) {
+	const size_t node = findNode(pred);
+	return iterator(rows(), m_size, node ? eytzingerRank(node, m_size) : m_size, node);
+}
+
+template <typename T>
+template <typename Pred>
+inline typename Storage<EytzingerLayout, T>::const_iterator Storage<EytzingerLayout, T>::findPartition(Pred pred) const {
+	const size_t node = findNode(pred);
+	return const_iterator(rows(), m_size, node ? eytzingerRank(node, m_size) : m_size, node);
+}
+
+template <typename T>
+template <typename Pred>
+inline size_t Storage<EytzingerLayout, T>::findNode(Pred pred) const {
+	const T *base = rows();
+
+	// Goes right while pred holds. The last left turn is at the answer.
+	size_t node = 1;
+	while (node <= m_size) {
+		prefetch(base + std::min(node * LineRows, m_size));
+		node = 2 * node + (pred(base[node]) ? 1 : 0);
+	}
+
+	// Drops the right turns after the last left turn, and the left turn itself.
+	return node >> (countTrailingZeros(~node) + 1);
+}
+
+template <typename T>
+inline void Storage<EytzingerLayout, T>::assign(DynamicArray<T> &&sorted) {
+	const size_t size = sorted.size();
+
+	// The rows are constructed in the BFS order, so a failure leaves a prefix to destroy.
+	build(size, [&sorted, size](size_t node) -> T&& { return std::move(sorted[eytzingerRank(node, size)]); });
+	sorted.clear();
+}
+
+template <typename T>
+template <typename Update>
+inline void Storage<EytzingerLayout, T>::update(Update update) {
+	DynamicArray<T> sorted(m_size);
+	for (T &row : *this) {
+		sorted.push_back(std::move(row));
+	}
+	clear();
+
+	try {
+		update(sorted);
+	}
+	catch (...) {
+		assign(std::move(sorted));
+		throw;
+	}
+
+	assign(std::move(sorted));
+}
+
+template <typename T>
+inline void Storage<EytzingerLayout, T>::swap(Storage &other) {
+	m_slots.swap(other.m_slots);
+	std::swap(m_size, other.m_size);
+}
+
+template <typename T>
+template <typename Row>
+inline void Storage<EytzingerLayout, T>::build(size_t size, Row row) {
+	const size_t slotCount = size ? size + 1 : 0;
+	SlotArray slots(slotCount);
+	slots.insert(slots.end(), slotCount, Slot());
+
+	T *target = reinterpret_cast<T*>(slots.data());
+	size_t node = 1;
+
+	try {
+		for (; node <= size; ++node) {
+			::new (static_cast<void*>(target + node)) T(row(node));
+		}
+	}
+	catch (...) {
+		destroy(target, node - 1);
+		throw;
+	}
+
+	clear();
+	m_slots.swap(slots);
+	m_size = size;
+}
+
+template <typename T>
+inline void Storage<EytzingerLayout, T>::destroy(T *rows, size_t size) {
+	for (size_t node = 1; node <= size; ++node) {
+		rows[node].~T();
+	}
+}
+
+} // namespace sorted_search
+
+#endif // !SORTED_SEARCH_HEADER
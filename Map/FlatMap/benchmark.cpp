@@ -0,0 +1,121 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <map>
+
+#include <unistd.h>
+
+#include "FlatMap.h"
+
+// Random lookups of the stored keys per second: std::map against FlatMap with the sorted
+// and the Eytzinger layouts, at 1K, 1M and 100M keys. argv[1] limits the number of keys
+// (in millions). std::map needs about 48 bytes per key, 4.8 GB at 100M keys. It is built
+// after the flat maps are gone, and skipped with a note if the free memory is not enough.
+// From 1M keys on, the Eytzinger layout must beat the sorted one, or the exit code is 1.
+
+const size_t Lookups = 1 << 22;
+const size_t MapNodeBytes = 48;
+const size_t EytzingerMinKeys = 1000000;
+
+// The same keys and values for every container, one seed per size.
+template <typename F>
+void generate(size_t count, F f) {
+	std::mt19937 random(static_cast<unsigned>(count));
+	for (size_t i = 0; i < count; ++i) {
+		f(static_cast<uint32_t>(random()), static_cast<uint32_t>(i));
+	}
+}
+
+size_t freeMemory() {
+	return static_cast<size_t>(sysconf(_SC_AVPHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+template <typename Map>
+double lookupsPerSecond(const Map &map, const std::vector<uint32_t> &probes) {
+	uint64_t sum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t key : probes) {
+		sum += map.find(key)->second;
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	// Keeps the lookups alive.
+	if (sum == 42) {
+		std::cout << ' ';
+	}
+
+	return static_cast<double>(probes.size()) / std::chrono::duration<double>(end - start).count();
+}
+
+// Returns false if the Eytzinger layout should have won, but did not.
+bool benchmark(size_t count) {
+	std::vector<std::pair<uint32_t, uint32_t>> pairs;
+	pairs.reserve(count);
+	generate(count, [&pairs](uint32_t key, uint32_t value) {
+		pairs.push_back(std::make_pair(key, value));
+	});
+
+	std::mt19937 random(1);
+	std::vector<uint32_t> probes;
+	probes.reserve(Lookups);
+	for (size_t i = 0; i < Lookups; ++i) {
+		probes.push_back(pairs[random() % count].first);
+	}
+
+	std::cout << count << " keys, millions of lookups per second:\n";
+
+	double sorted = 0;
+	{
+		const FlatMap<uint32_t, uint32_t> flat(pairs.begin(), pairs.end());
+		sorted = lookupsPerSecond(flat, probes);
+		std::cout << "  FlatMap: " << sorted / 1e6 << '\n';
+	}
+
+	double eytzinger = 0;
+	{
+		const FlatMap<uint32_t, uint32_t, std::less<uint32_t>, EytzingerLayout> flat(pairs.begin(), pairs.end());
+		eytzinger = lookupsPerSecond(flat, probes);
+		std::cout << "  FlatMap, Eytzinger: " << eytzinger / 1e6 << " (" << eytzinger / sorted << "x sorted)\n";
+	}
+
+	const bool eytzingerWins = count < EytzingerMinKeys || eytzinger > sorted;
+	if (!eytzingerWins) {
+		std::cout << "  FAILED: the Eytzinger layout is slower than the sorted one\n";
+	}
+
+	// The keys are generated again, so std::map does not share the memory with them.
+	std::vector<std::pair<uint32_t, uint32_t>>().swap(pairs);
+
+	const size_t needed = count * MapNodeBytes;
+	if (needed > freeMemory()) {
+		std::cout << "  std::map: not measured, needs about " << needed / (1 << 20) << " MB, "
+			<< freeMemory() / (1 << 20) << " MB free\n";
+		return eytzingerWins;
+	}
+
+	std::map<uint32_t, uint32_t> map;
+	generate(count, [&map](uint32_t key, uint32_t value) {
+		map.emplace(key, value);
+	});
+
+	std::cout << "  std::map: " << lookupsPerSecond(map, probes) / 1e6 << '\n';
+
+	return eytzingerWins;
+}
+
+int main(int argc, char *argv[]) {
+	const size_t limit = argc > 1 ? std::strtoul(argv[1], nullptr, 10) * 1000000 : 100 * 1000000;
+
+	bool passed = true;
+	for (size_t count : { size_t(1000), size_t(1000000), size_t(100000000) }) {
+		if (count <= limit) {
+			passed = benchmark(count) && passed;
+		}
+	}
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <set>
+#include <string>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include "FlatMap.h"
+#include "FlatSet.h"
+
+template <typename Map>
+bool samePairs(const Map &flat, const std::map<int, int> &expected) {
+	return flat.size() == expected.size() && std::equal(flat.begin(), flat.end(), expected.begin(),
+		[](const std::pair<int, int> &l, const std::pair<const int, int> &r) { return l.first == r.first && l.second == r.second; });
+}
+
+// Random operations against std::map, the bounds are checked for every key around the stored ones.
+template <typename Layout>
+void testMap() {
+	std::mt19937 random(7);
+
+	for (int size : { 0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1000 }) {
+		std::vector<std::pair<int, int>> pairs;
+		for (int i = 0; i < size; ++i) {
+			pairs.push_back(std::make_pair(static_cast<int>(random() % (2 * size + 1)) * 2, i));
+		}
+
+		// Both keep the first value of a duplicate key.
+		FlatMap<int, int, std::less<int>, Layout> flat(pairs.begin(), pairs.end());
+		std::map<int, int> expected(pairs.begin(), pairs.end());
+
+		assert(samePairs(flat, expected));
+
+		for (int key = -1; key <= 4 * size + 3; ++key) {
+			assert(flat.contains(key) == (expected.count(key) == 1));
+			assert(flat.lower_bound(key) - flat.begin() == std::distance(expected.begin(), expected.lower_bound(key)));
+			assert(flat.upper_bound(key) - flat.begin() == std::distance(expected.begin(), expected.upper_bound(key)));
+
+			if (expected.count(key)) {
+				assert(flat.find(key)->second == expected[key]);
+				assert(flat.at(key) == expected.at(key));
+			}
+			else {
+				assert(flat.find(key) == flat.end());
+			}
+		}
+
+		// Single inserts and erases keep the index up to date.
+		for (int i = 0; i < 50; ++i) {
+			const int key = static_cast<int>(random() % (4 * size + 4));
+			if (i % 3) {
+				assert(flat.insert(std::make_pair(key, -i)).second == expected.insert(std::make_pair(key, -i)).second);
+			}
+			else {
+				assert(flat.erase(key) == expected.erase(key));
+			}
+
+			assert(flat.size() == expected.size());
+			assert(flat.contains(key) == (expected.count(key) == 1));
+		}
+
+		assert(samePairs(flat, expected));
+		for (const auto &pair : expected) {
+			assert(flat.find(pair.first)->second == pair.second);
+		}
+	}
+}
+
+template <typename Layout>
+void testMapOperations() {
+	FlatMap<std::string, int, std::less<std::string>, Layout> map = { { "b", 2 }, { "a", 1 }, { "c", 3 }, { "a", 10 } };
+	assert(map.size() == 3 && map.at("a") == 1);
+
+	map["d"] = 4;
+	++map["a"];
+	assert(map.size() == 4 && map["a"] == 2 && map.begin()->first == "a");
+
+	bool thrown = false;
+	try {
+		map.at("e");
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	// The existing values win over the range.
+	const std::pair<std::string, int> more[] = { { "e", 5 }, { "a", 100 }, { "f", 6 }, { "e", 50 } };
+	map.insert(std::begin(more), std::end(more));
+	assert(map.size() == 6 && map.at("a") == 2 && map.at("e") == 5);
+
+	auto it = map.erase(map.find("c"));
+	assert(it->first == "d" && map.size() == 5 && !map.contains("c"));
+
+	// The copies keep the order, the moved-from map is empty.
+	FlatMap<std::string, int, std::less<std::string>, Layout> copy(map);
+	assert(std::equal(copy.begin(), copy.end(), map.begin(), map.end()));
+	copy = std::move(map);
+	assert(map.empty() && copy.size() == 5 && (copy.end() - 1)->first == "f");
+	map = copy;
+	assert(map.size() == 5 && map.at("e") == 5);
+
+	// Backwards, and by position.
+	const auto &constMap = map;
+	std::string keys;
+	for (auto last = constMap.end(); last != constMap.begin(); ) {
+		keys += (--last)->first;
+	}
+	assert(keys == "fedba" && map.begin()[2].first == "d" && constMap.find("a") == constMap.begin());
+
+	map.clear();
+	assert(map.empty() && map.find("a") == map.end());
+}
+
+template <typename Layout>
+void testSet() {
+	std::mt19937 random(11);
+
+	for (int size : { 0, 1, 5, 64, 1000 }) {
+		std::vector<int> keys;
+		for (int i = 0; i < size; ++i) {
+			keys.push_back(static_cast<int>(random() % (2 * size + 1)));
+		}
+
+		FlatSet<int, std::less<int>, Layout> flat(keys.begin(), keys.end());
+		std::set<int> expected(keys.begin(), keys.end());
+		assert(std::equal(flat.begin(), flat.end(), expected.begin(), expected.end()));
+
+		for (int key = -1; key <= 2 * size + 2; ++key) {
+			assert(flat.count(key) == expected.count(key));
+			assert(flat.lower_bound(key) - flat.begin() == std::distance(expected.begin(), expected.lower_bound(key)));
+			assert(flat.upper_bound(key) - flat.begin() == std::distance(expected.begin(), expected.upper_bound(key)));
+		}
+
+		flat.insert(keys.rbegin(), keys.rend());
+		assert(flat.size() == expected.size());
+
+		for (int key : keys) {
+			flat.erase(key);
+		}
+		assert(flat.empty());
+	}
+
+	// A descending set.
+	FlatSet<std::string, std::greater<std::string>, Layout> names = { "bob", "alice", "carol" };
+	assert(*names.begin() == "carol" && names.insert("dave").second && !names.insert("bob").second);
+	assert(*names.begin() == "dave" && *names.lower_bound("bz") == "bob");
+}
+
+// The nodes of the Eytzinger layout in the sorted order are the in-order walk of the tree.
+void inOrder(size_t node, size_t size, std::vector<size_t> &nodes) {
+	if (node <= size) {
+		inOrder(2 * node, size, nodes);
+		nodes.push_back(node);
+		inOrder(2 * node + 1, size, nodes);
+	}
+}
+
+void testEytzinger() {
+	for (size_t size = 1; size <= 300; ++size) {
+		std::vector<size_t> nodes;
+		inOrder(1, size, nodes);
+
+		for (size_t rank = 0; rank < size; ++rank) {
+			assert(sorted_search::eytzingerNode(rank, size) == nodes[rank]);
+			assert(sorted_search::eytzingerRank(nodes[rank], size) == rank);
+		}
+	}
+
+	sorted_search::LineAllocator<char> allocator;
+	for (size_t count : { 1, 3, 64, 1000 }) {
+		char *block = allocator.allocate(count);
+		assert(reinterpret_cast<uintptr_t>(block) % sorted_search::LineBytes == 0);
+		allocator.deallocate(block, count);
+	}
+}
+
+int main() {
+	FlatMap<int, std::string> map = { { 3, "three" }, { 1, "one" }, { 2, "two" } };
+	for (const auto &pair : map) {
+		std::cout << pair.first << ' ' << pair.second << '\n';
+	}
+
+	testMap<SortedLayout>();
+	testMap<EytzingerLayout>();
+	testMapOperations<SortedLayout>();
+	testMapOperations<EytzingerLayout>();
+	testSet<SortedLayout>();
+	testSet<EytzingerLayout>();
+	testEytzinger();
+
+	return 0;
+}
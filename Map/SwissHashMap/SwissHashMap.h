@@ -0,0 +1,837 @@
+#pragma once
+#ifndef SWISS_HASH_MAP_HEADER
+#define SWISS_HASH_MAP_HEADER
+
+#include <new>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include "../../DynamicArray/DynamicArray/DynamicArray.h"
+
+// SSE2 is a part of x86-64, so the 16-byte groups need no runtime dispatch.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISS_HASH_MAP_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace swiss_detail {
+
+// A control byte per slot: 0-127 are the 7 low bits of the hash of a full slot (H2),
+// the special values have the sign bit set.
+const int8_t Empty = -128;
+const int8_t Deleted = -2;
+
+inline size_t trailingZeros(uint32_t mask) {
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_ctz(mask));
+#else
+	size_t result = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+inline size_t leadingZeros(uint32_t mask) {
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_clz(mask));
+#else
+	size_t result = 0;
+	while (!(mask & 0x80000000u)) {
+		mask <<= 1;
+		++result;
+	}
+
+	return result;
+#endif
+}
+
+// The control bytes of a group of neighbouring slots. The masks have a bit per slot.
+#ifdef SWISS_HASH_MAP_HAS_SSE2
+class Group {
+public:
+	static const size_t width = 16;
+
+	explicit Group(const int8_t *control)
+		: m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {
+
+	}
+
+	uint32_t match(int8_t h2) const {
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_control)));
+	}
+
+	uint32_t matchEmpty() const {
+		return match(Empty);
+	}
+
+	// The special bytes are the ones with the sign bit.
+	uint32_t matchEmptyOrDeleted() const {
+		return static_cast<uint32_t>(_mm_movemask_epi8(m_control));
+	}
+
+	static size_t leadingZeros(uint32_t mask) {
+		return swiss_detail::leadingZeros(mask) - (32 - width);
+	}
+
+private:
+	__m128i m_control;
+};
+#else
+// The portable group compares the bytes one by one.
+class Group {
+public:
+	static const size_t width = 8;
+
+	explicit Group(const int8_t *control) {
+		std::memcpy(m_control, control, width);
+	}
+
+	uint32_t match(int8_t h2) const {
+		uint32_t result = 0;
+		for (size_t i = 0; i < width; ++i) {
+			result |= static_cast<uint32_t>(m_control[i] == h2) << i;
+		}
+
+		return result;
+	}
+
+	uint32_t matchEmpty() const {
+		return match(Empty);
+	}
+
+	uint32_t matchEmptyOrDeleted() const {
+		uint32_t result = 0;
+		for (size_t i = 0; i < width; ++i) {
+			result |= static_cast<uint32_t>(m_control[i] < 0) << i;
+		}
+
+		return result;
+	}
+
+	static size_t leadingZeros(uint32_t mask) {
+		return swiss_detail::leadingZeros(mask) - (32 - width);
+	}
+
+private:
+	int8_t m_control[width];
+};
+#endif
+
+template <typename T>
+struct Void {
+	using type = void;
+};
+
+template <typename T, typename = void>
+struct IsTransparent : std::false_type {};
+
+template <typename T>
+struct IsTransparent<T, typename Void<typename T::is_transparent>::type> : std::true_type {};
+
+// The key argument of the lookups: K itself with a transparent hash and key equal, so a
+// std::string key can be looked up by a const char* or a std::string_view without a copy.
+template <bool Transparent>
+struct KeyArg {
+	template <typename K, typename Key>
+	using type = Key;
+};
+
+template <>
+struct KeyArg<true> {
+	template <typename K, typename Key>
+	using type = K;
+};
+
+} // namespace swiss_detail
+
+// An open-addressing hash map in the style of the Swiss tables. The slots and their control
+// bytes are in two flat DynamicArrays, and a lookup compares the 7-bit hash fragments of
+// a whole group of slots in one SSE2 instruction, so it touches few cache lines and rarely
+// compares keys. Erased slots become tombstones only if a probe could have passed them, and
+// the tombstones are dropped by rehashing in place before the table grows.
+// The elements move on rehash, which invalidates the iterators and the references.
+// The keys must not be modified through the iterators.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class SwissHashMap {
+	using Group = swiss_detail::Group;
+
+	static const bool isTransparent = swiss_detail::IsTransparent<Hash>::value && swiss_detail::IsTransparent<KeyEqual>::value;
+
+	template <typename K>
+	using key_arg = typename swiss_detail::KeyArg<isTransparent>::template type<K, Key>;
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<Key, Value>;
+	using size_type = size_t;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+
+	template <typename MapType, typename ValueType>
+	class basic_iterator;
+
+	using iterator = basic_iterator<SwissHashMap, value_type>;
+	using const_iterator = basic_iterator<const SwissHashMap, const value_type>;
+
+public:
+	explicit SwissHashMap(size_type count = 0, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual());
+	SwissHashMap(const SwissHashMap &r);
+	SwissHashMap(SwissHashMap &&r) noexcept;
+	~SwissHashMap();
+
+	SwissHashMap& operator=(const SwissHashMap &rhs);
+	SwissHashMap& operator=(SwissHashMap &&rhs) noexcept;
+
+public:
+	iterator begin();
+	iterator end();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	bool empty() const;
+	size_type size() const;
+
+	// The number of the slots, of which at most 7/8 are used.
+	size_type capacity() const;
+	float load_factor() const;
+
+	// Makes room for count elements without a rehash.
+	void reserve(size_type count);
+	void clear();
+
+	template <typename K = Key>
+	iterator find(const key_arg<K> &key);
+
+	template <typename K = Key>
+	const_iterator find(const key_arg<K> &key) const;
+
+	template <typename K = Key>
+	bool contains(const key_arg<K> &key) const;
+
+	template <typename K = Key>
+	size_type count(const key_arg<K> &key) const;
+
+	// Throws std::out_of_range if there is no such key.
+	template <typename K = Key>
+	Value& at(const key_arg<K> &key);
+
+	template <typename K = Key>
+	const Value& at(const key_arg<K> &key) const;
+
+	Value& operator[](const Key &key);
+	Value& operator[](Key &&key);
+
+	// Keeps the existing value of the key, like std::unordered_map.
+	std::pair<iterator, bool> insert(const value_type &value);
+	std::pair<iterator, bool> insert(value_type &&value);
+
+	// Constructs the value from args only if the key is not there.
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K &&key, Args&&... args);
+
+	template <typename K = Key>
+	size_type erase(const key_arg<K> &key);
+
+	iterator erase(iterator pos);
+
+	void swap(SwissHashMap &other) noexcept;
+
+private:
+	// The storage of a slot, the values are constructed and destroyed by the map.
+	struct Slot {
+		alignas(value_type) unsigned char storage[sizeof(value_type)];
+	};
+
+	// The probe sequence visits the groups at triangular offsets. The capacity is a power
+	// of two and a multiple of the group width, so it visits every group.
+	struct Probe {
+		size_t offset;
+		size_t step;
+	};
+
+	static size_t mix(size_t hash);
+	static size_t capacityFor(size_type count);
+	static size_t growthFor(size_t capacity);
+
+	template <typename K>
+	size_t hashOf(const K &key) const;
+
+	template <typename K>
+	size_t findIndex(const K &key, size_t hash) const;
+
+	size_t findFirstNonFull(size_t hash) const;
+
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> emplaceKey(size_t hash, K &&key, Args&&... args);
+
+	size_t nextFull(size_t index) const;
+
+	value_type* slot(size_t index);
+	const value_type* slot(size_t index) const;
+
+	void setControl(size_t index, int8_t value);
+	void eraseAt(size_t index);
+
+	void rehashAndGrowIfNecessary();
+	void resize(size_t newCapacity);
+	void dropDeletesWithoutResize();
+	void destroyAll();
+
+private:
+	DynamicArray<int8_t> m_control;
+	DynamicArray<Slot> m_slots;
+	size_t m_size;
+	size_t m_growthLeft;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+/* --- ITERATOR --- */
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename MapType, typename ValueType>
+class SwissHashMap<Key, Value, Hash, KeyEqual>::basic_iterator {
+	friend class SwissHashMap<Key, Value, Hash, KeyEqual>;
+
+	template <typename OtherMap, typename OtherValue>
+	friend class basic_iterator;
+
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = typename std::remove_const<ValueType>::type;
+	using difference_type = ptrdiff_t;
+	using pointer = ValueType*;
+	using reference = ValueType&;
+
+public:
+	basic_iterator()
+		: m_map(nullptr)
+		, m_index(0) {
+
+	}
+
+	// The iterator converts to the const_iterator.
+	template <typename OtherMap, typename OtherValue, typename = typename std::enable_if<std::is_convertible<OtherValue*, ValueType*>::value>::type>
+	basic_iterator(const basic_iterator<OtherMap, OtherValue> &r)
+		: m_map(r.m_map)
+		, m_index(r.m_index) {
+
+	}
+
+	reference operator*() const { return *m_map->slot(m_index); }
+	pointer operator->() const { return m_map->slot(m_index); }
+
+	basic_iterator& operator++() {
+		m_index = m_map->nextFull(m_index + 1);
+		return *this;
+	}
+
+	basic_iterator operator++(int) {
+		basic_iterator result(*this);
+		++*this;
+
+		return result;
+	}
+
+	template <typename OtherMap, typename OtherValue>
+	bool operator==(const basic_iterator<OtherMap, OtherValue> &r) const { return m_index == r.m_index; }
+
+	template <typename OtherMap, typename OtherValue>
+	bool operator!=(const basic_iterator<OtherMap, OtherValue> &r) const { return m_index != r.m_index; }
+
+private:
+	basic_iterator(MapType *map, size_t index)
+		: m_map(map)
+		, m_index(index) {
+
+	}
+
+private:
+	MapType *m_map;
+	size_t m_index;
+};
+
+/* --- SWISS HASH MAP --- */
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>::SwissHashMap(size_type count, const Hash &hash, const KeyEqual &equal)
+	: m_control()
+	, m_slots()
+	, m_size(0)
+	, m_growthLeft(0)
+	, m_hash(hash)
+	, m_equal(equal) {
+	reserve(count);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>::SwissHashMap(const SwissHashMap &r)
+	: SwissHashMap(r.size(), r.m_hash, r.m_equal) {
+	for (const value_type &value : r) {
+		emplaceKey(hashOf(value.first), value.first, value.second);
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>::SwissHashMap(SwissHashMap &&r) noexcept
+	: m_control()
+	, m_slots()
+	, m_size(0)
+	, m_growthLeft(0)
+	, m_hash(r.m_hash)
+	, m_equal(r.m_equal) {
+	swap(r);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>::~SwissHashMap() {
+	destroyAll();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>& SwissHashMap<Key, Value, Hash, KeyEqual>::operator=(const SwissHashMap &rhs) {
+	if (this != &rhs) {
+		SwissHashMap copy(rhs);
+		swap(copy);
+	}
+
+	return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline SwissHashMap<Key, Value, Hash, KeyEqual>& SwissHashMap<Key, Value, Hash, KeyEqual>::operator=(SwissHashMap &&rhs) noexcept {
+	if (this != &rhs) {
+		swap(rhs);
+		rhs.clear();
+	}
+
+	return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator SwissHashMap<Key, Value, Hash, KeyEqual>::begin() {
+	return iterator(this, nextFull(0));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator SwissHashMap<Key, Value, Hash, KeyEqual>::end() {
+	return iterator(this, capacity());
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::const_iterator SwissHashMap<Key, Value, Hash, KeyEqual>::begin() const {
+	return const_iterator(this, nextFull(0));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::const_iterator SwissHashMap<Key, Value, Hash, KeyEqual>::end() const {
+	return const_iterator(this, capacity());
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline bool SwissHashMap<Key, Value, Hash, KeyEqual>::empty() const {
+	return m_size == 0;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::size_type SwissHashMap<Key, Value, Hash, KeyEqual>::size() const {
+	return m_size;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::size_type SwissHashMap<Key, Value, Hash, KeyEqual>::capacity() const {
+	return m_slots.size();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline float SwissHashMap<Key, Value, Hash, KeyEqual>::load_factor() const {
+	return capacity() ? static_cast<float>(m_size) / static_cast<float>(capacity()) : 0.0f;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::reserve(size_type count) {
+	if (count > m_size + m_growthLeft) {
+		resize(capacityFor(count));
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::clear() {
+	destroyAll();
+
+	std::fill(m_control.begin(), m_control.end(), swiss_detail::Empty);
+	m_size = 0;
+	m_growthLeft = growthFor(capacity());
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator SwissHashMap<Key, Value, Hash, KeyEqual>::find(const key_arg<K> &key) {
+	return iterator(this, findIndex(key, hashOf(key)));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::const_iterator SwissHashMap<Key, Value, Hash, KeyEqual>::find(const key_arg<K> &key) const {
+	return const_iterator(this, findIndex(key, hashOf(key)));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline bool SwissHashMap<Key, Value, Hash, KeyEqual>::contains(const key_arg<K> &key) const {
+	return findIndex(key, hashOf(key)) != capacity();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::size_type SwissHashMap<Key, Value, Hash, KeyEqual>::count(const key_arg<K> &key) const {
+	return contains<K>(key) ? 1 : 0;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline Value& SwissHashMap<Key, Value, Hash, KeyEqual>::at(const key_arg<K> &key) {
+	const size_t index = findIndex(key, hashOf(key));
+	if (index == capacity()) {
+		throw std::out_of_range("Invalid key!");
+	}
+
+	return slot(index)->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline const Value& SwissHashMap<Key, Value, Hash, KeyEqual>::at(const key_arg<K> &key) const {
+	const size_t index = findIndex(key, hashOf(key));
+	if (index == capacity()) {
+		throw std::out_of_range("Invalid key!");
+	}
+
+	return slot(index)->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline Value& SwissHashMap<Key, Value, Hash, KeyEqual>::operator[](const Key &key) {
+	return try_emplace(key).first->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline Value& SwissHashMap<Key, Value, Hash, KeyEqual>::operator[](Key &&key) {
+	return try_emplace(std::move(key)).first->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline std::pair<typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator, bool> SwissHashMap<Key, Value, Hash, KeyEqual>::insert(const value_type &value) {
+	return emplaceKey(hashOf(value.first), value.first, value.second);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline std::pair<typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator, bool> SwissHashMap<Key, Value, Hash, KeyEqual>::insert(value_type &&value) {
+	return emplaceKey(hashOf(value.first), std::move(value.first), std::move(value.second));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K, typename... Args>
+inline std::pair<typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator, bool> SwissHashMap<Key, Value, Hash, KeyEqual>::try_emplace(K &&key, Args&&... args) {
+	const size_t hash = hashOf(key);
+	return emplaceKey(hash, std::forward<K>(key), std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::size_type SwissHashMap<Key, Value, Hash, KeyEqual>::erase(const key_arg<K> &key) {
+	const size_t index = findIndex(key, hashOf(key));
+	if (index == capacity()) {
+		return 0;
+	}
+
+	eraseAt(index);
+	return 1;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator SwissHashMap<Key, Value, Hash, KeyEqual>::erase(iterator pos) {
+	eraseAt(pos.m_index);
+	return iterator(this, nextFull(pos.m_index + 1));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::swap(SwissHashMap &other) noexcept {
+	m_control.swap(other.m_control);
+	m_slots.swap(other.m_slots);
+	std::swap(m_size, other.m_size);
+	std::swap(m_growthLeft, other.m_growthLeft);
+	std::swap(m_hash, other.m_hash);
+	std::swap(m_equal, other.m_equal);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::mix(size_t hash) {
+	// std::hash of the integers is the identity, whose low bits would make poor H2 bytes.
+	const uint64_t product = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+	return static_cast<size_t>(product ^ (product >> 32));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::capacityFor(size_type count) {
+	size_t result = Group::width;
+	while (growthFor(result) < count) {
+		result *= 2;
+	}
+
+	return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::growthFor(size_t capacity) {
+	// The maximum load factor is 7/8, so every probe sequence reaches an empty slot.
+	return capacity - capacity / 8;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::hashOf(const K &key) const {
+	return mix(m_hash(key));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::findIndex(const K &key, size_t hash) const {
+	const size_t mask = capacity() - 1;
+	if (!capacity()) {
+		return 0;
+	}
+
+	const int8_t h2 = static_cast<int8_t>(hash & 0x7F);
+	const int8_t *control = m_control.data();
+
+	Probe probe = { (hash >> 7) & mask, 0 };
+	while (true) {
+		const Group group(control + probe.offset);
+
+		for (uint32_t match = group.match(h2); match; match &= match - 1) {
+			const size_t index = (probe.offset + swiss_detail::trailingZeros(match)) & mask;
+			if (m_equal(slot(index)->first, key)) {
+				return index;
+			}
+		}
+
+		// A probe sequence ends at the first group with an empty slot.
+		if (group.matchEmpty()) {
+			return capacity();
+		}
+
+		probe.step += Group::width;
+		probe.offset = (probe.offset + probe.step) & mask;
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::findFirstNonFull(size_t hash) const {
+	const size_t mask = capacity() - 1;
+
+	Probe probe = { (hash >> 7) & mask, 0 };
+	while (true) {
+		const uint32_t free = Group(m_control.data() + probe.offset).matchEmptyOrDeleted();
+		if (free) {
+			return (probe.offset + swiss_detail::trailingZeros(free)) & mask;
+		}
+
+		probe.step += Group::width;
+		probe.offset = (probe.offset + probe.step) & mask;
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename K, typename... Args>
+inline std::pair<typename SwissHashMap<Key, Value, Hash, KeyEqual>::iterator, bool> SwissHashMap<Key, Value, Hash, KeyEqual>::emplaceKey(size_t hash, K &&key, Args&&... args) {
+	const size_t found = findIndex(key, hash);
+	if (found != capacity()) {
+		return std::make_pair(iterator(this, found), false);
+	}
+
+	size_t index = capacity() ? findFirstNonFull(hash) : 0;
+
+	// A tombstone can be reused without growing.
+	if (!m_growthLeft && (!capacity() || m_control[index] != swiss_detail::Deleted)) {
+		rehashAndGrowIfNecessary();
+		index = findFirstNonFull(hash);
+	}
+
+	new (slot(index)) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+
+	m_growthLeft -= m_control[index] == swiss_detail::Empty;
+	setControl(index, static_cast<int8_t>(hash & 0x7F));
+	++m_size;
+
+	return std::make_pair(iterator(this, index), true);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline size_t SwissHashMap<Key, Value, Hash, KeyEqual>::nextFull(size_t index) const {
+	const int8_t *control = m_control.data();
+
+	while (index < capacity() && control[index] < 0) {
+		++index;
+	}
+
+	return index;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline typename SwissHashMap<Key, Value, Hash, KeyEqual>::value_type* SwissHashMap<Key, Value, Hash, KeyEqual>::slot(size_t index) {
+	return reinterpret_cast<value_type*>(m_slots.data() + index);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline const typename SwissHashMap<Key, Value, Hash, KeyEqual>::value_type* SwissHashMap<Key, Value, Hash, KeyEqual>::slot(size_t index) const {
+	return reinterpret_cast<const value_type*>(m_slots.data() + index);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::setControl(size_t index, int8_t value) {
+	// The first group is cloned after the last slot, so a group can be loaded at any slot.
+	m_control[index] = value;
+	if (index < Group::width) {
+		m_control[capacity() + index] = value;
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::eraseAt(size_t index) {
+	slot(index)->~value_type();
+	--m_size;
+
+	// If the slot has never been in a full window of a group, no probe has gone past it,
+	// and it can be empty again instead of a tombstone.
+	const size_t before = (index - Group::width) & (capacity() - 1);
+	const uint32_t emptyAfter = Group(m_control.data() + index).matchEmpty();
+	const uint32_t emptyBefore = Group(m_control.data() + before).matchEmpty();
+
+	const bool neverFull = emptyBefore && emptyAfter &&
+		swiss_detail::trailingZeros(emptyAfter) + Group::leadingZeros(emptyBefore) < Group::width;
+
+	setControl(index, neverFull ? swiss_detail::Empty : swiss_detail::Deleted);
+	m_growthLeft += neverFull;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::rehashAndGrowIfNecessary() {
+	if (!capacity()) {
+		resize(Group::width);
+	}
+	else if (m_size * 32 <= capacity() * 25) {
+		// At most ~78% full, the rest of the growth is tombstones.
+		dropDeletesWithoutResize();
+	}
+	else {
+		resize(capacity() * 2);
+	}
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::resize(size_t newCapacity) {
+	SwissHashMap other(0, m_hash, m_equal);
+	other.m_control.insert(other.m_control.end(), newCapacity + Group::width, swiss_detail::Empty);
+	other.m_slots.insert(other.m_slots.end(), newCapacity, Slot());
+	other.m_growthLeft = growthFor(newCapacity) - m_size;
+
+	// The new table has no tombstones and no duplicates, so each element goes to the first
+	// free slot of its probe sequence.
+	for (size_t i = 0; i < capacity(); ++i) {
+		if (m_control[i] >= 0) {
+			const size_t hash = hashOf(slot(i)->first);
+			const size_t index = other.findFirstNonFull(hash);
+
+			new (other.slot(index)) value_type(std::move(*slot(i)));
+			other.setControl(index, static_cast<int8_t>(hash & 0x7F));
+			++other.m_size;
+
+			slot(i)->~value_type();
+			m_control[i] = swiss_detail::Empty;
+		}
+	}
+
+	m_size = 0;
+	swap(other);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::dropDeletesWithoutResize() {
+	const size_t mask = capacity() - 1;
+
+	// The tombstones become empty, and the full slots become "deleted", which marks the
+	// elements still to place.
+	for (size_t i = 0; i < capacity(); ++i) {
+		m_control[i] = m_control[i] == swiss_detail::Deleted ? swiss_detail::Empty : m_control[i] >= 0 ? swiss_detail::Deleted : m_control[i];
+	}
+	std::copy(m_control.begin(), m_control.begin() + Group::width, m_control.begin() + static_cast<ptrdiff_t>(capacity()));
+
+	Slot temporary;
+	value_type *spare = reinterpret_cast<value_type*>(&temporary);
+
+	for (size_t i = 0; i < capacity(); ++i) {
+		if (m_control[i] != swiss_detail::Deleted) {
+			continue;
+		}
+
+		const size_t hash = hashOf(slot(i)->first);
+		const int8_t h2 = static_cast<int8_t>(hash & 0x7F);
+		const size_t index = findFirstNonFull(hash);
+
+		// The element stays, if it is in the same group of its probe sequence anyway.
+		const size_t start = (hash >> 7) & mask;
+		if (((index - start) & mask) / Group::width == ((i - start) & mask) / Group::width) {
+			setControl(i, h2);
+			continue;
+		}
+
+		if (m_control[index] == swiss_detail::Empty) {
+			new (slot(index)) value_type(std::move(*slot(i)));
+			slot(i)->~value_type();
+
+			setControl(index, h2);
+			setControl(i, swiss_detail::Empty);
+		}
+		else {
+			// The target holds an element still to place: swap them, and place that one next.
+			new (spare) value_type(std::move(*slot(index)));
+			slot(index)->~value_type();
+			new (slot(index)) value_type(std::move(*slot(i)));
+			slot(i)->~value_type();
+			new (slot(i)) value_type(std::move(*spare));
+			spare->~value_type();
+
+			setControl(index, h2);
+			--i;
+		}
+	}
+
+	m_growthLeft = growthFor(capacity()) - m_size;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+inline void SwissHashMap<Key, Value, Hash, KeyEqual>::destroyAll() {
+	if (!std::is_trivially_destructible<value_type>::value) {
+		for (size_t i = 0; i < capacity(); ++i) {
+			if (m_control[i] >= 0) {
+				slot(i)->~value_type();
+			}
+		}
+	}
+}
+
+#endif // !SWISS_HASH_MAP_HEADER
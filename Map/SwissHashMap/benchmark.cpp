@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+#include "SwissHashMap.h"
+
+// Millions of operations per second, std::unordered_map against SwissHashMap at 1K, 1M and
+// 10M random keys: inserts into an empty map, lookups of stored and of missing keys,
+// and erasing all the keys. argv[1] limits the number of keys (in millions).
+
+template <typename F>
+double operationsPerSecond(size_t count, F f) {
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+
+	return static_cast<double>(count) / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+template <typename Map>
+void benchmark(const char *name, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &hits, const std::vector<uint64_t> &misses) {
+	Map map;
+	uint64_t sum = 0;
+
+	const double insert = operationsPerSecond(keys.size(), [&] {
+		for (uint64_t key : keys) {
+			map[key] = key;
+		}
+	});
+
+	const double hit = operationsPerSecond(hits.size(), [&] {
+		for (uint64_t key : hits) {
+			sum += map.find(key)->second;
+		}
+	});
+
+	const double miss = operationsPerSecond(misses.size(), [&] {
+		for (uint64_t key : misses) {
+			sum += map.find(key) != map.end();
+		}
+	});
+
+	const double erase = operationsPerSecond(keys.size(), [&] {
+		for (uint64_t key : keys) {
+			sum += map.erase(key);
+		}
+	});
+
+	// Keeps the lookups alive.
+	if (sum == 42) {
+		std::cout << ' ';
+	}
+
+	std::cout << "  " << name << ": insert " << insert << ", hit " << hit << ", miss " << miss << ", erase " << erase << '\n';
+}
+
+void benchmark(size_t count) {
+	std::mt19937_64 random(count);
+
+	// The stored keys are even and the missing ones are odd.
+	std::vector<uint64_t> keys;
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		keys.push_back(random() & ~uint64_t(1));
+	}
+
+	const size_t lookups = 1 << 22;
+	std::vector<uint64_t> hits;
+	std::vector<uint64_t> misses;
+	hits.reserve(lookups);
+	misses.reserve(lookups);
+	for (size_t i = 0; i < lookups; ++i) {
+		hits.push_back(keys[random() % count]);
+		misses.push_back(random() | 1);
+	}
+
+	std::cout << count << " keys, millions of operations per second:\n";
+	benchmark<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, hits, misses);
+	benchmark<SwissHashMap<uint64_t, uint64_t>>("SwissHashMap", keys, hits, misses);
+}
+
+int main(int argc, char *argv[]) {
+	const size_t limit = argc > 1 ? std::strtoul(argv[1], nullptr, 10) * 1000000 : 10 * 1000000;
+
+	for (size_t count : { size_t(1000), size_t(1000000), size_t(10000000) }) {
+		if (count <= limit) {
+			benchmark(count);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <random>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#include "SwissHashMap.h"
+
+template <typename Map>
+bool sameElements(const Map &map, const std::unordered_map<int, int> &expected) {
+	size_t count = 0;
+	for (const auto &pair : map) {
+		auto it = expected.find(pair.first);
+		if (it == expected.end() || it->second != pair.second) {
+			return false;
+		}
+
+		++count;
+	}
+
+	return count == expected.size() && map.size() == expected.size();
+}
+
+// Random inserts and erases against std::unordered_map. The small key range makes many
+// tombstones, which are dropped by rehashing in place.
+void testRandom() {
+	std::mt19937 random(7);
+
+	for (int range : { 4, 20, 100, 1000, 10000 }) {
+		SwissHashMap<int, int> map;
+		std::unordered_map<int, int> expected;
+
+		for (int i = 0; i < 50000; ++i) {
+			const int key = static_cast<int>(random() % static_cast<unsigned>(range));
+			switch (random() % 4) {
+			case 0:
+			case 1:
+				assert(map.insert(std::make_pair(key, i)).second == expected.insert(std::make_pair(key, i)).second);
+				break;
+			case 2:
+				assert(map.erase(key) == expected.erase(key));
+				break;
+			default:
+				assert(map.contains(key) == (expected.count(key) == 1));
+				assert(map.find(key) == map.end() || map.find(key)->second == expected[key]);
+				break;
+			}
+
+			assert(map.size() == expected.size());
+		}
+
+		assert(sameElements(map, expected));
+
+		// With churn over few keys the table must not grow past the needed capacity.
+		const SwissHashMap<int, int> sized(static_cast<size_t>(range));
+		assert(map.capacity() <= 2 * sized.capacity());
+	}
+}
+
+void testOperations() {
+	SwissHashMap<int, std::string> map;
+	assert(map.empty() && map.begin() == map.end() && !map.contains(1) && map.erase(1) == 0);
+
+	map[1] = "one";
+	map[2] = "two";
+	assert(map.try_emplace(3, 5, 'x').second && map.at(3) == "xxxxx");
+	assert(!map.try_emplace(3, "three").second && map.at(3) == "xxxxx");
+	assert(!map.insert(std::make_pair(1, std::string("uno"))).second && map[1] == "one");
+	assert(map.count(2) == 1 && map.count(4) == 0);
+
+	bool thrown = false;
+	try {
+		map.at(4);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	// Erasing through the iterators, the rest are still visited.
+	for (int i = 10; i < 200; ++i) {
+		map[i] = std::to_string(i);
+	}
+	for (auto it = map.begin(); it != map.end();) {
+		it = it->first % 2 ? map.erase(it) : std::next(it);
+	}
+	assert(map.size() == 96);
+	for (const auto &pair : map) {
+		assert(pair.first % 2 == 0);
+	}
+
+	SwissHashMap<int, std::string> copy(map);
+	assert(copy.size() == map.size() && copy.at(100) == "100");
+
+	SwissHashMap<int, std::string> moved(std::move(copy));
+	assert(moved.size() == map.size() && copy.empty());
+
+	copy = moved;
+	moved.clear();
+	assert(moved.empty() && moved.begin() == moved.end() && copy.at(2) == "two");
+
+	const SwissHashMap<int, std::string> &constant = copy;
+	assert(constant.find(2)->second == "two" && constant.find(3) == constant.end());
+	SwissHashMap<int, std::string>::const_iterator it = copy.find(2);
+	assert(it == constant.find(2));
+}
+
+// The slots hold values, which are not trivially destructible or copyable.
+void testMoveOnly() {
+	SwissHashMap<int, std::unique_ptr<int>> map;
+	for (int i = 0; i < 1000; ++i) {
+		map.try_emplace(i, new int(i));
+	}
+	for (int i = 0; i < 1000; i += 3) {
+		map.erase(i);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		assert(map.contains(i) == (i % 3 != 0));
+		assert(i % 3 == 0 || *map.at(i) == i);
+	}
+
+	SwissHashMap<int, std::unique_ptr<int>> other;
+	other = std::move(map);
+	assert(other.size() == 666 && map.empty());
+}
+
+void testReserve() {
+	SwissHashMap<int, int> map;
+	map.reserve(1000);
+
+	const size_t capacity = map.capacity();
+	assert(capacity >= 1000 && map.load_factor() == 0.0f);
+
+	for (int i = 0; i < 1000; ++i) {
+		map[i] = i;
+	}
+	assert(map.capacity() == capacity && map.size() == 1000);
+
+	map.reserve(10);
+	assert(map.capacity() == capacity);
+}
+
+#if __cplusplus >= 201703L
+struct StringHash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+};
+
+struct StringEqual {
+	using is_transparent = void;
+
+	bool operator()(std::string_view l, std::string_view r) const { return l == r; }
+};
+
+// A transparent hash and key equal look up std::string keys without constructing strings.
+void testHeterogeneous() {
+	SwissHashMap<std::string, int, StringHash, StringEqual> map;
+	map["apple"] = 1;
+	map["banana"] = 2;
+
+	const std::string_view key = "banana";
+	assert(map.contains(key) && map.at(key) == 2 && map.find("apple")->second == 1);
+	assert(map.count("cherry") == 0 && map.erase(std::string_view("apple")) == 1);
+	assert(map.size() == 1 && map.try_emplace(std::string("cherry"), 3).second);
+}
+#endif
+
+int main() {
+	SwissHashMap<std::string, int> map;
+	map["one"] = 1;
+	map["two"] = 2;
+	map["three"] = 3;
+	std::cout << "size " << map.size() << ", capacity " << map.capacity() << ", two " << map.at("two") << '\n';
+
+	testRandom();
+	testOperations();
+	testMoveOnly();
+	testReserve();
+#if __cplusplus >= 201703L
+	testHeterogeneous();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,525 @@
+#pragma once
+#ifndef _ASYNC_QUEUE_HEADER_
+#define _ASYNC_QUEUE_HEADER_
+
+#if !defined(__cpp_impl_coroutine)
+#error "AsyncQueue requires C++20 coroutines."
+#endif
+
+#include <new>					// Placement new.
+#include <atomic>				// The tickets, the cell states and the epochs.
+#include <memory>				// Smart pointers.
+#include <cstdint>				// The cell states.
+#include <utility>				// std::move().
+#include <optional>				// The value handed to a waiter.
+#include <coroutine>				// Suspend and resume the waiters.
+#include <type_traits>				// The nothrow move requirement.
+
+// Resumes the coroutine right away, in the thread that calls push().
+struct InlineScheduler {
+	void schedule(std::coroutine_handle<> handle);
+};
+
+// An unbounded queue for coroutines. co_await queue.pop() suspends the coroutine until there
+// is an element, without blocking the thread. Every push() either stores the element or hands
+// it to exactly one suspended coroutine, which is resumed through the scheduler.
+// The scheduler must provide schedule(std::coroutine_handle<>).
+//
+// There is no lock. push() and pop() take tickets from two counters, and the n-th push() meets
+// the n-th pop() in the n-th cell: whichever comes second finds the element or the waiter
+// there, and a CAS on the cell state settles the race. The cells are in segments, which are
+// linked in order and freed once both sides are done with them. A thread only follows the
+// links inside an epoch, and a segment is freed two epochs after it became unreachable.
+// The move constructor of T must not throw, because the elements move after a ticket is taken.
+template <typename T, typename Scheduler = InlineScheduler>
+class AsyncQueue {
+	static_assert(std::is_nothrow_move_constructible<T>::value, "The elements must be nothrow movable.");
+
+	struct Segment;
+
+public:
+	class PopAwaiter {
+		friend class AsyncQueue<T, Scheduler>;
+		PopAwaiter(AsyncQueue<T, Scheduler> *queue);
+
+	public:
+		bool await_ready();
+		bool await_suspend(std::coroutine_handle<> handle);
+		T await_resume();
+
+	private:
+		void take();
+
+	private:
+		AsyncQueue<T, Scheduler> *m_queue;
+		Segment *m_segment;
+		size_t m_index;
+		std::coroutine_handle<> m_handle;
+		std::optional<T> m_value;
+	};
+
+public:
+	AsyncQueue(Scheduler &scheduler);
+	AsyncQueue(const AsyncQueue &r) = delete;
+	AsyncQueue& operator=(const AsyncQueue &rhs) = delete;
+
+	// The queue must outlive the suspended coroutines.
+	~AsyncQueue();
+
+public:
+	void push(const T &value);
+	void push(T &&value);
+
+	// Use as co_await queue.pop().
+	PopAwaiter pop();
+
+	std::unique_ptr<T> try_pop();
+	bool try_pop(T &value);
+
+	// The number of elements minus the number of waiters, if it is positive.
+	size_t size() const;
+	bool empty() const;
+
+private:
+	// The state of a cell: no one has come yet, the element is there, try_pop() gave up
+	// on the cell, or the address of the PopAwaiter waiting there.
+	static constexpr uintptr_t Empty = 0;
+	static constexpr uintptr_t Stored = 1;
+	static constexpr uintptr_t Broken = 2;
+
+	static constexpr size_t SegmentSize = 32;
+
+	struct Cell {
+		std::atomic<uintptr_t> m_state;
+		alignas(T) unsigned char m_storage[sizeof(T)];
+
+		T* value();
+	};
+
+	struct Segment {
+		explicit Segment(size_t id);
+
+		const size_t m_id;
+		std::atomic<Segment*> m_next;
+
+		// Two per cell, one for each side, and one for each of the two side pointers.
+		std::atomic<size_t> m_refs;
+
+		Segment *m_retiredNext;
+		uint64_t m_retiredEpoch;
+
+		Cell m_cells[SegmentSize];
+	};
+
+	// Keeps the thread in the current epoch, so the segments it reaches are not freed.
+	class EpochGuard {
+	public:
+		explicit EpochGuard(AsyncQueue<T, Scheduler> *queue);
+		EpochGuard(const EpochGuard &r) = delete;
+		EpochGuard& operator=(const EpochGuard &rhs) = delete;
+		~EpochGuard();
+
+	private:
+		AsyncQueue<T, Scheduler> *m_queue;
+		uint64_t m_epoch;
+	};
+
+	// Takes the next ticket of one side and finds its cell, adding the segments on the way.
+	Cell* claim(std::atomic<Segment*> &side, std::atomic<size_t> &tickets, Segment *&segment);
+	void advance(std::atomic<Segment*> &side, Segment *target);
+
+	// One side is done with a cell, or a side pointer has left the segment.
+	void release(Segment *segment);
+	void retire(Segment *segment);
+	void reclaim();
+
+	void pushValue(T &&value);
+
+private:
+	alignas(64) std::atomic<size_t> m_pushTickets;
+	std::atomic<Segment*> m_pushSegment;
+
+	alignas(64) std::atomic<size_t> m_popTickets;
+	std::atomic<Segment*> m_popSegment;
+
+	// The threads in each of the two latest epochs, by the parity of the epoch.
+	alignas(64) std::atomic<uint64_t> m_epoch;
+	std::atomic<size_t> m_active[2];
+	std::atomic<Segment*> m_retired;
+
+	Scheduler &m_scheduler;
+};
+
+inline void InlineScheduler::schedule(std::coroutine_handle<> handle) {
+	handle.resume();
+}
+
+/* --- POP AWAITER --- */
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::PopAwaiter::PopAwaiter(AsyncQueue<T, Scheduler> *queue)
+	: m_queue(queue)
+	, m_segment(nullptr)
+	, m_index(0) {
+
+}
+
+template <typename T, typename Scheduler>
+inline bool AsyncQueue<T, Scheduler>::PopAwaiter::await_ready() {
+	Cell *cell;
+	{
+		EpochGuard guard(m_queue);
+		cell = m_queue->claim(m_queue->m_popSegment, m_queue->m_popTickets, m_segment);
+	}
+
+	// The cell keeps its segment alive until this side releases it.
+	m_index = static_cast<size_t>(cell - m_segment->m_cells);
+
+	// The fast path: the element is there, so there is no need to suspend.
+	if (cell->m_state.load(std::memory_order_acquire) == Stored) {
+		take();
+		return true;
+	}
+
+	return false;
+}
+
+template <typename T, typename Scheduler>
+inline bool AsyncQueue<T, Scheduler>::PopAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	m_handle = handle;
+
+	// From the successful CAS on, push() may resume the coroutine on another thread,
+	// so the awaiter must not be touched after it.
+	AsyncQueue<T, Scheduler> *queue = m_queue;
+	Segment *segment = m_segment;
+
+	uintptr_t state = Empty;
+	if (segment->m_cells[m_index].m_state.compare_exchange_strong(state, reinterpret_cast<uintptr_t>(this), std::memory_order_acq_rel)) {
+		queue->release(segment);
+		return true;
+	}
+
+	// The element has arrived in the meantime.
+	take();
+	return false;
+}
+
+template <typename T, typename Scheduler>
+inline T AsyncQueue<T, Scheduler>::PopAwaiter::await_resume() {
+	return std::move(*m_value);
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::PopAwaiter::take() {
+	T *value = m_segment->m_cells[m_index].value();
+
+	m_value.emplace(std::move(*value));
+	value->~T();
+
+	m_queue->release(m_segment);
+}
+
+/* --- EPOCH GUARD --- */
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::EpochGuard::EpochGuard(AsyncQueue<T, Scheduler> *queue)
+	: m_queue(queue) {
+	// The epoch must not change between reading it and registering in it.
+	while (true) {
+		m_epoch = m_queue->m_epoch.load();
+		m_queue->m_active[m_epoch & 1].fetch_add(1);
+
+		if (m_queue->m_epoch.load() == m_epoch) {
+			break;
+		}
+
+		m_queue->m_active[m_epoch & 1].fetch_sub(1);
+	}
+}
+
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::EpochGuard::~EpochGuard() {
+	m_queue->m_active[m_epoch & 1].fetch_sub(1);
+}
+
+/* --- ASYNC QUEUE --- */
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::AsyncQueue(Scheduler &scheduler)
+	: m_pushTickets(0)
+	, m_pushSegment(nullptr)
+	, m_popTickets(0)
+	, m_popSegment(nullptr)
+	, m_epoch(0)
+	, m_retired(nullptr)
+	, m_scheduler(scheduler) {
+	m_active[0].store(0);
+	m_active[1].store(0);
+
+	Segment *first = new Segment(0);
+	m_pushSegment.store(first);
+	m_popSegment.store(first);
+}
+
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::~AsyncQueue() {
+	Segment *retired = m_retired.load();
+	while (retired) {
+		Segment *next = retired->m_retiredNext;
+		delete retired;
+		retired = next;
+	}
+
+	// The segments before the side pointers are all retired. The rest might hold elements.
+	Segment *push = m_pushSegment.load();
+	Segment *pop = m_popSegment.load();
+	Segment *segment = push->m_id < pop->m_id ? push : pop;
+
+	while (segment) {
+		for (Cell &cell : segment->m_cells) {
+			if (cell.m_state.load() == Stored) {
+				cell.value()->~T();
+			}
+		}
+
+		Segment *next = segment->m_next.load();
+		delete segment;
+		segment = next;
+	}
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::push(const T &value) {
+	// A copy, which throws, must not leave a claimed cell behind.
+	T copy(value);
+	pushValue(std::move(copy));
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::push(T &&value) {
+	pushValue(std::move(value));
+}
+
+template <typename T, typename Scheduler>
+inline typename AsyncQueue<T, Scheduler>::PopAwaiter AsyncQueue<T, Scheduler>::pop() {
+	return PopAwaiter(this);
+}
+
+template <typename T, typename Scheduler>
+inline std::unique_ptr<T> AsyncQueue<T, Scheduler>::try_pop() {
+	while (m_popTickets.load() < m_pushTickets.load()) {
+		Segment *segment;
+		Cell *cell;
+		{
+			EpochGuard guard(this);
+			cell = claim(m_popSegment, m_popTickets, segment);
+		}
+
+		// The push() of the cell has not stored the element yet. It will take a new ticket.
+		uintptr_t state = Empty;
+		if (cell->m_state.compare_exchange_strong(state, Broken, std::memory_order_acq_rel)) {
+			release(segment);
+			continue;
+		}
+
+		std::unique_ptr<T> result(new T(std::move(*cell->value())));
+		cell->value()->~T();
+		release(segment);
+		return result;
+	}
+
+	return nullptr;
+}
+
+template <typename T, typename Scheduler>
+inline bool AsyncQueue<T, Scheduler>::try_pop(T &value) {
+	while (m_popTickets.load() < m_pushTickets.load()) {
+		Segment *segment;
+		Cell *cell;
+		{
+			EpochGuard guard(this);
+			cell = claim(m_popSegment, m_popTickets, segment);
+		}
+
+		uintptr_t state = Empty;
+		if (cell->m_state.compare_exchange_strong(state, Broken, std::memory_order_acq_rel)) {
+			release(segment);
+			continue;
+		}
+
+		value = std::move(*cell->value());
+		cell->value()->~T();
+		release(segment);
+		return true;
+	}
+
+	return false;
+}
+
+template <typename T, typename Scheduler>
+inline size_t AsyncQueue<T, Scheduler>::size() const {
+	const size_t pops = m_popTickets.load();
+	const size_t pushes = m_pushTickets.load();
+
+	return pushes > pops ? pushes - pops : 0;
+}
+
+template <typename T, typename Scheduler>
+inline bool AsyncQueue<T, Scheduler>::empty() const {
+	return size() == 0;
+}
+
+template <typename T, typename Scheduler>
+inline T* AsyncQueue<T, Scheduler>::Cell::value() {
+	return std::launder(reinterpret_cast<T*>(m_storage));
+}
+
+template <typename T, typename Scheduler>
+inline AsyncQueue<T, Scheduler>::Segment::Segment(size_t id)
+	: m_id(id)
+	, m_next(nullptr)
+	, m_refs(2 * SegmentSize + 2)
+	, m_retiredNext(nullptr)
+	, m_retiredEpoch(0) {
+	for (Cell &cell : m_cells) {
+		cell.m_state.store(Empty, std::memory_order_relaxed);
+	}
+}
+
+template <typename T, typename Scheduler>
+inline typename AsyncQueue<T, Scheduler>::Cell* AsyncQueue<T, Scheduler>::claim(std::atomic<Segment*> &side, std::atomic<size_t> &tickets, Segment *&segment) {
+	// The side pointer is read before the ticket is taken, so it is never past the ticket.
+	Segment *current = side.load();
+	const size_t ticket = tickets.fetch_add(1);
+	const size_t id = ticket / SegmentSize;
+
+	while (current->m_id < id) {
+		Segment *next = current->m_next.load(std::memory_order_acquire);
+
+		if (!next) {
+			Segment *fresh = new Segment(current->m_id + 1);
+			if (current->m_next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+				next = fresh;
+			}
+			else {
+				delete fresh;
+			}
+		}
+
+		current = next;
+	}
+
+	advance(side, current);
+
+	segment = current;
+	return &current->m_cells[ticket % SegmentSize];
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::advance(std::atomic<Segment*> &side, Segment *target) {
+	Segment *current = side.load();
+
+	while (current->m_id < target->m_id) {
+		if (side.compare_exchange_weak(current, target)) {
+			// The side has left the segments before the target.
+			while (current != target) {
+				Segment *next = current->m_next.load(std::memory_order_acquire);
+				release(current);
+				current = next;
+			}
+
+			return;
+		}
+	}
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::release(Segment *segment) {
+	if (segment->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		retire(segment);
+	}
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::retire(Segment *segment) {
+	// Nobody can reach the segment from now on, but the threads in the current epoch
+	// might still be passing through it.
+	segment->m_retiredEpoch = m_epoch.load();
+
+	Segment *head = m_retired.load();
+	do {
+		segment->m_retiredNext = head;
+	} while (!m_retired.compare_exchange_weak(head, segment));
+
+	reclaim();
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::reclaim() {
+	// The epoch can move on, once the threads of the previous one have left.
+	uint64_t epoch = m_epoch.load();
+	if (m_active[(epoch + 1) & 1].load() != 0 || !m_epoch.compare_exchange_strong(epoch, epoch + 1)) {
+		return;
+	}
+
+	// The threads, which could reach a segment retired two epochs ago, are gone.
+	Segment *segment = m_retired.exchange(nullptr);
+	while (segment) {
+		Segment *next = segment->m_retiredNext;
+
+		if (segment->m_retiredEpoch + 2 <= epoch + 1) {
+			delete segment;
+		}
+		else {
+			Segment *head = m_retired.load();
+			do {
+				segment->m_retiredNext = head;
+			} while (!m_retired.compare_exchange_weak(head, segment));
+		}
+
+		segment = next;
+	}
+}
+
+template <typename T, typename Scheduler>
+inline void AsyncQueue<T, Scheduler>::pushValue(T &&value) {
+	// The element leaves a broken cell before the segment is released.
+	std::optional<T> pending;
+	T *source = &value;
+
+	while (true) {
+		Segment *segment;
+		Cell *cell;
+		{
+			EpochGuard guard(this);
+			cell = claim(m_pushSegment, m_pushTickets, segment);
+		}
+
+		uintptr_t state = cell->m_state.load(std::memory_order_acquire);
+
+		if (state == Empty) {
+			// Stores the element and publishes it, unless a waiter or try_pop() comes first.
+			new (cell->m_storage) T(std::move(*source));
+			if (cell->m_state.compare_exchange_strong(state, Stored, std::memory_order_acq_rel)) {
+				release(segment);
+				return;
+			}
+
+			pending.emplace(std::move(*cell->value()));
+			cell->value()->~T();
+			source = &*pending;
+		}
+
+		if (state == Broken) {
+			release(segment);
+			continue;
+		}
+
+		// A waiter: the element goes straight to it.
+		PopAwaiter *awaiter = reinterpret_cast<PopAwaiter*>(state);
+		awaiter->m_value.emplace(std::move(*source));
+
+		release(segment);
+		m_scheduler.schedule(awaiter->m_handle);
+		return;
+	}
+}
+
+#endif // !_ASYNC_QUEUE_HEADER_
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <string>
+
+#include "AsyncQueue.h"
+#include "../ThreadSafeQueue/ThreadSafeQueue.h"
+
+// A coroutine, which starts right away and destroys itself when it finishes.
+struct Task {
+	struct promise_type {
+		Task get_return_object() { return Task(); }
+		std::suspend_never initial_suspend() { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// Resumes the coroutines on a single executor thread.
+class ThreadScheduler {
+public:
+	ThreadScheduler()
+		: m_thread([this]() {
+			while (std::coroutine_handle<> handle = *m_handles.wait_pop()) {
+				handle.resume();
+			}
+		}) {
+
+	}
+
+	~ThreadScheduler() {
+		// An empty handle stops the executor.
+		m_handles.push(std::coroutine_handle<>());
+		m_thread.join();
+	}
+
+	void schedule(std::coroutine_handle<> handle) {
+		m_handles.push(handle);
+	}
+
+private:
+	ThreadSafeQueue<std::coroutine_handle<>> m_handles;
+	std::thread m_thread;
+};
+
+Task consume(AsyncQueue<int> &queue, std::vector<int> &result, int count) {
+	for (int i = 0; i < count; ++i) {
+		result.push_back(co_await queue.pop());
+	}
+}
+
+template <typename Scheduler>
+Task sum(AsyncQueue<int, Scheduler> &queue, std::atomic<long long> &total, std::atomic<int> &done) {
+	total += co_await queue.pop();
+	done += 1;
+}
+
+void testInline() {
+	InlineScheduler scheduler;
+	AsyncQueue<int> queue(scheduler);
+
+	// The values are there, so the coroutine does not suspend.
+	queue.push(1);
+	queue.push(2);
+
+	std::vector<int> result;
+	consume(queue, result, 4);
+
+	assert(result.size() == 2);
+	assert(queue.empty());
+
+	// Each push() resumes the suspended coroutine.
+	queue.push(3);
+	assert(result.size() == 3);
+
+	queue.push(4);
+	assert(result.size() == 4);
+	assert(result[0] == 1 && result[1] == 2 && result[2] == 3 && result[3] == 4);
+
+	// Nobody is waiting anymore.
+	queue.push(5);
+	assert(queue.size() == 1);
+	assert(*queue.try_pop() == 5);
+	assert(queue.try_pop() == nullptr);
+}
+
+void testManyWaiters(int waiters, int producers) {
+	ThreadScheduler scheduler;
+	AsyncQueue<int, ThreadScheduler> queue(scheduler);
+
+	std::atomic<long long> total(0);
+	std::atomic<int> done(0);
+
+	// Thousands of suspended coroutines, but no thread per waiter.
+	for (int i = 0; i < waiters / 2; ++i) {
+		sum(queue, total, done);
+	}
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.emplace_back([&queue, p, producers, waiters]() {
+			for (int i = p; i < waiters; i += producers) {
+				queue.push(i);
+			}
+		});
+	}
+
+	// These race with the producers, some of them take the fast path.
+	for (int i = waiters / 2; i < waiters; ++i) {
+		sum(queue, total, done);
+	}
+
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	while (done != waiters) {
+		std::this_thread::yield();
+	}
+
+	assert(total == (long long)waiters * (waiters - 1) / 2);
+	assert(queue.empty());
+}
+
+Task collect(AsyncQueue<std::string, ThreadScheduler> &queue, std::atomic<long long> &total, std::atomic<int> &done) {
+	total += std::stoll(co_await queue.pop());
+	done += 1;
+}
+
+void testMixed(int count, int producers) {
+	ThreadScheduler scheduler;
+	AsyncQueue<std::string, ThreadScheduler> queue(scheduler);
+
+	std::atomic<long long> total(0);
+	std::atomic<int> done(0);
+
+	// Half of the elements go to coroutines, some of which suspend.
+	for (int i = 0; i < count / 4; ++i) {
+		collect(queue, total, done);
+	}
+
+	// Strings, so the sanitizers see every element that is lost or left behind.
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.emplace_back([&queue, p, producers, count]() {
+			for (int i = p; i < count; i += producers) {
+				queue.push(std::to_string(i));
+			}
+		});
+	}
+
+	for (int i = count / 4; i < count / 2; ++i) {
+		collect(queue, total, done);
+	}
+
+	// The rest is polled with try_pop(), which breaks the cells it gets to first.
+	std::string value;
+	while (done != count) {
+		if (queue.try_pop(value)) {
+			total += std::stoll(value);
+			done += 1;
+		}
+	}
+
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	assert(total == (long long)count * (count - 1) / 2);
+	assert(queue.empty());
+
+	// The leftovers are destroyed with the queue.
+	queue.push("1");
+	queue.push("2");
+}
+
+int main() {
+	testInline();
+
+	testManyWaiters(10000, 1);
+	testManyWaiters(10000, 4);
+
+	testMixed(100000, 4);
+
+	return 0;
+}
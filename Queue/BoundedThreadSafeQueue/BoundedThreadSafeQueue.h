@@ -0,0 +1,291 @@
+#pragma once
+#ifndef _BOUNDED_THREAD_SAFE_QUEUE_HEADER_
+#define _BOUNDED_THREAD_SAFE_QUEUE_HEADER_
+
+#include <new>					// Placement new.
+#include <mutex>				// Mutex locks for the head and the tail.
+#include <memory>				// Smart pointers.
+#include <atomic>				// Number of elements in the queue.
+#include <utility>				// std::move(), std::forward().
+#include <stdexcept>				// Exceptions.
+#include <condition_variable>			// Wait for pop() and push().
+
+// A blocking queue over a preallocated ring buffer. Like ThreadSafeQueue, push() locks
+// only the tail and pop() locks only the head. The two sides meet through the atomic size,
+// so there is no allocation per element.
+template <typename T>
+class BoundedThreadSafeQueue {
+	// Uninitialized storage for a single element.
+	struct Slot {
+		alignas(T) unsigned char m_storage[sizeof(T)];
+
+		T* get();
+	};
+
+	// Keeps the head and the tail on separate cache lines.
+	static constexpr size_t CacheLineSize = 64;
+
+public:
+	BoundedThreadSafeQueue(size_t maxQueueCapacity);
+	BoundedThreadSafeQueue(const BoundedThreadSafeQueue &r) = delete;
+	BoundedThreadSafeQueue& operator=(const BoundedThreadSafeQueue &rhs) = delete;
+	BoundedThreadSafeQueue(BoundedThreadSafeQueue &&r) = delete;
+	BoundedThreadSafeQueue& operator=(BoundedThreadSafeQueue &&rhs) = delete;
+	~BoundedThreadSafeQueue();
+
+public:
+	void push(const T &value);
+	void push(T &&value);
+
+	std::unique_ptr<T> try_pop();
+	std::unique_ptr<T> wait_pop();
+
+	// Move the element into value without allocating.
+	bool try_pop(T &value);
+	void wait_pop(T &value);
+
+	size_t size() const;
+	size_t capacity() const;
+	bool empty() const;
+
+private:
+	template <typename U>
+	void pushImpl(U &&value);
+
+	template <typename Consumer>
+	size_t popHead(Consumer &&consume);
+
+	void notifyPop();
+	void notifyPush();
+
+	size_t next(size_t idx) const;
+
+private:
+	Slot *m_slots;
+	const size_t m_maxCapacity;
+
+	alignas(CacheLineSize) size_t m_head;
+	std::mutex m_headMtx;
+	std::condition_variable m_wait_pop_cv;
+
+	alignas(CacheLineSize) size_t m_tail;
+	std::mutex m_tailMtx;
+	std::condition_variable m_wait_push_cv;
+
+	alignas(CacheLineSize) std::atomic<size_t> m_size;
+};
+
+template <typename T>
+inline T* BoundedThreadSafeQueue<T>::Slot::get() {
+	return reinterpret_cast<T*>(m_storage);
+}
+
+template <typename T>
+inline BoundedThreadSafeQueue<T>::BoundedThreadSafeQueue(size_t maxQueueCapacity)
+	: m_slots(nullptr)
+	, m_maxCapacity(maxQueueCapacity)
+	, m_head(0)
+	, m_tail(0)
+	, m_size(0) {
+
+	if (maxQueueCapacity == 0) {
+		throw std::logic_error("Invalid maxCapacity");
+	}
+
+	m_slots = new Slot[maxQueueCapacity];
+}
+
+template <typename T>
+inline BoundedThreadSafeQueue<T>::~BoundedThreadSafeQueue() {
+	// Destroy the remaining elements.
+	for (size_t i = 0, idx = m_head; i < m_size.load(); ++i, idx = next(idx)) {
+		m_slots[idx].get()->~T();
+	}
+
+	delete[] m_slots;
+
+	// Clear everything.
+	m_slots = nullptr;
+	m_size.store(0);
+}
+
+template <typename T>
+inline void BoundedThreadSafeQueue<T>::push(const T &value) {
+	pushImpl(value);
+}
+
+template <typename T>
+inline void BoundedThreadSafeQueue<T>::push(T &&value) {
+	pushImpl(std::move(value));
+}
+
+template <typename T>
+inline std::unique_ptr<T> BoundedThreadSafeQueue<T>::try_pop() {
+	std::unique_ptr<T> result;
+	size_t old_size;
+
+	{
+		std::lock_guard<std::mutex> headLock(m_headMtx);
+
+		if (m_size.load() == 0) {
+			return result;
+		}
+
+		old_size = popHead([&result](T &value) { result.reset(new T(std::move(value))); });
+	}
+
+	// The push() threads wait only on a full queue.
+	if (old_size == m_maxCapacity) {
+		notifyPush();
+	}
+
+	return result;
+}
+
+template <typename T>
+inline std::unique_ptr<T> BoundedThreadSafeQueue<T>::wait_pop() {
+	std::unique_ptr<T> result;
+	size_t old_size;
+
+	{
+		std::unique_lock<std::mutex> headLock(m_headMtx);
+		m_wait_pop_cv.wait(headLock, [this]() { return m_size.load() != 0; });
+
+		old_size = popHead([&result](T &value) { result.reset(new T(std::move(value))); });
+	}
+
+	if (old_size == m_maxCapacity) {
+		notifyPush();
+	}
+
+	return result;
+}
+
+template <typename T>
+inline bool BoundedThreadSafeQueue<T>::try_pop(T &value) {
+	size_t old_size;
+
+	{
+		std::lock_guard<std::mutex> headLock(m_headMtx);
+
+		if (m_size.load() == 0) {
+			return false;
+		}
+
+		old_size = popHead([&value](T &head) { value = std::move(head); });
+	}
+
+	if (old_size == m_maxCapacity) {
+		notifyPush();
+	}
+
+	return true;
+}
+
+template <typename T>
+inline void BoundedThreadSafeQueue<T>::wait_pop(T &value) {
+	size_t old_size;
+
+	{
+		std::unique_lock<std::mutex> headLock(m_headMtx);
+		m_wait_pop_cv.wait(headLock, [this]() { return m_size.load() != 0; });
+
+		old_size = popHead([&value](T &head) { value = std::move(head); });
+	}
+
+	if (old_size == m_maxCapacity) {
+		notifyPush();
+	}
+}
+
+template <typename T>
+inline size_t BoundedThreadSafeQueue<T>::size() const {
+	return m_size.load();
+}
+
+template <typename T>
+inline size_t BoundedThreadSafeQueue<T>::capacity() const {
+	return m_maxCapacity;
+}
+
+template <typename T>
+inline bool BoundedThreadSafeQueue<T>::empty() const {
+	return m_size.load() == 0;
+}
+
+template <typename T>
+template <typename U>
+inline void BoundedThreadSafeQueue<T>::pushImpl(U &&value) {
+	size_t old_size;
+
+	{
+		std::unique_lock<std::mutex> tailLock(m_tailMtx);
+
+		// Wait until there is enough space in the queue.
+		m_wait_push_cv.wait(tailLock, [this]() { return m_size.load() < m_maxCapacity; });
+
+		// Nothing has changed if the construction throws.
+		new (m_slots[m_tail].get()) T(std::forward<U>(value));
+		m_tail = next(m_tail);
+
+		// Publish the element to the pop() threads.
+		old_size = m_size.fetch_add(1);
+
+		// Only the push() that fills the last slot can be notified by pop(),
+		// so we pass the notification to another waiting push() thread.
+		if (old_size + 1 < m_maxCapacity) {
+			m_wait_push_cv.notify_one();
+		}
+	}
+
+	// The pop() threads wait only on an empty queue.
+	if (old_size == 0) {
+		notifyPop();
+	}
+}
+
+template <typename T>
+template <typename Consumer>
+inline size_t BoundedThreadSafeQueue<T>::popHead(Consumer &&consume) {
+	// The head mutex is locked and the queue is not empty.
+	T *head = m_slots[m_head].get();
+
+	// Nothing has changed if the consumer throws.
+	consume(*head);
+
+	head->~T();
+	m_head = next(m_head);
+
+	// Release the slot to the push() threads.
+	const size_t old_size = m_size.fetch_sub(1);
+
+	// Only the pop() that takes the first element can be notified by push(),
+	// so we pass the notification to another waiting pop() thread.
+	if (old_size > 1) {
+		m_wait_pop_cv.notify_one();
+	}
+
+	return old_size;
+}
+
+template <typename T>
+inline void BoundedThreadSafeQueue<T>::notifyPop() {
+	// A pop() thread might have checked the size, but not started waiting yet.
+	// It holds the head mutex until it waits, so we cannot miss it.
+	std::lock_guard<std::mutex> headLock(m_headMtx);
+	m_wait_pop_cv.notify_one();
+}
+
+template <typename T>
+inline void BoundedThreadSafeQueue<T>::notifyPush() {
+	// Same as notifyPop(), but for the tail.
+	std::lock_guard<std::mutex> tailLock(m_tailMtx);
+	m_wait_push_cv.notify_one();
+}
+
+template <typename T>
+inline size_t BoundedThreadSafeQueue<T>::next(size_t idx) const {
+	return idx + 1 == m_maxCapacity ? 0 : idx + 1;
+}
+
+#endif // !_BOUNDED_THREAD_SAFE_QUEUE_HEADER_
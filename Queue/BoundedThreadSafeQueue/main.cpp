@@ -0,0 +1,88 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <thread>
+#include <string>
+
+#include "BoundedThreadSafeQueue.h"
+
+void testQueue(int num_threads, int max_size) {
+	BoundedThreadSafeQueue<int> queue(max_size);
+
+	std::vector<std::thread> threads(num_threads);
+
+	void (BoundedThreadSafeQueue<int>::*push)(const int&) = &BoundedThreadSafeQueue<int>::push;
+	std::unique_ptr<int> (BoundedThreadSafeQueue<int>::*wait_pop)() = &BoundedThreadSafeQueue<int>::wait_pop;
+
+	// More pushes than slots, so some of them block until the pop() threads make space.
+	for (int i = 0; i < num_threads / 2; ++i) {
+		threads[i] = std::thread(wait_pop, std::ref(queue));
+	}
+
+	for (int i = num_threads / 2; i < num_threads; ++i) {
+		threads[i] = std::thread(push, std::ref(queue), i);
+	}
+
+	for (int i = 0; i < num_threads; ++i) {
+		threads[i].join();
+	}
+
+	assert(queue.empty());
+}
+
+void testProducerConsumer(int items, int max_size) {
+	BoundedThreadSafeQueue<int> queue(max_size);
+
+	std::thread producer([&queue, items]() {
+		for (int i = 0; i < items; ++i) {
+			queue.push(i);
+		}
+	});
+
+	// The ring keeps the FIFO order.
+	for (int i = 0; i < items; ++i) {
+		int value = -1;
+		queue.wait_pop(value);
+		assert(value == i);
+	}
+
+	producer.join();
+	assert(queue.empty());
+}
+
+void testElementLifetime() {
+	BoundedThreadSafeQueue<std::string> queue(3);
+
+	// Wrap around the ring a few times.
+	for (int i = 0; i < 10; ++i) {
+		queue.push(std::string(100, char('a' + i)));
+		queue.push(std::to_string(i));
+
+		assert(queue.size() == 2);
+		assert(*queue.try_pop() == std::string(100, char('a' + i)));
+
+		std::string value;
+		assert(queue.try_pop(value));
+		assert(value == std::to_string(i));
+	}
+
+	assert(queue.try_pop() == nullptr);
+
+	// The destructor frees whatever is left.
+	queue.push("left");
+	queue.push("in the queue");
+}
+
+int main() {
+	testQueue(10, 1);
+	testQueue(10, 5);
+	testQueue(100, 20);
+	testQueue(100, 1000);
+
+	testProducerConsumer(100000, 1);
+	testProducerConsumer(100000, 64);
+
+	testElementLifetime();
+
+	return 0;
+}
@@ -0,0 +1,218 @@
+#pragma once
+#ifndef _LATENCY_HISTOGRAM_HEADER_
+#define _LATENCY_HISTOGRAM_HEADER_
+
+#include <array>				// The buckets.
+#include <atomic>				// Lock-free counters.
+#include <chrono>				// The portable clock and the calibration of the TSC.
+#include <thread>				// Sleep during the calibration.
+#include <cstdint>				// Fixed width integers.
+
+#if defined(_MSC_VER)
+#include <intrin.h>				// __rdtsc().
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>				// __rdtsc().
+#endif
+
+// Reads the time stamp counter where there is one, otherwise the steady clock in nanoseconds.
+struct LatencyClock {
+	static uint64_t now();
+	static double nanosecondsPerTick();
+};
+
+// The latencies in nanoseconds.
+struct LatencySnapshot {
+	uint64_t count;
+	double p50;
+	double p99;
+	double p999;
+	double max;
+};
+
+// A log-linear histogram: every power of two is split into 2^SubBucketBits linear buckets,
+// so the relative error is below 1 / 2^SubBucketBits for any value. record() is a few
+// relaxed atomic increments and can be called from any number of threads.
+class LatencyHistogram {
+	static constexpr unsigned SubBucketBits = 5;
+	static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+	static constexpr size_t Buckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+public:
+	LatencyHistogram();
+	LatencyHistogram(const LatencyHistogram &r) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram &rhs) = delete;
+
+public:
+	// Values are in clock ticks.
+	void record(uint64_t value);
+	void recordSince(uint64_t startTicks);
+
+	uint64_t count() const;
+	uint64_t max() const;
+	uint64_t percentile(double q) const;
+
+	LatencySnapshot snapshot() const;
+	void reset();
+
+private:
+	static size_t bucketIndex(uint64_t value);
+	static uint64_t bucketHighestValue(size_t idx);
+
+private:
+	std::array<std::atomic<uint64_t>, Buckets> m_counts;
+	std::atomic<uint64_t> m_total;
+	std::atomic<uint64_t> m_max;
+};
+
+/* --- LATENCY CLOCK --- */
+inline uint64_t LatencyClock::now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline double LatencyClock::nanosecondsPerTick() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	// Measure the frequency of the TSC against the steady clock once.
+	static const double nsPerTick = []() {
+		const auto startTime = std::chrono::steady_clock::now();
+		const uint64_t startTicks = now();
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		const uint64_t endTicks = now();
+		const auto endTime = std::chrono::steady_clock::now();
+
+		const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+		return endTicks > startTicks ? ns / double(endTicks - startTicks) : 1.0;
+	}();
+
+	return nsPerTick;
+#else
+	return 1.0;
+#endif
+}
+
+/* --- LATENCY HISTOGRAM --- */
+inline LatencyHistogram::LatencyHistogram()
+	: m_total(0)
+	, m_max(0) {
+
+	for (std::atomic<uint64_t> &counter : m_counts) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+}
+
+inline void LatencyHistogram::record(uint64_t value) {
+	m_counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	m_total.fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+	while (value > currentMax && !m_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+		//loop...
+	}
+}
+
+inline void LatencyHistogram::recordSince(uint64_t startTicks) {
+	const uint64_t endTicks = LatencyClock::now();
+
+	// The counters of different cores might be slightly out of sync.
+	record(endTicks > startTicks ? endTicks - startTicks : 0);
+}
+
+inline uint64_t LatencyHistogram::count() const {
+	return m_total.load(std::memory_order_relaxed);
+}
+
+inline uint64_t LatencyHistogram::max() const {
+	return m_max.load(std::memory_order_relaxed);
+}
+
+inline uint64_t LatencyHistogram::percentile(double q) const {
+	// The counters keep changing, so we work on a copy.
+	std::array<uint64_t, Buckets> counts;
+	uint64_t total = 0;
+
+	for (size_t i = 0; i < Buckets; ++i) {
+		counts[i] = m_counts[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	// The rank of the value, at least 1.
+	uint64_t rank = uint64_t(q * double(total) + 0.5);
+	rank = rank ? (rank < total ? rank : total) : 1;
+
+	const uint64_t maxValue = max();
+	uint64_t seen = 0;
+
+	for (size_t i = 0; i < Buckets; ++i) {
+		seen += counts[i];
+
+		if (seen >= rank) {
+			const uint64_t value = bucketHighestValue(i);
+			return value < maxValue ? value : maxValue;
+		}
+	}
+
+	return maxValue;
+}
+
+inline LatencySnapshot LatencyHistogram::snapshot() const {
+	const double nsPerTick = LatencyClock::nanosecondsPerTick();
+
+	LatencySnapshot result;
+	result.count = count();
+	result.p50 = double(percentile(0.5)) * nsPerTick;
+	result.p99 = double(percentile(0.99)) * nsPerTick;
+	result.p999 = double(percentile(0.999)) * nsPerTick;
+	result.max = double(max()) * nsPerTick;
+
+	return result;
+}
+
+inline void LatencyHistogram::reset() {
+	for (std::atomic<uint64_t> &counter : m_counts) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+
+	m_total.store(0, std::memory_order_relaxed);
+	m_max.store(0, std::memory_order_relaxed);
+}
+
+inline size_t LatencyHistogram::bucketIndex(uint64_t value) {
+	// The small values have a bucket each.
+	if (value < SubBuckets) {
+		return size_t(value);
+	}
+
+#if defined(_MSC_VER)
+	unsigned long msb;
+	_BitScanReverse64(&msb, value);
+#else
+	const unsigned msb = 63 - __builtin_clzll(value);
+#endif
+
+	// Keep the top SubBucketBits + 1 bits of the value.
+	const unsigned shift = unsigned(msb) - SubBucketBits;
+	return ((shift + 1) << SubBucketBits) + size_t((value >> shift) - SubBuckets);
+}
+
+inline uint64_t LatencyHistogram::bucketHighestValue(size_t idx) {
+	const size_t group = idx >> SubBucketBits;
+	const uint64_t sub = idx & (SubBuckets - 1);
+
+	if (group == 0) {
+		return sub;
+	}
+
+	const unsigned shift = unsigned(group - 1);
+	return ((sub + SubBuckets) << shift) + ((uint64_t(1) << shift) - 1);
+}
+
+#endif // !_LATENCY_HISTOGRAM_HEADER_
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <thread>
+
+#include "LatencyHistogram.h"
+
+int main() {
+	LatencyHistogram histogram;
+	assert(histogram.percentile(0.5) == 0);
+
+	for (uint64_t i = 1; i <= 1000; ++i) {
+		histogram.record(i);
+	}
+
+	assert(histogram.count() == 1000);
+	assert(histogram.max() == 1000);
+
+	// The relative error is below 1/32.
+	const uint64_t p50 = histogram.percentile(0.5);
+	const uint64_t p99 = histogram.percentile(0.99);
+
+	assert(p50 >= 500 && p50 <= 500 + 500 / 32);
+	assert(p99 >= 990 && p99 <= 1000);
+	assert(histogram.percentile(1.0) == 1000);
+
+	// The small values are exact.
+	histogram.reset();
+	histogram.record(7);
+	assert(histogram.percentile(0.5) == 7);
+
+	// Huge values do not overflow the buckets.
+	histogram.record(~uint64_t(0));
+	assert(histogram.percentile(1.0) == ~uint64_t(0));
+
+	// Concurrent recording.
+	histogram.reset();
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; ++t) {
+		threads.emplace_back([&histogram]() {
+			for (uint64_t i = 0; i < 10000; ++i) {
+				histogram.record(i);
+			}
+		});
+	}
+
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	assert(histogram.count() == 80000);
+	assert(histogram.max() == 9999);
+
+	const uint64_t start = LatencyClock::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	histogram.reset();
+	histogram.recordSince(start);
+
+	const LatencySnapshot snapshot = histogram.snapshot();
+	assert(snapshot.count == 1);
+	assert(snapshot.max >= 1e6 * 0.9);
+
+	std::cout << "1ms sleep measured as " << snapshot.max << " ns\n";
+
+	return 0;
+}
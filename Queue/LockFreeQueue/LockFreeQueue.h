@@ -7,6 +7,11 @@
 #include <atomic>
 #include <memory>
 
+// Define QUEUE_LATENCY_HISTOGRAM to measure the time every element spends in the queue.
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+#include "../LatencyHistogram/LatencyHistogram.h"
+#endif
+
 template <typename T>
 class Queue {
 	struct Node;
@@ -31,6 +36,9 @@ class Queue {
 		std::atomic<T*> m_data;
 		std::atomic<NodeCounter> m_count;
 		std::atomic<CountedNodePtr> m_next;
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+		std::atomic<uint64_t> m_enqueueTime;
+#endif
 
 		Node();
 		void releaseRef();
@@ -49,6 +57,11 @@ public:
 	void push(const T &value);
 	std::unique_ptr<T> pop();
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	// The time from push() to pop() of the popped elements.
+	LatencySnapshot latency_snapshot() const;
+#endif
+
 private:
 	void push_non_lock_free(const T &value);
 	void freeMemory();
@@ -60,6 +73,10 @@ private:
 	std::atomic<size_t> m_size;
 	std::atomic<CountedNodePtr> m_head;
 	std::atomic<CountedNodePtr> m_tail;
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	LatencyHistogram m_latency;
+#endif
 };
 
 template <typename T>
@@ -72,7 +89,11 @@ inline Queue<T>::CountedNodePtr::CountedNodePtr(int count, Node *ptr)
 template <typename T>
 inline Queue<T>::Node::Node()
 	: m_data(nullptr)
-	, m_next(CountedNodePtr()) {
+	, m_next(CountedNodePtr())
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	, m_enqueueTime(0)
+#endif
+	{
 
 	// Initially, every node is referenced from the tail and from the m_next pointer of the previous node.
 	NodeCounter new_count{ 0, 2 };
@@ -136,12 +157,22 @@ inline void Queue<T>::push(const T &value) {
 
 	CountedNodePtr old_tail = m_tail.load();
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	const uint64_t enqueueTime = LatencyClock::now();
+#endif
+
 	while (true) {
 		// We do reference m_tail from one more place and we indicate that it's not safe to delete it.
 		increaseExternalCount(m_tail, old_tail);
 
 		T *old_data = nullptr;
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+		// The stamp must be visible before the data. The threads which lose the race
+		// for the node overwrite it with stamps taken at about the same time.
+		old_tail.m_ptr->m_enqueueTime.store(enqueueTime);
+#endif
+
 		// Try to update the data of the old dummy node.
 		if (old_tail.m_ptr->m_data.compare_exchange_strong(old_data, new_data.get())) {
 			
@@ -215,6 +246,10 @@ inline std::unique_ptr<T> Queue<T>::pop() {
 		if (m_head.compare_exchange_strong(old_head, next)) {
 			T * const result = ptr->m_data.exchange(nullptr);
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+			m_latency.recordSince(ptr->m_enqueueTime.load());
+#endif
+
 			// There is no previous node, so we decrase the number of external counters by 1.
 			// Also, we try to free the node associated with old_head.
 			freeExternalCounter(old_head);
@@ -234,6 +269,13 @@ inline std::unique_ptr<T> Queue<T>::pop() {
 	return std::unique_ptr<T>();
 }
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+template <typename T>
+inline LatencySnapshot Queue<T>::latency_snapshot() const {
+	return m_latency.snapshot();
+}
+#endif
+
 template <typename T>
 inline void Queue<T>::freeMemory() {
 	while (pop() != nullptr) {
@@ -41,5 +41,14 @@ int main() {
 
 	assert(q.size() == num_threads);
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	// Every element has been popped, but the last num_threads.
+	const LatencySnapshot snapshot = q.latency_snapshot();
+	assert(snapshot.count == 2 * num_threads);
+	assert(snapshot.p50 <= snapshot.p99 && snapshot.p99 <= snapshot.max);
+
+	std::cout << "p50: " << snapshot.p50 << " ns, p99: " << snapshot.p99 << " ns, max: " << snapshot.max << " ns\n";
+#endif
+
 	return 0;
 }
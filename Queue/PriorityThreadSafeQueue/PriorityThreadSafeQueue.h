@@ -0,0 +1,325 @@
+#pragma once
+#ifndef _PRIORITY_THREAD_SAFE_QUEUE_HEADER_
+#define _PRIORITY_THREAD_SAFE_QUEUE_HEADER_
+
+#include <mutex>				// A single mutex for all of the lanes.
+#include <array>				// The lanes and their weights.
+#include <memory>				// Smart pointers.
+#include <limits>				// The maximum value of the capacity.
+#include <cstdint>				// The bitmap of the lanes.
+#include <stdexcept>				// Exceptions.
+#include <condition_variable>			// Wait for pop() and push().
+
+#if defined(_MSC_VER)
+#include <intrin.h>				// _BitScanReverse64().
+#endif
+
+// A blocking queue with Lanes FIFO lanes. Lane (Lanes - 1) has the highest priority.
+// By default pop() always takes from the highest non-empty lane. If the lanes are given
+// weights, they are served in weighted rounds instead: in every round lane i can pop
+// at most weights[i] elements, while the higher lanes keep their precedence within the round.
+template <typename T, size_t Lanes = 8>
+class PriorityThreadSafeQueue {
+	static_assert(Lanes > 0 && Lanes <= 64, "The lanes must fit in a 64-bit bitmap.");
+
+	struct Node {
+		std::unique_ptr<T> m_data;
+		Node *m_next;
+
+		Node(std::unique_ptr<T> &&data, Node *next = nullptr);
+	};
+
+	struct Lane {
+		Node *m_head;
+		Node *m_tail;
+		size_t m_size;
+		size_t m_weight;
+		size_t m_credit;
+
+		Lane();
+	};
+
+public:
+	PriorityThreadSafeQueue(size_t maxQueueCapacity = std::numeric_limits<size_t>::max());
+	PriorityThreadSafeQueue(const std::array<size_t, Lanes> &laneWeights,
+				size_t maxQueueCapacity = std::numeric_limits<size_t>::max());
+	PriorityThreadSafeQueue(const PriorityThreadSafeQueue &r) = delete;
+	PriorityThreadSafeQueue& operator=(const PriorityThreadSafeQueue &rhs) = delete;
+	PriorityThreadSafeQueue(PriorityThreadSafeQueue &&r) = delete;
+	PriorityThreadSafeQueue& operator=(PriorityThreadSafeQueue &&rhs) = delete;
+	~PriorityThreadSafeQueue();
+
+public:
+	void push(const T &value, size_t priority = 0);
+	std::unique_ptr<T> try_pop();
+	std::unique_ptr<T> wait_pop();
+
+	size_t size() const;
+	size_t size(size_t priority) const;
+	bool empty() const;
+
+private:
+	std::unique_ptr<T> popLane();
+	size_t selectLane();
+	void refillCredits();
+
+	static size_t highestLane(uint64_t mask);
+	static void freeMemory(Node *node);
+
+private:
+	std::array<Lane, Lanes> m_lanes;
+
+	uint64_t m_nonEmpty;		// Bit i is set if lane i has elements.
+	uint64_t m_withCredit;		// Bit i is set if lane i has credit left in the current round.
+	size_t m_size;
+
+	const size_t m_maxCapacity;
+	const bool m_weighted;
+
+	mutable std::mutex m_mtx;
+
+	std::condition_variable m_wait_pop_cv;
+	std::condition_variable m_wait_push_cv;
+};
+
+template <typename T, size_t Lanes>
+inline PriorityThreadSafeQueue<T, Lanes>::Node::Node(std::unique_ptr<T> &&data, Node *next)
+	: m_data(std::move(data))
+	, m_next(next) {
+
+}
+
+template <typename T, size_t Lanes>
+inline PriorityThreadSafeQueue<T, Lanes>::Lane::Lane()
+	: m_head(nullptr)
+	, m_tail(nullptr)
+	, m_size(0)
+	, m_weight(0)
+	, m_credit(0) {
+
+}
+
+template <typename T, size_t Lanes>
+inline PriorityThreadSafeQueue<T, Lanes>::PriorityThreadSafeQueue(size_t maxQueueCapacity)
+	: m_nonEmpty(0)
+	, m_withCredit(0)
+	, m_size(0)
+	, m_maxCapacity(maxQueueCapacity)
+	, m_weighted(false) {
+
+	if (maxQueueCapacity == 0) {
+		throw std::logic_error("Invalid maxCapacity");
+	}
+}
+
+template <typename T, size_t Lanes>
+inline PriorityThreadSafeQueue<T, Lanes>::PriorityThreadSafeQueue(const std::array<size_t, Lanes> &laneWeights, size_t maxQueueCapacity)
+	: m_nonEmpty(0)
+	, m_withCredit(0)
+	, m_size(0)
+	, m_maxCapacity(maxQueueCapacity)
+	, m_weighted(true) {
+
+	if (maxQueueCapacity == 0) {
+		throw std::logic_error("Invalid maxCapacity");
+	}
+
+	for (size_t i = 0; i < Lanes; ++i) {
+		// A lane without weight would never be served.
+		if (laneWeights[i] == 0) {
+			throw std::logic_error("Invalid lane weight");
+		}
+
+		m_lanes[i].m_weight = laneWeights[i];
+	}
+
+	refillCredits();
+}
+
+template <typename T, size_t Lanes>
+inline PriorityThreadSafeQueue<T, Lanes>::~PriorityThreadSafeQueue() {
+	for (Lane &lane : m_lanes) {
+		freeMemory(lane.m_head);
+
+		lane.m_head = nullptr;
+		lane.m_tail = nullptr;
+		lane.m_size = 0;
+	}
+
+	m_nonEmpty = 0;
+	m_size = 0;
+}
+
+template <typename T, size_t Lanes>
+inline void PriorityThreadSafeQueue<T, Lanes>::push(const T &value, size_t priority) {
+	if (priority >= Lanes) {
+		throw std::out_of_range("Invalid priority");
+	}
+
+	// Allocate outside of the lock.
+	std::unique_ptr<Node> new_node(new Node(std::unique_ptr<T>(new T(value))));
+
+	{
+		std::unique_lock<std::mutex> lock(m_mtx);
+
+		// Wait until there is enough space in the queue.
+		m_wait_push_cv.wait(lock, [this]() { return m_size < m_maxCapacity; });
+
+		Lane &lane = m_lanes[priority];
+		Node *node = new_node.release();
+
+		// Append the node to the lane.
+		if (lane.m_tail) {
+			lane.m_tail->m_next = node;
+		}
+		else {
+			lane.m_head = node;
+		}
+
+		lane.m_tail = node;
+		lane.m_size += 1;
+
+		m_nonEmpty |= uint64_t(1) << priority;
+		m_size += 1;
+	}
+
+	// Notify a waiting pop() thread that there is a new item in the queue.
+	m_wait_pop_cv.notify_one();
+}
+
+template <typename T, size_t Lanes>
+inline std::unique_ptr<T> PriorityThreadSafeQueue<T, Lanes>::try_pop() {
+	std::unique_ptr<T> result;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+
+		if (!m_nonEmpty) {
+			return result;
+		}
+
+		result = popLane();
+	}
+
+	// Notify a waiting push() thread that there is enough space for a new item.
+	m_wait_push_cv.notify_one();
+
+	return result;
+}
+
+template <typename T, size_t Lanes>
+inline std::unique_ptr<T> PriorityThreadSafeQueue<T, Lanes>::wait_pop() {
+	std::unique_ptr<T> result;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mtx);
+		m_wait_pop_cv.wait(lock, [this]() { return m_nonEmpty != 0; });
+
+		result = popLane();
+	}
+
+	// Notify a waiting push() thread that there is enough space for a new item.
+	m_wait_push_cv.notify_one();
+
+	return result;
+}
+
+template <typename T, size_t Lanes>
+inline size_t PriorityThreadSafeQueue<T, Lanes>::size() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_size;
+}
+
+template <typename T, size_t Lanes>
+inline size_t PriorityThreadSafeQueue<T, Lanes>::size(size_t priority) const {
+	if (priority >= Lanes) {
+		throw std::out_of_range("Invalid priority");
+	}
+
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_lanes[priority].m_size;
+}
+
+template <typename T, size_t Lanes>
+inline bool PriorityThreadSafeQueue<T, Lanes>::empty() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_nonEmpty == 0;
+}
+
+template <typename T, size_t Lanes>
+inline std::unique_ptr<T> PriorityThreadSafeQueue<T, Lanes>::popLane() {
+	// The mutex is locked and there is at least one non-empty lane.
+	const size_t laneIdx = selectLane();
+	Lane &lane = m_lanes[laneIdx];
+
+	std::unique_ptr<Node> old_head(lane.m_head);
+
+	lane.m_head = old_head->m_next;
+	lane.m_size -= 1;
+
+	if (!lane.m_head) {
+		lane.m_tail = nullptr;
+		m_nonEmpty &= ~(uint64_t(1) << laneIdx);
+	}
+
+	m_size -= 1;
+
+	return std::move(old_head->m_data);
+}
+
+template <typename T, size_t Lanes>
+inline size_t PriorityThreadSafeQueue<T, Lanes>::selectLane() {
+	if (!m_weighted) {
+		return highestLane(m_nonEmpty);
+	}
+
+	uint64_t candidates = m_nonEmpty & m_withCredit;
+
+	// Every non-empty lane has used its share, so a new round begins.
+	if (!candidates) {
+		refillCredits();
+		candidates = m_nonEmpty;
+	}
+
+	const size_t laneIdx = highestLane(candidates);
+	Lane &lane = m_lanes[laneIdx];
+
+	lane.m_credit -= 1;
+	if (lane.m_credit == 0) {
+		m_withCredit &= ~(uint64_t(1) << laneIdx);
+	}
+
+	return laneIdx;
+}
+
+template <typename T, size_t Lanes>
+inline void PriorityThreadSafeQueue<T, Lanes>::refillCredits() {
+	// Happens once per round and the number of lanes is bounded by the bitmap.
+	for (Lane &lane : m_lanes) {
+		lane.m_credit = lane.m_weight;
+	}
+
+	m_withCredit = ~uint64_t(0) >> (64 - Lanes);
+}
+
+template <typename T, size_t Lanes>
+inline size_t PriorityThreadSafeQueue<T, Lanes>::highestLane(uint64_t mask) {
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanReverse64(&idx, mask);
+	return idx;
+#else
+	return 63 - __builtin_clzll(mask);
+#endif
+}
+
+template <typename T, size_t Lanes>
+inline void PriorityThreadSafeQueue<T, Lanes>::freeMemory(Node *node) {
+	while (node) {
+		Node *to_delete = node;
+		node = node->m_next;
+		delete to_delete;
+	}
+}
+
+#endif // !_PRIORITY_THREAD_SAFE_QUEUE_HEADER_
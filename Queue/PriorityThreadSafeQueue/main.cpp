@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <thread>
+
+#include "PriorityThreadSafeQueue.h"
+
+void testStrictPriority() {
+	PriorityThreadSafeQueue<int, 4> queue;
+
+	for (int i = 0; i < 3; ++i) {
+		queue.push(i, 0);
+		queue.push(10 + i, 3);
+		queue.push(20 + i, 1);
+	}
+
+	assert(queue.size() == 9);
+	assert(queue.size(3) == 3);
+
+	// The highest lane first, FIFO within each lane.
+	const int expected[] = { 10, 11, 12, 20, 21, 22, 0, 1, 2 };
+	for (int value : expected) {
+		assert(*queue.wait_pop() == value);
+	}
+
+	assert(queue.empty());
+	assert(queue.try_pop() == nullptr);
+}
+
+void testWeightedLanes() {
+	// The high lane gets 3 pops per round and the low lane gets 1.
+	PriorityThreadSafeQueue<int, 2> queue({ 1, 3 });
+
+	for (int i = 0; i < 8; ++i) {
+		queue.push(i, 0);
+		queue.push(100 + i, 1);
+	}
+
+	// The low lane is not starved while the high lane is backlogged.
+	const int expected[] = { 100, 101, 102, 0, 103, 104, 105, 1, 106, 107, 2, 3, 4, 5, 6, 7 };
+	for (int value : expected) {
+		assert(*queue.try_pop() == value);
+	}
+
+	assert(queue.empty());
+}
+
+void testBlockingQueue(int num_threads, int max_size) {
+	PriorityThreadSafeQueue<int> queue(max_size);
+
+	std::vector<std::thread> threads(num_threads);
+
+	for (int i = 0; i < num_threads / 2; ++i) {
+		threads[i] = std::thread(&PriorityThreadSafeQueue<int>::wait_pop, std::ref(queue));
+	}
+
+	for (int i = num_threads / 2; i < num_threads; ++i) {
+		threads[i] = std::thread(&PriorityThreadSafeQueue<int>::push, std::ref(queue), i, i % 8);
+	}
+
+	for (int i = 0; i < num_threads; ++i) {
+		threads[i].join();
+	}
+
+	assert(queue.empty());
+}
+
+int main() {
+	testStrictPriority();
+	testWeightedLanes();
+
+	testBlockingQueue(10, 1);
+	testBlockingQueue(100, 5);
+	testBlockingQueue(100, 1000);
+
+	return 0;
+}
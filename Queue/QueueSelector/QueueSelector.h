@@ -0,0 +1,121 @@
+#pragma once
+#ifndef _QUEUE_SELECTOR_HEADER_
+#define _QUEUE_SELECTOR_HEADER_
+
+#include <atomic>				// The next queue in round-robin order.
+#include <memory>				// Smart pointers.
+#include <vector>				// The selected queues.
+#include <stdexcept>				// Exceptions.
+#include <initializer_list>			// The constructor.
+
+#include "../ThreadSafeQueue/ThreadSafeQueue.h"
+
+enum class SelectPolicy {
+	Priority,	// The queue with the lowest index wins.
+	RoundRobin	// The search starts after the queue, which was selected last.
+};
+
+// Waits on several ThreadSafeQueues at once. All of them notify a single QueueSignal,
+// so there is no polling and no thread per queue. The queues must outlive the selector.
+template <typename T>
+class QueueSelector {
+public:
+	QueueSelector(std::initializer_list<ThreadSafeQueue<T>*> queues, SelectPolicy policy = SelectPolicy::RoundRobin);
+	QueueSelector(const std::vector<ThreadSafeQueue<T>*> &queues, SelectPolicy policy = SelectPolicy::RoundRobin);
+	QueueSelector(const QueueSelector &r) = delete;
+	QueueSelector& operator=(const QueueSelector &rhs) = delete;
+	~QueueSelector();
+
+public:
+	// index is set to the position of the queue, from which the element was popped.
+	std::unique_ptr<T> try_pop(size_t &index);
+	std::unique_ptr<T> wait_pop(size_t &index);
+
+	size_t size() const;
+
+private:
+	void attachAll();
+
+private:
+	std::vector<ThreadSafeQueue<T>*> m_queues;
+	const SelectPolicy m_policy;
+	std::atomic<size_t> m_next;
+
+	QueueSignal m_signal;
+};
+
+template <typename T>
+inline QueueSelector<T>::QueueSelector(std::initializer_list<ThreadSafeQueue<T>*> queues, SelectPolicy policy)
+	: m_queues(queues)
+	, m_policy(policy)
+	, m_next(0) {
+	attachAll();
+}
+
+template <typename T>
+inline QueueSelector<T>::QueueSelector(const std::vector<ThreadSafeQueue<T>*> &queues, SelectPolicy policy)
+	: m_queues(queues)
+	, m_policy(policy)
+	, m_next(0) {
+	attachAll();
+}
+
+template <typename T>
+inline QueueSelector<T>::~QueueSelector() {
+	for (ThreadSafeQueue<T> *queue : m_queues) {
+		queue->detach(&m_signal);
+	}
+}
+
+template <typename T>
+inline std::unique_ptr<T> QueueSelector<T>::try_pop(size_t &index) {
+	const size_t count = m_queues.size();
+	const size_t first = m_policy == SelectPolicy::RoundRobin ? m_next.load() : 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		const size_t current = (first + i) % count;
+		std::unique_ptr<T> result = m_queues[current]->try_pop();
+
+		if (result) {
+			index = current;
+			m_next = current + 1 < count ? current + 1 : 0;
+
+			return result;
+		}
+	}
+
+	return std::unique_ptr<T>();
+}
+
+template <typename T>
+inline std::unique_ptr<T> QueueSelector<T>::wait_pop(size_t &index) {
+	while (true) {
+		// Read the epoch before checking the queues. A push() after the check changes it.
+		const uint64_t epoch = m_signal.epoch();
+
+		std::unique_ptr<T> result = try_pop(index);
+		if (result) {
+			return result;
+		}
+
+		m_signal.wait(epoch);
+	}
+}
+
+template <typename T>
+inline size_t QueueSelector<T>::size() const {
+	return m_queues.size();
+}
+
+template <typename T>
+inline void QueueSelector<T>::attachAll() {
+	if (m_queues.empty()) {
+		throw std::logic_error("No queues to select from");
+	}
+
+	for (ThreadSafeQueue<T> *queue : m_queues) {
+		queue->attach(&m_signal);
+	}
+}
+
+#endif // !_QUEUE_SELECTOR_HEADER_
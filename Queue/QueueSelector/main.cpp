@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <thread>
+
+#include "QueueSelector.h"
+
+void testPolicies() {
+	ThreadSafeQueue<int> control;
+	ThreadSafeQueue<int> data;
+
+	for (int i = 0; i < 3; ++i) {
+		control.push(i);
+		data.push(10 + i);
+	}
+
+	size_t index = 0;
+
+	{
+		QueueSelector<int> selector({ &control, &data }, SelectPolicy::Priority);
+
+		// The control queue is drained first.
+		assert(*selector.wait_pop(index) == 0 && index == 0);
+		assert(*selector.wait_pop(index) == 1 && index == 0);
+	}
+
+	{
+		QueueSelector<int> selector({ &control, &data }, SelectPolicy::RoundRobin);
+
+		assert(*selector.wait_pop(index) == 2 && index == 0);
+		assert(*selector.wait_pop(index) == 10 && index == 1);
+		assert(*selector.wait_pop(index) == 11 && index == 1);
+		assert(*selector.try_pop(index) == 12 && index == 1);
+		assert(selector.try_pop(index) == nullptr);
+	}
+}
+
+void testBlockingSelect(int num_queues, int num_items) {
+	std::vector<ThreadSafeQueue<int>*> queues;
+	for (int i = 0; i < num_queues; ++i) {
+		queues.push_back(new ThreadSafeQueue<int>);
+	}
+
+	std::vector<int> received(num_queues, 0);
+
+	{
+		QueueSelector<int> selector(queues);
+
+		// A single dispatcher thread for all of the queues.
+		std::thread dispatcher([&selector, &received, num_queues, num_items]() {
+			for (int i = 0; i < num_queues * num_items; ++i) {
+				size_t index = 0;
+				std::unique_ptr<int> value = selector.wait_pop(index);
+
+				assert(*value == int(index));
+				++received[index];
+			}
+		});
+
+		std::vector<std::thread> producers;
+		for (int q = 0; q < num_queues; ++q) {
+			producers.emplace_back([&queues, q, num_items]() {
+				for (int i = 0; i < num_items; ++i) {
+					queues[q]->push(q);
+				}
+			});
+		}
+
+		for (std::thread &t : producers) {
+			t.join();
+		}
+
+		dispatcher.join();
+	}
+
+	for (int q = 0; q < num_queues; ++q) {
+		assert(received[q] == num_items);
+		assert(queues[q]->empty());
+		delete queues[q];
+	}
+}
+
+int main() {
+	testPolicies();
+
+	testBlockingSelect(3, 10000);
+	testBlockingSelect(8, 1000);
+
+	return 0;
+}
@@ -6,20 +6,66 @@
 #include <memory>				// Smart pointers.
 #include <limits>				// The maximum value of the capacity.
 #include <atomic>				// Number of elements in the queue.
+#include <vector>				// The attached signals.
+#include <cstdint>				// The epoch of the signal.
+#include <algorithm>				// std::find().
 #include <stdexcept>				// Exceptions.
+#include <functional>				// The weigher of the elements.
 #include <condition_variable>			// Wait for pop() and push().
 
+#if defined(__linux__)
+#include <cerrno>				// EINTR.
+#include <system_error>				// The eventfd creation failure.
+#include <unistd.h>				// read(), write(), close().
+#include <sys/eventfd.h>			// The notifier for epoll loops.
+#endif
+
+// Define QUEUE_LATENCY_HISTOGRAM to measure the time every element spends in the queue.
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+#include "../LatencyHistogram/LatencyHistogram.h"
+#endif
+
+// Wakes up the threads, which wait on several queues at once(see QueueSelector).
+// Every notify() starts a new epoch. A waiter reads the epoch, checks the queues
+// and then waits for the epoch to change, so it cannot miss a push().
+class QueueSignal {
+public:
+	QueueSignal();
+	QueueSignal(const QueueSignal &r) = delete;
+	QueueSignal& operator=(const QueueSignal &rhs) = delete;
+
+public:
+	void notify();
+
+	uint64_t epoch() const;
+	void wait(uint64_t epoch);
+
+private:
+	uint64_t m_epoch;
+	mutable std::mutex m_mtx;
+	std::condition_variable m_cv;
+};
+
 template <typename T>
 class ThreadSafeQueue {
 	struct Node {
 		std::unique_ptr<T> m_data;
 		Node *m_next;
+		size_t m_weight;
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+		uint64_t m_enqueueTime;
+#endif
 
 		Node(std::unique_ptr<T> &&data = std::unique_ptr<T>(), Node *next = nullptr);
 	};
 
 public:
-	ThreadSafeQueue(size_t maxQueueCapacity = std::numeric_limits<size_t>::max());
+	// Returns the number of bytes an element accounts for in the byte budget.
+	using Weigher = std::function<size_t(const T&)>;
+
+	ThreadSafeQueue(size_t maxQueueCapacity = std::numeric_limits<size_t>::max(),
+			size_t maxQueueBytes = std::numeric_limits<size_t>::max(),
+			Weigher weigher = Weigher());
 	ThreadSafeQueue(const ThreadSafeQueue &r) = delete;
 	ThreadSafeQueue& operator=(const ThreadSafeQueue &rhs) = delete;
 	ThreadSafeQueue(ThreadSafeQueue &&r) = delete;
@@ -28,57 +74,151 @@ public:
 
 public:
 	void push(const T &value);
+	void push(T &&value);
 	std::unique_ptr<T> try_pop();
 	std::unique_ptr<T> wait_pop();
 
 	size_t size() const;
+	size_t size_bytes() const;
 	bool empty() const;
 
+#if defined(__linux__)
+	// Creates an eventfd, which becomes readable when an element is pushed. Consecutive
+	// pushes are coalesced into a single write until consume_event() is called.
+	// An event loop registers event_fd() and, when it is readable, calls consume_event()
+	// and then try_pop() until the queue is empty.
+	int enable_event_fd();
+	int event_fd() const;
+	void consume_event();
+#endif
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	// The time from push() to pop() of the popped elements.
+	LatencySnapshot latency_snapshot() const;
+#endif
+
+	// Every push() notifies the attached signals. A signal must be detached
+	// before the queue or the signal is destroyed.
+	void attach(QueueSignal *signal);
+	void detach(QueueSignal *signal);
+
 private:
+	void pushData(std::unique_ptr<T> &&new_data);
+
 	Node* popHead();
 	Node* tryPopHead();
 	Node *waitPopHead();
 
 	std::unique_lock<std::mutex> waitData();
 	std::unique_ptr<T> popResult(Node *old_head);
+	void notifyEvent();
+	void notifySignals();
 	
 	const Node* getTail() const;
+	size_t weigh(const T &value) const;
+	bool hasSpaceFor(size_t weight) const;
 	static void freeMemory(Node *node);
 
 private:
 	Node *m_head;
 	Node *m_tail;
 	std::atomic<size_t> m_size;
+	std::atomic<size_t> m_sizeBytes;
 
 	const size_t m_maxCapacity;
+	const size_t m_maxBytes;
+	const Weigher m_weigher;
+
+	// Tickets of the push() threads, served in FIFO order.
+	std::atomic<size_t> m_pushTicket;
+	std::atomic<size_t> m_pushServing;
 
 	mutable std::mutex m_headMtx;
 	mutable std::mutex m_tailMtx;
 
 	std::condition_variable m_wait_pop_cv;
 	std::condition_variable m_wait_push_cv;
+
+	std::vector<QueueSignal*> m_signals;
+	std::atomic<size_t> m_signalsCount;
+	std::mutex m_signalsMtx;
+
+#if defined(__linux__)
+	std::atomic<int> m_eventFd;
+	std::atomic<bool> m_eventArmed;		// The eventfd was written and not consumed yet.
+#endif
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	LatencyHistogram m_latency;
+#endif
 };
 
+inline QueueSignal::QueueSignal()
+	: m_epoch(0) {
+
+}
+
+inline void QueueSignal::notify() {
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_epoch += 1;
+	}
+
+	m_cv.notify_all();
+}
+
+inline uint64_t QueueSignal::epoch() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_epoch;
+}
+
+inline void QueueSignal::wait(uint64_t epoch) {
+	std::unique_lock<std::mutex> lock(m_mtx);
+	m_cv.wait(lock, [this, epoch]() { return m_epoch != epoch; });
+}
+
 template <typename T>
 inline ThreadSafeQueue<T>::Node::Node(std::unique_ptr<T> &&data, Node *next)
 	: m_data(std::move(data))
-	, m_next(next) {
+	, m_next(next)
+	, m_weight(0)
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	, m_enqueueTime(0)
+#endif
+	{
 
 }
 
 template <typename T>
-inline ThreadSafeQueue<T>::ThreadSafeQueue(size_t maxQueueCapacity)
+inline ThreadSafeQueue<T>::ThreadSafeQueue(size_t maxQueueCapacity, size_t maxQueueBytes, Weigher weigher)
 	: m_head(new Node)
 	, m_tail(m_head)
 	, m_size(0)
-	, m_maxCapacity(maxQueueCapacity) {
+	, m_sizeBytes(0)
+	, m_maxCapacity(maxQueueCapacity)
+	, m_maxBytes(maxQueueBytes)
+	, m_weigher(std::move(weigher))
+	, m_pushTicket(0)
+	, m_pushServing(0)
+	, m_signalsCount(0)
+#if defined(__linux__)
+	, m_eventFd(-1)
+	, m_eventArmed(false)
+#endif
+	{
 	// We use a dummy node in order to access only m_head(in pop())
 	// or m_tail(in push()) and never both of them. Without the dummy node
 	// there would be a case in which m_head == m_tail.
 
 	if (maxQueueCapacity == 0) {
+		delete m_head;
 		throw std::logic_error("Invalid maxCapacity");
 	}
+
+	if (maxQueueBytes == 0) {
+		delete m_head;
+		throw std::logic_error("Invalid maxBytes");
+	}
 }
 
 template <typename T>
@@ -90,25 +230,59 @@ inline ThreadSafeQueue<T>::~ThreadSafeQueue() {
 	m_head = nullptr;
 	m_tail = nullptr;
 	m_size.store(0);
+	m_sizeBytes.store(0);
+
+#if defined(__linux__)
+	if (m_eventFd >= 0) {
+		close(m_eventFd);
+		m_eventFd = -1;
+	}
+#endif
 }
 
 template <typename T>
 inline void ThreadSafeQueue<T>::push(const T &value) {
+	// Prepare the data for the new node(the current dummy node).
+	pushData(std::unique_ptr<T>(new T(value)));
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::push(T &&value) {
+	pushData(std::unique_ptr<T>(new T(std::move(value))));
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::pushData(std::unique_ptr<T> &&new_data) {
 	// Create a new dummy node.
 	std::unique_ptr<Node> new_node(new Node);
 
-	// Prepare the data for the new node(the current dummy node).
-	std::unique_ptr<T> new_data(new T(value));
+	const size_t weight = weigh(*new_data);
+
+	bool pendingPushes = false;
 
 	{
 		// Lock the mutex for the tail and update the tail.
 		std::unique_lock<std::mutex> tailLock(m_tailMtx);
 
-		// Wait until there is enough space in the queue.
-		m_wait_push_cv.wait(tailLock, [this]() { return m_size < m_maxCapacity; });
+		// The waiting push() threads are admitted in the order of their tickets.
+		// Otherwise a heavy element could wait forever, while lighter elements
+		// keep taking the space that is freed by pop().
+		const size_t ticket = m_pushTicket++;
+
+		// Wait until it is our turn and there is enough space in the queue.
+		m_wait_push_cv.wait(tailLock, [this, ticket, weight]() {
+			return ticket == m_pushServing && hasSpaceFor(weight);
+		});
+
+		m_pushServing += 1;
+		pendingPushes = m_pushServing != m_pushTicket;
 
 		// Update the data of the current dummy node.
 		m_tail->m_data = std::move(new_data);
+		m_tail->m_weight = weight;
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+		m_tail->m_enqueueTime = LatencyClock::now();
+#endif
 
 		// Set the next pointer to the new dummy node.
 		m_tail->m_next = new_node.release();
@@ -116,12 +290,22 @@ inline void ThreadSafeQueue<T>::push(const T &value) {
 		// Update the tail.
 		m_tail = m_tail->m_next;
 
-		// Update the number of elements in the queue.
+		// Update the number of elements and the weight of the queue.
 		m_size += 1;
+		m_sizeBytes += weight;
+	}
+
+	// The next ticket might fit in the queue as well.
+	if (pendingPushes) {
+		m_wait_push_cv.notify_all();
 	}
 
 	// Notify a waiting pop() thread that there is a new item in the queue.
 	m_wait_pop_cv.notify_one();
+
+	// Notify the event loop and the selectors, if there are any.
+	notifyEvent();
+	notifySignals();
 }
 
 template <typename T>
@@ -148,12 +332,67 @@ inline size_t ThreadSafeQueue<T>::size() const {
 	return m_size.load();
 }
 
+template <typename T>
+inline size_t ThreadSafeQueue<T>::size_bytes() const {
+	return m_sizeBytes.load();
+}
+
 template <typename T>
 inline bool ThreadSafeQueue<T>::empty() const {
 	std::lock_guard<std::mutex> headLock(m_headMtx);
 	return m_head == getTail();
 }
 
+#if defined(__linux__)
+template <typename T>
+inline int ThreadSafeQueue<T>::enable_event_fd() {
+	const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (fd < 0) {
+		throw std::system_error(errno, std::system_category(), "eventfd");
+	}
+
+	int expected = -1;
+
+	// Another thread has already enabled it.
+	if (!m_eventFd.compare_exchange_strong(expected, fd)) {
+		close(fd);
+		return expected;
+	}
+
+	// The elements pushed before the eventfd existed must be noticed as well.
+	if (!empty()) {
+		notifyEvent();
+	}
+
+	return fd;
+}
+
+template <typename T>
+inline int ThreadSafeQueue<T>::event_fd() const {
+	return m_eventFd.load();
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::consume_event() {
+	const int fd = m_eventFd.load();
+
+	if (fd < 0) {
+		return;
+	}
+
+	// Reset the counter of the eventfd. It fails with EAGAIN if it is already zero.
+	uint64_t counter;
+	while (read(fd, &counter, sizeof(counter)) < 0 && errno == EINTR) {
+		//retry...
+	}
+
+	// Disarm only after the read. A push() that finds the flag set has already
+	// enqueued its element, so the following try_pop() calls will see it.
+	m_eventArmed.store(false);
+}
+#endif
+
 template <typename T>
 inline typename ThreadSafeQueue<T>::Node* ThreadSafeQueue<T>::popHead() {
 	// Get a pointer to the current head.
@@ -200,25 +439,114 @@ template <typename T>
 inline std::unique_ptr<T> ThreadSafeQueue<T>::popResult(Node *old_head) {
 	// Steal the data from the old head.
 	std::unique_ptr<T> result(std::move(old_head->m_data));
+	const size_t weight = old_head->m_weight;
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	m_latency.recordSince(old_head->m_enqueueTime);
+#endif
 
 	// Free the old head.
 	delete old_head;
 
-	// Decrease the size of the queue.
+	// Decrease the size and the weight of the queue.
 	m_size -= 1;
-
-	// Notify a waiting push() thread that there might be enough space for a new item.
-	m_wait_push_cv.notify_one();
+	m_sizeBytes -= weight;
+
+	// Notify the waiting push() threads that there might be enough space for a new item.
+	// Only the thread with the next ticket can proceed, so we wake all of them.
+	if (m_pushTicket != m_pushServing) {
+		// A push() thread might have checked the space, but not started waiting yet.
+		// It holds the tail mutex until it waits, so we cannot miss it.
+		{
+			std::lock_guard<std::mutex> tailLock(m_tailMtx);
+		}
+
+		m_wait_push_cv.notify_all();
+	}
 
 	return result;
 }
 
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+template <typename T>
+inline LatencySnapshot ThreadSafeQueue<T>::latency_snapshot() const {
+	return m_latency.snapshot();
+}
+#endif
+
+template <typename T>
+inline void ThreadSafeQueue<T>::attach(QueueSignal *signal) {
+	std::lock_guard<std::mutex> lock(m_signalsMtx);
+
+	m_signals.push_back(signal);
+	m_signalsCount += 1;
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::detach(QueueSignal *signal) {
+	std::lock_guard<std::mutex> lock(m_signalsMtx);
+
+	typename std::vector<QueueSignal*>::iterator it = std::find(m_signals.begin(), m_signals.end(), signal);
+	if (it != m_signals.end()) {
+		m_signals.erase(it);
+		m_signalsCount -= 1;
+	}
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::notifySignals() {
+	// Most queues have no selectors, so they do not lock the mutex.
+	if (m_signalsCount == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_signalsMtx);
+
+	for (QueueSignal *signal : m_signals) {
+		signal->notify();
+	}
+}
+
+template <typename T>
+inline void ThreadSafeQueue<T>::notifyEvent() {
+#if defined(__linux__)
+	const int fd = m_eventFd.load();
+
+	// Write only once until the event loop consumes the event.
+	if (fd < 0 || m_eventArmed.load() || m_eventArmed.exchange(true)) {
+		return;
+	}
+
+	const uint64_t one = 1;
+	while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+		//retry...
+	}
+#endif
+}
+
 template <typename T>
 inline const typename ThreadSafeQueue<T>::Node* ThreadSafeQueue<T>::getTail() const {
 	std::lock_guard<std::mutex> lck(m_tailMtx);
 	return m_tail;
 }
 
+template <typename T>
+inline size_t ThreadSafeQueue<T>::weigh(const T &value) const {
+	return m_weigher ? m_weigher(value) : sizeof(T);
+}
+
+template <typename T>
+inline bool ThreadSafeQueue<T>::hasSpaceFor(size_t weight) const {
+	if (m_size >= m_maxCapacity) {
+		return false;
+	}
+
+	// An element heavier than the whole budget is admitted into an empty queue.
+	// Otherwise it would never fit.
+	const size_t bytes = m_sizeBytes;
+	return bytes == 0 || (bytes <= m_maxBytes && weight <= m_maxBytes - bytes);
+}
+
 template <typename T>
 inline void ThreadSafeQueue<T>::freeMemory(Node *node) {
 	while (node) {
@@ -2,10 +2,18 @@
 #include <cassert>
 #include <vector>
 #include <thread>
+#include <string>
+#include <chrono>
 
 #include "ThreadSafeQueue.h"
 
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
 void testQueue(int num_threads, int max_size) {
+	void (ThreadSafeQueue<int>::*push)(const int&) = &ThreadSafeQueue<int>::push;
+
 	ThreadSafeQueue<int> queue(max_size);
 
 	std::vector<std::thread> threads(num_threads);
@@ -14,7 +22,7 @@ void testQueue(int num_threads, int max_size) {
 	int i = 0;
 
 	for (; i < push_threads; ++i) {
-		threads[i] = std::thread(&ThreadSafeQueue<int>::push, std::ref(queue), i);
+		threads[i] = std::thread(push, std::ref(queue), i);
 	}
 
 	for (; i < num_threads; ++i) {
@@ -45,7 +53,7 @@ void testQueue(int num_threads, int max_size) {
 	}
 
 	for (int i = num_threads / 2; i < num_threads; ++i) {
-		threads[i] = std::thread(&ThreadSafeQueue<int>::push, std::ref(queue2), i);
+		threads[i] = std::thread(push, std::ref(queue2), i);
 	}
 
 	for (int i = 0; i < num_threads; ++i) {
@@ -55,6 +63,130 @@ void testQueue(int num_threads, int max_size) {
 	assert(queue2.empty());
 }
 
+void testWeightedQueue() {
+	using StringQueue = ThreadSafeQueue<std::string>;
+	void (StringQueue::*push)(const std::string&) = &StringQueue::push;
+
+	StringQueue queue(std::numeric_limits<size_t>::max(), 100, [](const std::string &s) { return s.size(); });
+
+	queue.push(std::string(60, 'a'));
+	queue.push(std::string(40, 'b'));
+
+	assert(queue.size() == 2);
+	assert(queue.size_bytes() == 100);
+
+	// The heavy element blocks first, then the light one blocks behind it.
+	std::thread heavy(push, std::ref(queue), std::string(90, 'c'));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	std::thread light(push, std::ref(queue), std::string(1, 'd'));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	// There is space for the light element now, but it must not overtake the heavy one.
+	assert(*queue.wait_pop() == std::string(60, 'a'));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	assert(queue.size() == 1);
+
+	assert(*queue.wait_pop() == std::string(40, 'b'));
+
+	heavy.join();
+	light.join();
+
+	assert(*queue.wait_pop() == std::string(90, 'c'));
+	assert(*queue.wait_pop() == std::string(1, 'd'));
+	assert(queue.size_bytes() == 0);
+
+	// An element heavier than the whole budget fits into an empty queue.
+	queue.push(std::string(1000, 'e'));
+	assert(queue.size_bytes() == 1000);
+	assert(queue.try_pop()->size() == 1000);
+	assert(queue.empty());
+}
+
+#if defined(__linux__)
+void testEventFd() {
+	ThreadSafeQueue<int> queue;
+	queue.push(-1);
+
+	// The element pushed before enabling makes the eventfd readable.
+	const int fd = queue.enable_event_fd();
+	assert(fd >= 0 && fd == queue.event_fd());
+
+	pollfd pfd = { fd, POLLIN, 0 };
+	assert(poll(&pfd, 1, 1000) == 1);
+
+	queue.consume_event();
+	assert(*queue.try_pop() == -1);
+	assert(poll(&pfd, 1, 0) == 0);
+
+	// A burst of pushes is coalesced into a single write.
+	std::thread producer([&queue]() {
+		for (int i = 0; i < 100; ++i) {
+			queue.push(i);
+		}
+	});
+
+	producer.join();
+
+	uint64_t counter = 0;
+	assert(read(fd, &counter, sizeof(counter)) == sizeof(counter));
+	assert(counter == 1);
+
+	// Drain the queue like an event loop does.
+	int expected = 0;
+
+	std::thread consumer([&queue, &expected, fd]() {
+		pollfd pfd = { fd, POLLIN, 0 };
+
+		queue.consume_event();
+		while (expected < 1100) {
+			std::unique_ptr<int> value = queue.try_pop();
+
+			if (value) {
+				assert(*value == expected);
+				++expected;
+				continue;
+			}
+
+			// Nothing is lost between the drain and the poll.
+			assert(poll(&pfd, 1, 5000) == 1);
+			queue.consume_event();
+		}
+	});
+
+	for (int i = 100; i < 1100; ++i) {
+		queue.push(i);
+	}
+
+	consumer.join();
+	assert(queue.empty());
+}
+#endif
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+void testLatency() {
+	ThreadSafeQueue<int> queue;
+
+	for (int i = 0; i < 100; ++i) {
+		queue.push(i);
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	while (queue.try_pop()) {
+
+	}
+
+	// Every element has spent at least 10ms in the queue.
+	const LatencySnapshot snapshot = queue.latency_snapshot();
+	assert(snapshot.count == 100);
+	assert(snapshot.p50 >= 1e7 * 0.9);
+	assert(snapshot.p50 <= snapshot.p99 && snapshot.p99 <= snapshot.p999 && snapshot.p999 <= snapshot.max);
+
+	std::cout << "p50: " << snapshot.p50 << " ns, p99: " << snapshot.p99 << " ns, max: " << snapshot.max << " ns\n";
+}
+#endif
+
 int main() {
 	testQueue(10, 5);
 	testQueue(10, 10);
@@ -64,5 +196,15 @@ int main() {
 	testQueue(100, 100);
 	testQueue(100, 1000);
 
+	testWeightedQueue();
+
+#if defined(__linux__)
+	testEventFd();
+#endif
+
+#if defined(QUEUE_LATENCY_HISTOGRAM)
+	testLatency();
+#endif
+
 	return 0;
 }
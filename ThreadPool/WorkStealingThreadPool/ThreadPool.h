@@ -0,0 +1,401 @@
+#pragma once
+#ifndef _WORK_STEALING_THREAD_POOL_HEADER_
+#define _WORK_STEALING_THREAD_POOL_HEADER_
+
+#include <deque>				// The local queues of the workers.
+#include <mutex>				// Mutex locks for the local queues.
+#include <atomic>				// Flags and counters shared by the workers.
+#include <chrono>				// Poll the futures in parallel_for().
+#include <future>				// The results of the tasks.
+#include <memory>				// Smart pointers.
+#include <thread>				// The worker threads.
+#include <vector>				// The workers and their queues.
+#include <utility>				// std::move(), std::declval().
+#include <algorithm>				// std::min().
+#include <exception>				// Rethrow the exceptions of parallel_for().
+#include <condition_variable>			// Idle workers sleep until there is work.
+
+#include "../../Queue/ThreadSafeQueue/ThreadSafeQueue.h"
+
+// A move-only wrapper of a callable. Unlike std::function, it can hold a std::packaged_task.
+class FunctionWrapper {
+	struct ImplBase {
+		virtual void call() = 0;
+		virtual ~ImplBase() = default;
+	};
+
+	template <typename F>
+	struct Impl : ImplBase {
+		F m_f;
+
+		Impl(F &&f);
+		void call() override;
+	};
+
+public:
+	FunctionWrapper() = default;
+	FunctionWrapper(const FunctionWrapper &r) = delete;
+	FunctionWrapper& operator=(const FunctionWrapper &rhs) = delete;
+	FunctionWrapper(FunctionWrapper &&r) = default;
+	FunctionWrapper& operator=(FunctionWrapper &&rhs) = default;
+
+	template <typename F>
+	FunctionWrapper(F f);
+
+public:
+	void operator()();
+	explicit operator bool() const;
+
+private:
+	std::unique_ptr<ImplBase> m_impl;
+};
+
+// The local queue of a worker. The owner pushes and pops at the front(LIFO), so it works
+// on the tasks that are still hot in its cache. The other workers steal from the back,
+// which holds the oldest and usually the largest tasks.
+class WorkStealingQueue {
+public:
+	WorkStealingQueue() = default;
+	WorkStealingQueue(const WorkStealingQueue &r) = delete;
+	WorkStealingQueue& operator=(const WorkStealingQueue &rhs) = delete;
+
+public:
+	void push(FunctionWrapper &&task);
+	bool try_pop(FunctionWrapper &task);
+	bool try_steal(FunctionWrapper &task);
+
+	bool empty() const;
+
+private:
+	std::deque<FunctionWrapper> m_queue;
+	mutable std::mutex m_mtx;
+};
+
+class ThreadPool {
+public:
+	ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+	ThreadPool(const ThreadPool &r) = delete;
+	ThreadPool& operator=(const ThreadPool &rhs) = delete;
+	~ThreadPool();
+
+public:
+	// Tasks submitted from a worker go to its local queue, the rest go to the global queue.
+	template <typename F>
+	std::future<decltype(std::declval<F&>()())> submit(F f);
+
+	// Calls f(i) for every i in [begin, end) and waits for all of them.
+	// The range is split into chunks of grainSize indices(0 picks a size from the number of workers).
+	template <typename F>
+	void parallel_for(size_t begin, size_t end, F f, size_t grainSize = 0);
+
+	// Runs a single task, if there is one. Threads waiting on a future
+	// should call it instead of blocking, so nested tasks cannot deadlock the pool.
+	bool run_pending_task();
+
+	size_t size() const;
+
+private:
+	void workerThread(size_t index);
+	void pushTask(FunctionWrapper &&task);
+	bool popTask(FunctionWrapper &task);
+	void waitForTask();
+
+	static ThreadPool*& localPool();
+	static size_t& localIndex();
+
+private:
+	std::atomic<bool> m_done;
+
+	ThreadSafeQueue<FunctionWrapper> m_globalQueue;
+	std::vector<std::unique_ptr<WorkStealingQueue>> m_localQueues;
+	std::vector<std::thread> m_threads;
+
+	std::atomic<size_t> m_pendingTasks;	// Submitted, but not yet taken by a worker.
+	std::atomic<size_t> m_sleepingWorkers;
+	std::mutex m_sleepMtx;
+	std::condition_variable m_sleep_cv;
+};
+
+/* --- FUNCTION WRAPPER --- */
+template <typename F>
+inline FunctionWrapper::Impl<F>::Impl(F &&f)
+	: m_f(std::move(f)) {
+
+}
+
+template <typename F>
+inline void FunctionWrapper::Impl<F>::call() {
+	m_f();
+}
+
+template <typename F>
+inline FunctionWrapper::FunctionWrapper(F f)
+	: m_impl(new Impl<F>(std::move(f))) {
+
+}
+
+inline void FunctionWrapper::operator()() {
+	m_impl->call();
+}
+
+inline FunctionWrapper::operator bool() const {
+	return m_impl != nullptr;
+}
+
+/* --- WORK STEALING QUEUE --- */
+inline void WorkStealingQueue::push(FunctionWrapper &&task) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_queue.push_front(std::move(task));
+}
+
+inline bool WorkStealingQueue::try_pop(FunctionWrapper &task) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	if (m_queue.empty()) {
+		return false;
+	}
+
+	task = std::move(m_queue.front());
+	m_queue.pop_front();
+
+	return true;
+}
+
+inline bool WorkStealingQueue::try_steal(FunctionWrapper &task) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	if (m_queue.empty()) {
+		return false;
+	}
+
+	task = std::move(m_queue.back());
+	m_queue.pop_back();
+
+	return true;
+}
+
+inline bool WorkStealingQueue::empty() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_queue.empty();
+}
+
+/* --- THREAD POOL --- */
+inline ThreadPool::ThreadPool(size_t numThreads)
+	: m_done(false)
+	, m_pendingTasks(0)
+	, m_sleepingWorkers(0) {
+
+	// hardware_concurrency() may return 0.
+	if (numThreads == 0) {
+		numThreads = 1;
+	}
+
+	// Every queue must exist before any worker starts stealing.
+	for (size_t i = 0; i < numThreads; ++i) {
+		m_localQueues.emplace_back(new WorkStealingQueue);
+	}
+
+	try {
+		for (size_t i = 0; i < numThreads; ++i) {
+			m_threads.emplace_back(&ThreadPool::workerThread, this, i);
+		}
+	}
+	catch (...) {
+		m_done = true;
+		m_sleep_cv.notify_all();
+
+		for (std::thread &t : m_threads) {
+			t.join();
+		}
+
+		throw;
+	}
+}
+
+inline ThreadPool::~ThreadPool() {
+	{
+		// A worker might have checked m_done, but not started sleeping yet.
+		std::lock_guard<std::mutex> lock(m_sleepMtx);
+		m_done = true;
+	}
+
+	m_sleep_cv.notify_all();
+
+	for (std::thread &t : m_threads) {
+		t.join();
+	}
+}
+
+template <typename F>
+inline std::future<decltype(std::declval<F&>()())> ThreadPool::submit(F f) {
+	using ResultType = decltype(std::declval<F&>()());
+
+	std::packaged_task<ResultType()> task(std::move(f));
+	std::future<ResultType> result(task.get_future());
+
+	pushTask(FunctionWrapper(std::move(task)));
+
+	return result;
+}
+
+template <typename F>
+inline void ThreadPool::parallel_for(size_t begin, size_t end, F f, size_t grainSize) {
+	if (begin >= end) {
+		return;
+	}
+
+	const size_t length = end - begin;
+
+	// A few chunks per worker leave room for balancing the load by stealing.
+	if (grainSize == 0) {
+		const size_t chunks = size() * 4;
+		grainSize = (length + chunks - 1) / chunks;
+	}
+
+	std::vector<std::future<void>> results;
+	results.reserve((length + grainSize - 1) / grainSize);
+
+	for (size_t first = begin; first < end; first += std::min(grainSize, end - first)) {
+		const size_t last = first + std::min(grainSize, end - first);
+
+		results.push_back(submit([&f, first, last]() {
+			for (size_t i = first; i < last; ++i) {
+				f(i);
+			}
+		}));
+	}
+
+	std::exception_ptr error;
+
+	// Help with the work instead of blocking. Every chunk must finish before we return,
+	// because they all reference f.
+	for (std::future<void> &result : results) {
+		while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!run_pending_task()) {
+				std::this_thread::yield();
+			}
+		}
+
+		try {
+			result.get();
+		}
+		catch (...) {
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+inline bool ThreadPool::run_pending_task() {
+	FunctionWrapper task;
+
+	if (!popTask(task)) {
+		return false;
+	}
+
+	task();
+	return true;
+}
+
+inline size_t ThreadPool::size() const {
+	return m_threads.size();
+}
+
+inline void ThreadPool::workerThread(size_t index) {
+	localPool() = this;
+	localIndex() = index;
+
+	while (!m_done) {
+		if (!run_pending_task()) {
+			waitForTask();
+		}
+	}
+
+	localPool() = nullptr;
+}
+
+inline void ThreadPool::pushTask(FunctionWrapper &&task) {
+	// Count the task first, so the counter never drops below zero.
+	m_pendingTasks += 1;
+
+	if (localPool() == this) {
+		m_localQueues[localIndex()]->push(std::move(task));
+	}
+	else {
+		m_globalQueue.push(std::move(task));
+	}
+
+	// Wake up a sleeping worker. It holds the mutex until it starts waiting, so we cannot miss it.
+	if (m_sleepingWorkers > 0) {
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMtx);
+		}
+
+		m_sleep_cv.notify_one();
+	}
+}
+
+inline bool ThreadPool::popTask(FunctionWrapper &task) {
+	const bool isWorker = localPool() == this;
+	const size_t index = isWorker ? localIndex() : 0;
+
+	bool found = isWorker && m_localQueues[index]->try_pop(task);
+
+	if (!found) {
+		std::unique_ptr<FunctionWrapper> global = m_globalQueue.try_pop();
+
+		if (global) {
+			task = std::move(*global);
+			found = true;
+		}
+	}
+
+	// Steal from the other workers, starting from the next one, so the thieves spread out.
+	for (size_t i = 1; !found && i <= m_localQueues.size(); ++i) {
+		const size_t victim = (index + i) % m_localQueues.size();
+
+		if (victim != index || !isWorker) {
+			found = m_localQueues[victim]->try_steal(task);
+		}
+	}
+
+	if (found) {
+		m_pendingTasks -= 1;
+	}
+
+	return found;
+}
+
+inline void ThreadPool::waitForTask() {
+	// Spin for a while, because new tasks usually come in bursts.
+	for (int i = 0; i < 64; ++i) {
+		if (m_pendingTasks > 0 || m_done) {
+			return;
+		}
+
+		std::this_thread::yield();
+	}
+
+	std::unique_lock<std::mutex> lock(m_sleepMtx);
+
+	m_sleepingWorkers += 1;
+	m_sleep_cv.wait(lock, [this]() { return m_pendingTasks > 0 || m_done; });
+	m_sleepingWorkers -= 1;
+}
+
+inline ThreadPool*& ThreadPool::localPool() {
+	static thread_local ThreadPool *pool = nullptr;
+	return pool;
+}
+
+inline size_t& ThreadPool::localIndex() {
+	static thread_local size_t index = 0;
+	return index;
+}
+
+#endif // !_WORK_STEALING_THREAD_POOL_HEADER_
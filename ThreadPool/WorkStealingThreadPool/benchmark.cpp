@@ -0,0 +1,124 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <atomic>
+
+#include "ThreadPool.h"
+
+// A pool with a single global ThreadSafeQueue. The workers block in wait_pop().
+class SingleQueueThreadPool {
+public:
+	SingleQueueThreadPool(size_t numThreads)
+		: m_done(false) {
+		for (size_t i = 0; i < numThreads; ++i) {
+			m_threads.emplace_back([this]() {
+				while (!m_done) {
+					std::unique_ptr<FunctionWrapper> task = m_queue.wait_pop();
+					(*task)();
+				}
+			});
+		}
+	}
+
+	~SingleQueueThreadPool() {
+		// One empty task per worker, which sets the flag.
+		for (size_t i = 0; i < m_threads.size(); ++i) {
+			m_queue.push(FunctionWrapper([this]() { m_done = true; }));
+		}
+
+		for (std::thread &t : m_threads) {
+			t.join();
+		}
+	}
+
+	template <typename F>
+	std::future<decltype(std::declval<F&>()())> submit(F f) {
+		using ResultType = decltype(std::declval<F&>()());
+
+		std::packaged_task<ResultType()> task(std::move(f));
+		std::future<ResultType> result(task.get_future());
+
+		m_queue.push(FunctionWrapper(std::move(task)));
+		return result;
+	}
+
+private:
+	std::atomic<bool> m_done;
+	ThreadSafeQueue<FunctionWrapper> m_queue;
+	std::vector<std::thread> m_threads;
+};
+
+// Many tiny independent tasks, submitted from outside of the pool.
+template <typename Pool>
+void flatTasks(Pool &pool, int tasks) {
+	std::vector<std::future<int>> results;
+	results.reserve(tasks);
+
+	for (int i = 0; i < tasks; ++i) {
+		results.push_back(pool.submit([i]() { return i & 7; }));
+	}
+
+	for (std::future<int> &result : results) {
+		result.get();
+	}
+}
+
+// A tree of tasks, most of them are submitted from the workers. The leaves count themselves.
+template <typename Pool>
+void spawnTree(Pool &pool, int depth, std::atomic<int> &leaves) {
+	if (depth == 0) {
+		volatile int work = 0;
+		for (int i = 0; i < 256; ++i) {
+			work = work + i;
+		}
+
+		leaves += 1;
+		return;
+	}
+
+	pool.submit([&pool, depth, &leaves]() { spawnTree(pool, depth - 1, leaves); });
+	pool.submit([&pool, depth, &leaves]() { spawnTree(pool, depth - 1, leaves); });
+}
+
+template <typename Pool>
+void treeTasks(Pool &pool, int depth) {
+	std::atomic<int> leaves(0);
+	spawnTree(pool, depth, leaves);
+
+	while (leaves != (1 << depth)) {
+		std::this_thread::yield();
+	}
+}
+
+template <typename F>
+double measure(F f) {
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+	const size_t num_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4;
+	const int flat = 200000;
+	const int depth = 18;
+
+	std::cout << "threads: " << num_threads << '\n';
+
+	{
+		SingleQueueThreadPool pool(num_threads);
+		std::cout << "single queue,  flat tasks:      " << measure([&]() { flatTasks(pool, flat); }) << " ms\n";
+		std::cout << "single queue,  tree of tasks:   " << measure([&]() { treeTasks(pool, depth); }) << " ms\n";
+	}
+
+	{
+		ThreadPool pool(num_threads);
+		std::cout << "work stealing, flat tasks:      " << measure([&]() { flatTasks(pool, flat); }) << " ms\n";
+		std::cout << "work stealing, tree of tasks:   " << measure([&]() { treeTasks(pool, depth); }) << " ms\n";
+	}
+
+	return 0;
+}
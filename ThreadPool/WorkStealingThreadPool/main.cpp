@@ -0,0 +1,99 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+#include "ThreadPool.h"
+
+// Every task splits itself in two, so most of the work is submitted from the workers.
+long long recursiveSum(ThreadPool &pool, long long first, long long last) {
+	if (last - first <= 1000) {
+		long long sum = 0;
+		for (long long i = first; i < last; ++i) {
+			sum += i;
+		}
+
+		return sum;
+	}
+
+	const long long middle = first + (last - first) / 2;
+	std::future<long long> left = pool.submit([&pool, first, middle]() { return recursiveSum(pool, first, middle); });
+	const long long right = recursiveSum(pool, middle, last);
+
+	// Do not block the worker, help with the pending tasks instead.
+	while (left.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		pool.run_pending_task();
+	}
+
+	return left.get() + right;
+}
+
+void testSubmit(size_t num_threads) {
+	ThreadPool pool(num_threads);
+	assert(pool.size() == num_threads);
+
+	std::vector<std::future<int>> results;
+	for (int i = 0; i < 1000; ++i) {
+		results.push_back(pool.submit([i]() { return i * i; }));
+	}
+
+	for (int i = 0; i < 1000; ++i) {
+		assert(results[i].get() == i * i);
+	}
+
+	// Exceptions reach the future.
+	std::future<void> failed = pool.submit([]() { throw std::runtime_error("task"); });
+
+	try {
+		failed.get();
+		assert(false);
+	}
+	catch (std::runtime_error &) {
+
+	}
+
+	const long long n = 1000000;
+	assert(recursiveSum(pool, 0, n) == n * (n - 1) / 2);
+}
+
+void testParallelFor(size_t num_threads) {
+	ThreadPool pool(num_threads);
+
+	std::vector<int> values(100000, 0);
+	pool.parallel_for(0, values.size(), [&values](size_t i) { values[i] = int(i) * 2; });
+
+	for (size_t i = 0; i < values.size(); ++i) {
+		assert(values[i] == int(i) * 2);
+	}
+
+	// Nested parallel_for() from inside a task must not deadlock.
+	std::atomic<int> counter(0);
+	pool.parallel_for(0, 16, [&pool, &counter](size_t) {
+		pool.parallel_for(0, 100, [&counter](size_t) { counter += 1; }, 10);
+	}, 1);
+
+	assert(counter == 1600);
+
+	try {
+		pool.parallel_for(0, 100, [](size_t i) {
+			if (i == 42) {
+				throw std::out_of_range("index");
+			}
+		});
+		assert(false);
+	}
+	catch (std::out_of_range &) {
+
+	}
+}
+
+int main() {
+	testSubmit(1);
+	testSubmit(4);
+
+	testParallelFor(1);
+	testParallelFor(8);
+
+	return 0;
+}